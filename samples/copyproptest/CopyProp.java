@@ -0,0 +1,18 @@
+public class CopyProp {
+    // b copies a, then a is assigned again on one path only and is dead after the join,
+    // so the join has no phi for a: the use of b must not be turned into a use of a
+    public static int TestMain( int x ) {
+        int a = x;
+        int b = a;
+        if( x == 0 ) {
+            a = 5;
+            System.out.println(a);
+        }
+        return b;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(TestMain(0));
+        System.out.println(TestMain(7));
+    }
+}
@@ -32,7 +32,7 @@ class DriverRunner final {
   DriverRunner(MIRModule *theModule, const std::vector<std::string> &exeNames, Options *mpl2mplOptions,
                std::string mpl2mplInput, MeOption *meOptions, const std::string &meInput, std::string actualInput,
                MemPool *optMp, bool timePhases = false,
-               bool genMeMpl = false)
+               bool genMeMpl = false, bool genBpl = false)
       : theModule(theModule),
         exeNames(exeNames),
         mpl2mplOptions(mpl2mplOptions),
@@ -42,7 +42,8 @@ class DriverRunner final {
         actualInput(actualInput),
         optMp(optMp),
         timePhases(timePhases),
-        genMeMpl(genMeMpl) {}
+        genMeMpl(genMeMpl),
+        genBpl(genBpl) {}
 
   DriverRunner(MIRModule *theModule, const std::vector<std::string> &exeNames, std::string actualInput, MemPool *optMp,
                bool timePhases = false, bool genVtableImpl = false, bool genMeMpl = false)
@@ -64,11 +65,13 @@ class DriverRunner final {
   MemPool *optMp;
   bool timePhases = false;
   bool genMeMpl = false;
+  bool genBpl = false;
   std::string printOutExe;
 
   static bool FuncOrderLessThan(const MIRFunction *left, const MIRFunction *right);
 
   bool IsFramework() const;
+  bool IsBinaryMplInput() const;
   bool VerifyModule(MIRModulePtr &mModule) const;
   ErrorCode ParseInput(const std::string &outputFile, const std::string &oriBasename) const;
   std::string GetPostfix() const;
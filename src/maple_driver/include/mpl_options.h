@@ -33,6 +33,7 @@ enum InputFileType {
   kClass,
   kJar,
   kMpl,
+  kBpl,
   kVtableImplMpl,
   kS,
 };
@@ -183,6 +184,10 @@ class MplOptions {
     return genVtableImpl;
   }
 
+  bool HasSetGenBpl() const {
+    return genBpl;
+  }
+
   bool HasSetVerify() const {
     return verify;
   }
@@ -210,6 +215,7 @@ class MplOptions {
   bool timePhases = false;
   bool genMeMpl = false;
   bool genVtableImpl = false;
+  bool genBpl = false;
   bool verify = false;
   bool Init(const std::string &inputFile);
   ErrorCode HandleGeneralOptions();
@@ -36,6 +36,7 @@ enum OptionIndex : uint64 {
   kCombTimePhases,
   kGenMeMpl,
   kGenVtableImpl,
+  kGenBpl,
   kVerify,
   //----------me begin-----------
   kMeHelp,
@@ -54,6 +55,9 @@ enum OptionIndex : uint64 {
   kLessThrowAlias,
   kFinalFieldAlias,
   kRegReadAtReturn,
+  kMeJobs,
+  kMeMemPoolHighWater,
+  kMeSemiNCAThreshold,
   //----------mpl2mpl begin---------
   kMpl2MplHelp,
   kMpl2MplDumpPhase,
@@ -64,6 +68,7 @@ enum OptionIndex : uint64 {
   kMpl2MplQuiet,
   kMpl2MplStubJniFunc,
   kMpl2MplSkipVirtual,
+  kMpl2MplClosedWorld,
   kRegNativeDynamicOnly,
   kRegNativeStaticBindingList,
   kNativeWrapper,
@@ -72,6 +77,7 @@ enum OptionIndex : uint64 {
   kMpl2MplMapleLinker,
   kMplnkDumpMuid,
   kEmitVtableImpl,
+  kMpl2MplJobs,
   //----------mplcg begin---------
   kCGQuiet,
   kPie,
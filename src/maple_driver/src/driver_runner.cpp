@@ -20,6 +20,7 @@
 #include "mpl_timer.h"
 #include "mir_function.h"
 #include "mir_parser.h"
+#include "bin_mplt.h"
 
 #define JAVALANG (theModule->IsJavaModule())
 
@@ -96,6 +97,11 @@ bool DriverRunner::IsFramework() const {
   return false;
 }
 
+bool DriverRunner::IsBinaryMplInput() const {
+  std::string::size_type lastdot = actualInput.find_last_of(".");
+  return lastdot != std::string::npos && actualInput.substr(lastdot) == ".bpl";
+}
+
 std::string DriverRunner::GetPostfix() const {
   if (printOutExe == mplME) {
     return ".me.mpl";
@@ -115,12 +121,24 @@ ErrorCode DriverRunner::ParseInput(const std::string &outputFile, const std::str
   MPLTimer timer;
   timer.Start();
 
-  MIRParser parser(*theModule);
   ErrorCode ret = ErrorCode::kErrorNoError;
-  bool parsed = parser.ParseMIR(0, 0, false, true);
-  if (!parsed) {
-    ret = ErrorCode::kErrorExit;
-    parser.EmitError(outputFile);
+  if (IsBinaryMplInput()) {
+    // the binary mpl holds the whole module, function bodies included
+    BinaryMplImport binMplt(*theModule);
+    binMplt.SetImported(false);
+    if (!binMplt.Import(actualInput, true)) {
+      ret = ErrorCode::kErrorExit;
+      LogInfo::MapleLogger(kLlErr) << "Cannot import binary mpl " << actualInput << '\n';
+    }
+  } else {
+    MIRParser parser(*theModule);
+    // when only a range of functions goes through me, the other bodies are never looked at
+    uint32 parserOpt = (meOptions != nullptr && mpl2mplOptions == nullptr && MeOption::useRange) ? kLazyFuncBody : 0;
+    bool parsed = parser.ParseMIR(0, parserOpt, false, true);
+    if (!parsed) {
+      ret = ErrorCode::kErrorExit;
+      parser.EmitError(outputFile);
+    }
   }
   timer.Stop();
   LogInfo::MapleLogger() << "Parse consumed " << timer.Elapsed() << "s" << '\n';
@@ -149,7 +167,13 @@ void DriverRunner::ProcessMpl2mplAndMePhases(const std::string &outputFile, cons
     InitPhases(mgr, phases);
     mgr.Run();
 
-    theModule->Emit(vtableImplFile);
+    if (genBpl) {
+      std::string bplFile = vtableImplFile.substr(0, vtableImplFile.find_last_of('.')) + ".bpl";
+      BinaryMplt binMplt(*theModule);
+      binMplt.Export(bplFile, true);
+    }
+    // this is the last use of the functions, each one is freed as soon as it is written
+    theModule->Emit(vtableImplFile, true);
 
     timer.Stop();
     LogInfo::MapleLogger() << "Mpl2mpl&mplme consumed " << timer.Elapsed() << "s" << '\n';
@@ -26,6 +26,8 @@ using namespace mapleOption;
 std::string MapleCombCompiler::GetInputFileName(const MplOptions &options) const {
   if (options.GetInputFileType() == InputFileType::kVtableImplMpl) {
     return options.GetOutputFolder() + options.GetOutputName() + ".VtableImpl.mpl";
+  } else if (options.GetInputFileType() == InputFileType::kBpl) {
+    return options.GetOutputFolder() + options.GetOutputName() + ".bpl";
   } else {
     return options.GetOutputFolder() + options.GetOutputName() + ".mpl";
   }
@@ -156,6 +158,15 @@ MeOption *MapleCombCompiler::MakeMeOptions(const MplOptions &options, maple::Mem
       case kRegReadAtReturn:
         meOption->regreadAtReturn = true;
         break;
+      case kMeJobs:
+        meOption->jobs = std::stoul(opt.Args(), nullptr);
+        break;
+      case kMeMemPoolHighWater:
+        meOption->memPoolHighWater = std::stoul(opt.Args(), nullptr);
+        break;
+      case kMeSemiNCAThreshold:
+        meOption->semiNCAThreshold = std::stoul(opt.Args(), nullptr);
+        break;
       default:
         WARN(kLncWarn, "input invalid key for me " + opt.OptionKey());
         break;
@@ -223,10 +234,16 @@ Options *MapleCombCompiler::MakeMpl2MplOptions(const MplOptions &options, maple:
       case kEmitVtableImpl:
         mpl2mplOption->emitVtableImpl = true;
         break;
+      case kMpl2MplJobs:
+        mpl2mplOption->jobs = std::stoul(opt.Args(), nullptr);
+        break;
 #if MIR_JAVA
       case kMpl2MplSkipVirtual:
         mpl2mplOption->skipVirtualMethod = true;
         break;
+      case kMpl2MplClosedWorld:
+        mpl2mplOption->closedWorld = true;
+        break;
 #endif
       default:
         WARN(kLncWarn, "input invalid key for mpl2mpl " + opt.OptionKey());
@@ -255,7 +272,7 @@ ErrorCode MapleCombCompiler::Compile(const MplOptions &options, MIRModulePtr &th
   PrintCommand(options);
   DriverRunner runner(theModule, options.GetRunningExes(), mpl2mplOptions.get(), fileName, meOptions.get(),
                       fileName, fileName, optMp,
-                      options.HasSetTimePhases(), options.HasSetGenMeMpl());
+                      options.HasSetTimePhases(), options.HasSetGenMeMpl(), options.HasSetGenBpl());
   ErrorCode nErr = runner.Run();
 
   memPoolCtrler.DeleteMemPool(optMp);
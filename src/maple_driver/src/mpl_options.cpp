@@ -211,6 +211,18 @@ const mapleOption::Descriptor USAGES[] = {
     "  --genVtableImpl             \tGenerate VtableImpl.mpl file\n",
     "all",
     { { nullptr } } },
+  { kGenBpl,
+    0,
+    nullptr,
+    "genbpl",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyNone,
+    "  --genbpl                    \tGenerate VtableImpl.bpl file, the binary mpl with function bodies\n",
+    "all",
+    { { nullptr } } },
   { kVerify,
     0,
     nullptr,
@@ -463,6 +475,47 @@ const mapleOption::Descriptor USAGES[] = {
     "  --regreadatreturn           \tAllow register promotion to promote the operand of return statements\n",
     "me",
     { { nullptr } } },
+  { kMeJobs,
+    0,
+    nullptr,
+    "jobs",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --jobs                      \tOptimize functions on NUM threads; output is identical to --jobs=1\n"
+    "                              \t--jobs=NUM\n",
+    "me",
+    { { nullptr } } },
+  { kMeMemPoolHighWater,
+    0,
+    nullptr,
+    "mempoolhighwater",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --mempoolhighwater          \tWith --jobs, return cached mempool memory to the system while the\n"
+    "                              \tprocess is larger than MB; 0 (default) keeps it\n"
+    "                              \t--mempoolhighwater=MB\n",
+    "me",
+    { { nullptr } } },
+  { kMeSemiNCAThreshold,
+    0,
+    nullptr,
+    "seminca-threshold",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --seminca-threshold         \tCompute (post)dominators with Semi-NCA instead of the iterative\n"
+    "                              \talgorithm for functions with at least NUM BBs (default 1000)\n"
+    "                              \t--seminca-threshold=NUM\n",
+    "me",
+    { { nullptr } } },
   // mpl2mpl
   { kMpl2MplHelp,
     0,
@@ -676,6 +729,19 @@ const mapleOption::Descriptor USAGES[] = {
     "  --emitVtableImpl            \tgenerate VtableImpl file\n",
     "mpl2mpl",
     { { nullptr } } },
+  { kMpl2MplJobs,
+    0,
+    nullptr,
+    "jobs",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --jobs                      \tRun function-local lowering phases on NUM threads\n"
+    "                              \t--jobs=NUM\n",
+    "mpl2mpl",
+    { { nullptr } } },
 #if MIR_JAVA
   { kMpl2MplSkipVirtual,
     0,
@@ -689,6 +755,19 @@ const mapleOption::Descriptor USAGES[] = {
     "  --skipvirtual\n",
     "mpl2mpl",
     { { nullptr } } },
+  { kMpl2MplClosedWorld,
+    0,
+    nullptr,
+    "closed-world",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyNone,
+    "  --closed-world              \tAssume no classes besides those of the module and its imports are loaded,\n"
+    "                              \tso that virtual calls with one target in the class hierarchy are made direct\n",
+    "mpl2mpl",
+    { { nullptr } } },
 #endif
   // mplcg
   { kPie,
@@ -904,6 +983,10 @@ ErrorCode MplOptions::HandleGeneralOptions() {
         genVtableImpl = true;
         printCommandStr += " --genVtableImpl";
         break;
+      case kGenBpl:
+        genBpl = true;
+        printCommandStr += " --genbpl";
+        break;
       case kVerify:
         verify = true;
         printCommandStr += " --verify";
@@ -983,6 +1066,8 @@ ErrorCode MplOptions::DecideRunningPhases() {
       UpdateRunningExe(kBinNameJbc2mpl);
       break;
     case InputFileType::kMpl:
+      /* fall-through */
+    case InputFileType::kBpl:
       break;
     case InputFileType::kVtableImplMpl:
       isNeedMapleComb = false;
@@ -1082,6 +1167,8 @@ bool MplOptions::Init(const std::string &inputFile) {
     } else {
       inputFileType = InputFileType::kVtableImplMpl;
     }
+  } else if (extensionName == "bpl") {
+    inputFileType = InputFileType::kBpl;
   } else if (extensionName == "s") {
     inputFileType = InputFileType::kS;
   } else {
@@ -71,6 +71,8 @@ class InterleavedManager {
   bool timePasses;
 
   void InitSupportPhaseManagers();
+  MapleVector<MIRFunction*> &GetCompilationList();
+  static bool IsInRange(unsigned long rangeNum);
 };
 }  // namespace maple
 #endif  // MAPLE_IPA_INCLUDE_INTERLEAVED_MANAGER_H
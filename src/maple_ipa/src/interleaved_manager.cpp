@@ -21,6 +21,7 @@
 #include "mir_function.h"
 #include "mir_module.h"
 #include "me_function.h"
+#include "me_func_opt.h"
 #include "me_option.h"
 #include "mempool.h"
 #include "phase_manager.h"
@@ -60,6 +61,22 @@ void InterleavedManager::AddPhases(const std::vector<std::string> &phases, bool
 }
 
 
+MapleVector<MIRFunction*> &InterleavedManager::GetCompilationList() {
+  if (mirModule.GetCompilationList().empty()) {
+    return mirModule.GetFunctionList();
+  }
+  if ((mirModule.GetCompilationList().size() != mirModule.GetFunctionList().size() &&
+       mirModule.GetCompilationList().size() != mirModule.GetFunctionList().size() - mirModule.GetOptFuncsSize())) {
+    ASSERT(false, "should be equal");
+  }
+  return mirModule.GetCompilationList();
+}
+
+// whether the function at position rangeNum of the compilation list is selected by --range
+bool InterleavedManager::IsInRange(unsigned long rangeNum) {
+  return !MeOption::useRange || (rangeNum >= MeOption::range[0] && rangeNum <= MeOption::range[1]);
+}
+
 void InterleavedManager::Run() {
   for (auto *pm : phaseManagers) {
     if (pm == nullptr) {
@@ -68,22 +85,15 @@ void InterleavedManager::Run() {
     if (dynamic_cast<MeFuncPhaseManager*>(pm)) {
       MeFuncPhaseManager *fpm = static_cast<MeFuncPhaseManager*>(pm);
       unsigned long rangeNum = 0;
-      MapleVector<MIRFunction*> *compList;
-      if (!mirModule.GetCompilationList().empty()) {
-        if ((mirModule.GetCompilationList().size() != mirModule.GetFunctionList().size() &&
-             mirModule.GetCompilationList().size() !=
-                 mirModule.GetFunctionList().size() - mirModule.GetOptFuncsSize())) {
-          ASSERT(false, "should be equal");
-        }
-        compList = &mirModule.GetCompilationList();
-      } else {
-        compList = &mirModule.GetFunctionList();
-      }
-      for (auto *func : *compList) {
-        if (MeOption::useRange && (rangeNum < MeOption::range[0] || rangeNum > MeOption::range[1])) {
+      bool parallel = MeOption::jobs > 1 && !fpm->IsIPA();
+      MeFuncOptScheduler scheduler(*fpm, mirModule, meInput);
+      for (auto *func : GetCompilationList()) {
+        if (!IsInRange(rangeNum)) {
           rangeNum++;
           continue;
         }
+        // bodies skipped by a lazy parse are only read for the functions in range
+        (void)mirModule.LoadFunctionBody(*func);
         if (func->GetBody() == nullptr) {
           rangeNum++;
           continue;
@@ -91,15 +101,32 @@ void InterleavedManager::Run() {
         if (fpm->GetPhaseSequence()->empty()) {
           continue;
         }
+        if (parallel) {
+          scheduler.AddFunction(*func, rangeNum);
+          rangeNum++;
+          continue;
+        }
         mirModule.SetCurFunction(func);
         // lower, create BB and build cfg
         fpm->Run(func, rangeNum, meInput);
         rangeNum++;
       }
+      if (parallel) {
+        scheduler.Run(MeOption::jobs);
+      }
       if (fpm->GetGenMeMpl()) {
         mirModule.Emit("comb.me.mpl");
       }
     } else {
+      // module phases may look into any function in range; the others look like declarations to them
+      // and are emitted as they were read
+      MapleVector<MIRFunction*> &funcs = MeOption::useRange ? GetCompilationList() : mirModule.GetFunctionList();
+      unsigned long rangeNum = 0;
+      for (auto *func : funcs) {
+        if (IsInRange(rangeNum++)) {
+          (void)mirModule.LoadFunctionBody(*func);
+        }
+      }
       pm->Run();
     }
   }
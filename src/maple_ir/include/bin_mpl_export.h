@@ -66,6 +66,13 @@ enum : uint8 {
   kBinEaCgObjNode = 40,
   kBinEaCgStart = 41,
   kBinEaStart = 42,
+  kBinNodeBlock = 43,
+  kBinReturnvals = 44,
+  kBinHeaderStart = 45,
+  kBinSymStart = 46,
+  kBinFunctionBodyStart = 47,
+  kBinKindConstAddrofLocal = 48,
+  kBinKindConstAddrofLabel = 49,
 };
 
 // this value is used to check wether a file is a binary mplt file
@@ -75,10 +82,15 @@ class BinaryMplExport {
   explicit BinaryMplExport(MIRModule &md);
   virtual ~BinaryMplExport() = default;
 
-  void Export(const std::string &fname);
+  // withFuncBody also writes the module header, the global symbols and the function bodies, so that the
+  // importer can rebuild the whole module instead of only its class hierarchy
+  void Export(const std::string &fname, bool withFuncBody = false);
   void WriteContentField(int fieldNum, uint64 &fieldStartP);
+  void WriteHeaderField(uint64 contentIdx);
   void WriteStrField(uint64 contentIdx);
   void WriteTypeField(uint64 contentIdx);
+  void WriteSymField(uint64 contentIdx);
+  void WriteFunctionBodyField(uint64 contentIdx);
   void Init();
   void OutputConst(MIRConst *c);
   void OutputConstBase(const MIRConst &c);
@@ -103,7 +115,21 @@ class BinaryMplExport {
   void OutputInterfaceTypeData(MIRInterfaceType &type);
   void OutputSymbol(const MIRSymbol *sym);
   void OutputFunction(PUIdx puIdx);
-  void OutWords(uint8 &typeTagged, int64 targetTag, uint16 size);
+  static bool IsInFunctionTable(const MIRFunction *func);
+  void OutputWords(const uint8 *words, uint32 size);
+  void OutputSrcPos(const SrcPosition &pos);
+  void OutputStIdx(const StIdx &stIdx);
+  void OutputLocalSymbol(const MIRSymbol *sym);
+  void OutputPregTab(const MIRFunction &func);
+  void OutputLocalSymTab(const MIRFunction &func);
+  void OutputLabelTab(const MIRFunction &func);
+  void OutputLocalTypeNameTab(const MIRFunction &func);
+  void OutputAliasMap(const MIRFunction &func);
+  void OutputFunctionBody(MIRFunction &func, bool inFuncList);
+  void OutputReturnValues(const CallReturnVector &retVec);
+  void OutputExpression(BaseNode *e);
+  void OutputStatement(StmtNode *s);
+  void OutputBlockNode(BlockNode *block);
   void Write(uint8 b);
   void WriteInt(int32 x);
   uint8 Read();
@@ -118,6 +144,10 @@ class BinaryMplExport {
     return mod;
   }
 
+  bool IsWithFuncBody() const {
+    return withFuncBody;
+  }
+
  private:
   MIRModule &mod;
   size_t bufI;
@@ -128,6 +158,7 @@ class BinaryMplExport {
   std::unordered_map<UStrIdx, int64, UStrIdxHash> uStrMark;
   std::unordered_map<const MIRSymbol*, int64> symMark;
   std::unordered_map<MIRType*, int64> typMark;
+  bool withFuncBody = false;
   static int typeMarkOffset;  // offset of mark (tag in binmplimport) resulting from duplicated function
   void ExpandFourBuffSize();
 };
@@ -32,6 +32,7 @@ class BinaryMplImport {
   }
 
   virtual ~BinaryMplImport() {
+    UnmapFile();
     for (MIRStructType *structPtr : tmpStruct) {
       delete structPtr;
     }
@@ -52,11 +53,11 @@ class BinaryMplImport {
   }
 
   bool IsBufEmpty() const {
-    return buf.empty();
+    return bufSize == 0;
   }
 
   size_t GetBufSize() const {
-    return buf.size();
+    return bufSize;
   }
 
   int32 GetContent(int64 key) const {
@@ -67,10 +68,17 @@ class BinaryMplImport {
     imported = importedVal;
   }
 
+  bool IsWithFuncBody() const {
+    return withFuncBody;
+  }
+
   bool Import(const std::string &modid, bool readSymbols = false, bool readSe = false);
   void ReadContentField();
+  void ReadHeaderField();
   void ReadStrField();
   void ReadTypeField();
+  void ReadSymField();
+  void ReadFunctionBodyField();
   void Jump2NextField();
   void Reset();
   MIRSymbol *GetOrCreateSymbol(TyIdx tyIdx, GStrIdx strIdx, MIRSymKind mclass, MIRStorageClass sclass,
@@ -107,6 +115,20 @@ class BinaryMplImport {
   void ImportInterfaceTypeData(MIRInterfaceType &type);
   PUIdx ImportFunction();
   MIRSymbol *InSymbol(MIRFunction *func);
+  uint8 *ImportWords(uint32 size);
+  void ImportSrcPos(SrcPosition &pos);
+  StIdx ImportStIdx();
+  void ImportLocalSymbol(MIRFunction &func);
+  void ImportPregTab(MIRFunction &func);
+  void ImportLocalSymTab(MIRFunction &func);
+  void ImportLabelTab(MIRFunction &func);
+  void ImportLocalTypeNameTab(MIRFunction &func);
+  void ImportAliasMap(MIRFunction &func);
+  void ImportFunctionBody();
+  void ImportReturnValues(CallReturnVector &retVec);
+  BaseNode *ImportExpression();
+  StmtNode *ImportStatement();
+  BlockNode *ImportBlockNode();
   void ReadFileAt(const std::string &modid, int32 offset);
   uint8 Read();
   int32 ReadInt();
@@ -117,9 +139,14 @@ class BinaryMplImport {
 
  private:
   uint64 bufI;
-  std::vector<uint8> buf;
+  // the imported file is mapped read-only and decoded in place; buf points into the mapping
+  const uint8 *buf = nullptr;
+  size_t bufSize = 0;
+  void *mapAddr = nullptr;
+  size_t mapSize = 0;
   std::map<int64, int32> content;
   bool imported;  // used only by irbuild to convert to ascii
+  bool withFuncBody = false;  // set when the file carries a header field; the import flags then come from the file
   MIRModule &mod;
   MIRBuilder mirBuilder;
   std::vector<GStrIdx> gStrTab;
@@ -136,6 +163,7 @@ class BinaryMplImport {
   std::string importFileName;
 
   void SkipTotalSize();
+  void UnmapFile();
   void ImportFieldsOfStructType(FieldVector &fields, uint32 methodSize);
 };
 }  // namespace maple
@@ -29,8 +29,8 @@ class BinaryMplt {
 
   virtual ~BinaryMplt() = default;
 
-  void Export(const std::string &suffix) {
-    binExport.Export(suffix);
+  void Export(const std::string &suffix, bool withFuncBody = false) {
+    binExport.Export(suffix, withFuncBody);
   }
 
   bool Import(const std::string &modID, bool readCG = false, bool readSE = false) {
@@ -14,9 +14,12 @@
  */
 #ifndef MAPLE_IR_INCLUDE_GLOBAL_TABLES_H
 #define MAPLE_IR_INCLUDE_GLOBAL_TABLES_H
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <shared_mutex>
 #include "mempool.h"
 #include "mempool_allocator.h"
 #include "types_def.h"
@@ -25,6 +28,7 @@
 #include "name_mangler.h"
 #include "mir_type.h"
 #include "mir_const.h"
+#include "stable_vector.h"
 
 namespace maple {
 using TyIdxFieldAttrPair = std::pair<TyIdx, FieldAttrs>;
@@ -55,6 +59,69 @@ class UStrIdxHash {
   }
 };
 
+// While functions are optimized on several threads the global tables run in concurrent mode:
+// insertions take sharded locks and lookups by index stay lock-free. The mode may only be
+// switched while no worker thread is running.
+class TableConcurrency {
+ public:
+  static bool IsEnabled() {
+    return enabled.load(std::memory_order_acquire);
+  }
+
+  static void SetEnabled(bool flag) {
+    enabled.store(flag, std::memory_order_release);
+  }
+
+ private:
+  static std::atomic<bool> enabled;
+};
+
+// Exclusive lock on a global table, a no-op outside concurrent mode.
+template <typename Mutex>
+class TableLockGuard {
+ public:
+  explicit TableLockGuard(Mutex &mtx) : mutex(TableConcurrency::IsEnabled() ? &mtx : nullptr) {
+    if (mutex != nullptr) {
+      mutex->lock();
+    }
+  }
+
+  TableLockGuard(const TableLockGuard&) = delete;
+  TableLockGuard &operator=(const TableLockGuard&) = delete;
+
+  ~TableLockGuard() {
+    if (mutex != nullptr) {
+      mutex->unlock();
+    }
+  }
+
+ private:
+  Mutex *mutex;
+};
+
+// Shared (reader) lock on a global table, a no-op outside concurrent mode.
+class TableSharedLockGuard {
+ public:
+  explicit TableSharedLockGuard(std::shared_timed_mutex &mtx)
+      : mutex(TableConcurrency::IsEnabled() ? &mtx : nullptr) {
+    if (mutex != nullptr) {
+      mutex->lock_shared();
+    }
+  }
+
+  TableSharedLockGuard(const TableSharedLockGuard&) = delete;
+  TableSharedLockGuard &operator=(const TableSharedLockGuard&) = delete;
+
+  ~TableSharedLockGuard() {
+    if (mutex != nullptr) {
+      mutex->unlock_shared();
+    }
+  }
+
+ private:
+  std::shared_timed_mutex *mutex;
+};
+
 class TypeTable {
  public:
   static MIRType *voidPtrType;
@@ -66,7 +133,7 @@ class TypeTable {
   MIRType *CreateMirType(uint32 primTypeIdx) const;
   void PutToHashTable(MIRType *mirType);
 
-  std::vector<MIRType*> &GetTypeTable() {
+  StableVector<MIRType*> &GetTypeTable() {
     return typeTable;
   }
 
@@ -297,12 +364,25 @@ class TypeTable {
     }
   };
 
-  std::unordered_set<MIRTypePtr, Hash, Equal> typeHashTable;
-  std::vector<MIRType*> typeTable;
+  // the type hash table is split by hash index so that concurrent lookups rarely contend
+  static constexpr size_t kHashShardNum = 16;
+  struct HashShard {
+    std::unordered_set<MIRTypePtr, Hash, Equal> typeHashTable;
+    std::shared_timed_mutex mutex;
+  };
+
+  HashShard &GetHashShard(const MIRType &type) {
+    return hashShards[type.GetHashIndex() % kHashShardNum];
+  }
+
+  HashShard hashShards[kHashShardNum];
+  StableVector<MIRType*> typeTable;
+  std::mutex appendMutex;  // serializes appends to typeTable
 
   // create an entry in typeTable for the type node
   MIRType *CreateType(MIRType &oldType) {
     MIRType *newType = oldType.CopyMIRTypeNode();
+    TableLockGuard<std::mutex> guard(appendMutex);
     newType->SetTypeIndex(TyIdx(typeTable.size()));
     typeTable.push_back(newType);
     return newType;
@@ -345,9 +425,8 @@ class StringTable {
   StringTable(const StringTable&) = delete;
 
   ~StringTable() {
-    stringTableMap.clear();
-    for (auto it : stringTable) {
-      delete it;
+    for (size_t i = 0; i < stringTable.size(); ++i) {
+      delete stringTable[i];
     }
   }
 
@@ -358,20 +437,31 @@ class StringTable {
   }
 
   U GetStrIdxFromName(const T &str) const {
-    auto it = stringTableMap.find(&str);
-    if (it == stringTableMap.end()) {
-      return U(0);
-    }
-    return it->second;
+    const Shard &shard = GetShard(str);
+    TableSharedLockGuard guard(shard.mutex);
+    return FindInShard(shard, str);
   }
 
   U GetOrCreateStrIdxFromName(const T &str) {
-    U strIdx = GetStrIdxFromName(str);
+    Shard &shard = GetShard(str);
+    if (TableConcurrency::IsEnabled()) {
+      // most names are already interned, try without blocking other readers first
+      TableSharedLockGuard guard(shard.mutex);
+      U strIdx = FindInShard(shard, str);
+      if (strIdx != 0) {
+        return strIdx;
+      }
+    }
+    TableLockGuard<std::shared_timed_mutex> guard(shard.mutex);
+    U strIdx = FindInShard(shard, str);
     if (strIdx == 0) {
-      strIdx.SetIdx(stringTable.size());
       T *newStr = new T(str);
-      stringTable.push_back(newStr);
-      stringTableMap[newStr] = strIdx;
+      {
+        TableLockGuard<std::mutex> appendGuard(appendMutex);
+        strIdx.SetIdx(stringTable.size());
+        stringTable.push_back(newStr);
+      }
+      shard.stringTableMap[newStr] = strIdx;
     }
     return strIdx;
   }
@@ -386,8 +476,31 @@ class StringTable {
   }
 
  private:
-  std::vector<const T*> stringTable;  // index is uint32
-  std::unordered_map<const T*, U, StrPtrHash, StrPtrEqual> stringTableMap;
+  static constexpr size_t kShardNum = 16;
+  struct Shard {
+    std::unordered_map<const T*, U, StrPtrHash, StrPtrEqual> stringTableMap;
+    mutable std::shared_timed_mutex mutex;
+  };
+
+  const Shard &GetShard(const T &str) const {
+    return shards[StrPtrHash()(&str) % kShardNum];
+  }
+
+  Shard &GetShard(const T &str) {
+    return shards[StrPtrHash()(&str) % kShardNum];
+  }
+
+  static U FindInShard(const Shard &shard, const T &str) {
+    auto it = shard.stringTableMap.find(&str);
+    if (it == shard.stringTableMap.end()) {
+      return U(0);
+    }
+    return it->second;
+  }
+
+  StableVector<const T*> stringTable;  // index is uint32
+  Shard shards[kShardNum];
+  std::mutex appendMutex;  // serializes appends to stringTable
 };
 
 class FPConstTable {
@@ -418,6 +531,7 @@ class FPConstTable {
   MIRDoubleConst *infDoubleConst = nullptr;
   MIRDoubleConst *minusInfDoubleConst = nullptr;
   MIRDoubleConst *minusZeroDoubleConst = nullptr;
+  std::mutex mutex;  // guards the const tables in concurrent mode
 };
 
 // STypeNameTable is only used to store class and interface types.
@@ -455,7 +569,7 @@ class FunctionTable {
 
   virtual ~FunctionTable() = default;
 
-  std::vector<MIRFunction*> &GetFuncTable() {
+  StableVector<MIRFunction*> &GetFuncTable() {
     return funcTable;
   }
 
@@ -464,8 +578,12 @@ class FunctionTable {
     return funcTable.at(pidx);
   }
 
+  // append func and give it its index as PUIdx
+  void AddFunction(MIRFunction &func);
+
  private:
-  std::vector<MIRFunction*> funcTable;  // index is PUIdx
+  StableVector<MIRFunction*> funcTable;  // index is PUIdx
+  std::mutex appendMutex;  // serializes appends to funcTable
 };
 
 class GSymbolTable {
@@ -496,10 +614,12 @@ class GSymbolTable {
   }
 
   void SetStrIdxStIdxMap(GStrIdx strIdx, StIdx stIdx) {
+    TableLockGuard<std::recursive_mutex> guard(mutex);
     strIdxToStIdxMap[strIdx] = stIdx;
   }
 
   StIdx GetStIdxFromStrIdx(GStrIdx idx) const {
+    TableLockGuard<std::recursive_mutex> guard(mutex);
     const auto it = strIdxToStIdxMap.find(idx);
     if (it == strIdxToStIdxMap.cend()) {
       return StIdx();
@@ -525,11 +645,17 @@ class GSymbolTable {
   bool RemoveFromStringSymbolMap(const MIRSymbol &st);
   void Dump(bool islocal, int32 indent = 0) const;
 
+  // held by callers that need a find-or-create of a global symbol to be atomic
+  std::recursive_mutex &GetMutex() const {
+    return mutex;
+  }
+
  private:
   MIRModule *module = nullptr;
   // hash table mapping string index to st index
   std::unordered_map<GStrIdx, StIdx, GStrIdxHash> strIdxToStIdxMap;
-  std::vector<MIRSymbol*> symbolTable;  // map symbol idx to symbol node
+  StableVector<MIRSymbol*> symbolTable;  // map symbol idx to symbol node
+  mutable std::recursive_mutex mutex;
 };
 
 class ConstPool {
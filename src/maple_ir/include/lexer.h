@@ -19,6 +19,7 @@
 #include "mempool_allocator.h"
 #include "stdio.h"
 #include <fstream>
+#include <cstring>
 #include "mir_module.h"
 
 namespace maple {
@@ -30,6 +31,7 @@ class MIRLexer {
   explicit MIRLexer(MIRModule &mod);
   ~MIRLexer() {
     airFile = nullptr;
+    UnmapFile();
     if (airFileInternal.is_open()) {
       airFileInternal.close();
     }
@@ -47,6 +49,19 @@ class MIRLexer {
     return lineNum;
   }
 
+  // file offset of the line being lexed, only kept for the file opened by PrepareForFile
+  uint64 GetLineOffset() const {
+    return lineOffset;
+  }
+
+  bool IsLexingPreparedFile() const {
+    return airFile == &airFileInternal;
+  }
+
+  bool SkipBlock();
+  void SeekToken(uint64 offset, uint32 column, uint32 lineNumber);
+  void CopyFileRange(uint64 beginOffset, uint64 endOffset, std::ostream &out);
+
   int GetCurIdx() const {
     return curIdx;
   }
@@ -79,14 +94,22 @@ class MIRLexer {
   MapleVector<std::string> seenComments;
   std::ifstream *airFile;
   std::ifstream airFileInternal;
-  std::string line;
+  // the file opened by PrepareForFile is mapped and lexed in place; airFileInternal is only opened when
+  // the file cannot be mapped
+  const char *mapAddr = nullptr;
+  size_t mapSize = 0;
+  // the line being lexed, without its line break: a piece of the mapping, or lineBuf for lines read
+  // through a stream or given as a string. It is never written to.
+  const char *line = "";
+  std::string lineBuf;
   size_t lineBufSize;  // the allocated size of line(buffer).
   uint32 currentLineSize;
   uint32 curIdx;
   uint32 lineNum;
+  uint64 lineOffset = 0;
+  uint64 nextLineOffset = 0;
   TokenKind kind;
   std::string name;  // store the name token without the % or $ prefix
-  MapleUnorderedMap<std::string, TokenKind> keywordMap;
 
   void RemoveReturnInline(std::string &line) {
     if (line.back() == '\n') {
@@ -98,6 +121,9 @@ class MIRLexer {
   }
 
   int ReadALine();  // read a line from MIR (text) file.
+  int ReadAMappedLine();
+  void MapFile(const std::string &filename);
+  void UnmapFile();
   void GenName();
   TokenKind GetConstVal();
   TokenKind GetSpecialFloatConst();
@@ -112,8 +138,14 @@ class MIRLexer {
   TokenKind GetTokenWithPrefixExclamation();
   TokenKind GetTokenWithPrefixQuotation();
   TokenKind GetTokenWithPrefixDoubleQuotation();
+  uint32 StringConstEnd(uint32 idx) const;
   TokenKind GetTokenSpecial();
 
+  // whether the line holds str at idx
+  bool LineHasAt(uint32 idx, const char *str, uint32 len) const {
+    return idx <= currentLineSize && currentLineSize - idx >= len && memcmp(line + idx, str, len) == 0;
+  }
+
   inline char GetCharAt(uint32 idx) const {
     return line[idx];
   }
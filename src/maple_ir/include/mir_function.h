@@ -15,6 +15,7 @@
 #ifndef MAPLE_IR_INCLUDE_MIR_FUNCTION_H
 #define MAPLE_IR_INCLUDE_MIR_FUNCTION_H
 #include <string>
+#include <memory>
 #include "mir_module.h"
 #include "mir_const.h"
 #include "mir_symbol.h"
@@ -32,6 +33,19 @@ struct MIRAliasVars {
   GStrIdx sigStrIdx;
 };
 
+// a function body skipped by a lazy parse (kLazyFuncBody), read back from the mpl file on first use
+struct MIRLazyBody {
+  uint64 lineOffset = 0;  // file offset of the line holding the opening brace
+  uint32 column = 0;      // index of the opening brace in that line
+  uint32 lineNum = 0;
+  uint64 endOffset = 0;   // file offset just past the closing brace
+  // the tables declared by the prototype, restored when the body is released
+  MIRSymbolTable *symTab = nullptr;
+  MIRPregTable *pregTab = nullptr;
+  MIRTypeNameTable *typeNameTab = nullptr;
+  MIRLabelTable *labelTab = nullptr;
+};
+
 class MeFunction;  // circular dependency exists, no other choice
 class EAConnectionGraph;  // circular dependency exists, no other choice
 class MIRFunction {
@@ -53,6 +67,7 @@ class MIRFunction {
 
   void SetBaseClassFuncNames(GStrIdx strIdx);
   void SetMemPool(MemPool *memPool) {
+    InitMemPools();
     SetCodeMemPool(memPool);
     codeMemPoolAllocator.SetMemPool(codeMemPool);
   }
@@ -362,14 +377,17 @@ class MIRFunction {
   void ResetGDBEnv();
 
   MemPool *GetCodeMempool() {
+    InitMemPools();
     return codeMemPool;
   }
 
   MapleAllocator &GetCodeMemPoolAllocator() {
+    InitMemPools();
     return codeMemPoolAllocator;
   }
 
   MapleAllocator &GetCodeMempoolAllocator() {
+    InitMemPools();
     return codeMemPoolAllocator;
   }
 
@@ -461,6 +479,7 @@ class MIRFunction {
   }
 
   MemPool *GetMemPool() {
+    InitMemPools();
     return dataMemPool;
   }
 
@@ -474,6 +493,21 @@ class MIRFunction {
     body = node;
   }
 
+  const MIRLazyBody *GetLazyBody() const {
+    return lazyBody;
+  }
+  void SetLazyBody(uint64 lineOffset, uint32 column, uint32 lineNum);
+  void SetLazyBodyEnd(uint64 endOffset) {
+    lazyBody->endOffset = endOffset;
+  }
+  // a lazily parsed function whose body has not been read yet
+  bool IsBodyUnparsed() const {
+    return lazyBody != nullptr && body == nullptr;
+  }
+  void ReleaseBody();
+  // free the body and the local tables once the function is not needed any more
+  void ReleaseMemory();
+
   SrcPosition &GetSrcPosition() {
     return srcPosition;
   }
@@ -691,18 +725,27 @@ class MIRFunction {
   }
 
   MemPool *GetDataMemPool() {
+    InitMemPools();
     return dataMemPool;
   }
 
   MemPool *GetCodeMemPool() {
+    InitMemPools();
     return codeMemPool;
   }
 
   void SetCodeMemPool(MemPool *currCodemp) {
+    InitMemPools();
     codeMemPool = currCodemp;
   }
 
+  MemPoolCtrler &GetMemPoolCtrler() {
+    InitMemPools();
+    return *memPoolCtrl;
+  }
+
   MapleAllocator &GetCodeMPAllocator() {
+    InitMemPools();
     return codeMemPoolAllocator;
   }
 
@@ -724,11 +767,12 @@ class MIRFunction {
   MIRTypeNameTable *typeNameTab = nullptr;
   MIRLabelTable *labelTab = nullptr;
   MIRPregTable *pregTab = nullptr;
-  MemPool *dataMemPool = memPoolCtrler.NewMemPool("func data mempool");
+  MemPool *dataMemPool = nullptr;
   MapleAllocator dataMPAllocator{dataMemPool};
-  MemPool *codeMemPool = memPoolCtrler.NewMemPool("func code mempool");
+  MemPool *codeMemPool = nullptr;
   MapleAllocator codeMemPoolAllocator{codeMemPool};
   BlockNode *body = nullptr;
+  MIRLazyBody *lazyBody = nullptr;
   SrcPosition srcPosition{};
   FuncAttrs funcAttrs{};
   uint32 flag = 0;
@@ -785,6 +829,17 @@ class MIRFunction {
   GStrIdx baseFuncWithTypeStrIdx{0};
   // funcname + types of args, no type of retv
   GStrIdx signatureStrIdx{0};
+  // the mempools of a function come from a controller of its own, so that different functions
+  // can be transformed on different threads; it is kept behind all the members above since the
+  // prebuilt libmplphase reads body by offset
+  std::unique_ptr<MemPoolCtrler> memPoolCtrl;
+
+  void InitMemPools() {
+    if (memPoolCtrl == nullptr) {
+      CreateMemPools();
+    }
+  }
+  void CreateMemPools();
 
   void DumpFlavorLoweredThanMmpl() const;
 };
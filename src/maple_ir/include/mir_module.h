@@ -32,6 +32,7 @@ namespace maple {
 class CallInfo;  // circular dependency exists, no other choice
 class MIRModule;  // circular dependency exists, no other choice
 class MIRBuilder;  // circular dependency exists, no other choice
+class MIRParser;  // circular dependency exists, no other choice
 using MIRModulePtr = MIRModule*;
 using MIRBuilderPtr = MIRBuilder*;
 
@@ -167,11 +168,18 @@ class MIRModule {
   void PushbackTypeDefOrder(GStrIdx gstrIdx) {
     typeDefOrder.push_back(gstrIdx);
   }
+  void ClearTypeDefOrder() {
+    typeDefOrder.clear();
+  }
 
   void AddClass(TyIdx t);
   void RemoveClass(TyIdx t);
 
   void SetCurFunction(MIRFunction *f) {
+    if (multiThreaded) {
+      threadCurFunction = f;
+      return;
+    }
     curFunction = f;
   }
 
@@ -183,12 +191,32 @@ class MIRModule {
     return symbolSet;
   }
 
+  MapleVector<StIdx> &GetSymbolDefOrder() {
+    return symbolDefOrder;
+  }
+
+  const MapleSet<TyIdx> &GetExternStructTypeSet() const {
+    return externStructTypeSet;
+  }
+
+  bool IsSomeSymbolNeedForDecl() const {
+    return someSymbolNeedForwDecl;
+  }
   void SetSomeSymbolNeedForDecl(bool s) {
     someSymbolNeedForwDecl = s;
   }
 
   MIRFunction *CurFunction(void) const {
-    return curFunction;
+    return multiThreaded ? threadCurFunction : curFunction;
+  }
+
+  bool IsMultiThreaded() const {
+    return multiThreaded;
+  }
+
+  // when functions are optimized by several threads at once, each thread keeps its own current function
+  void SetMultiThreaded(bool isMultiThreaded) {
+    multiThreaded = isMultiThreaded;
   }
 
   MemPool *CurFuncCodeMemPool(void) const;
@@ -212,7 +240,9 @@ class MIRModule {
   void DumpClassToFile(const std::string &path) const;
   void DumpFunctionList(bool skipBody = false) const;
   void DumpGlobalArraySymbol() const;
-  void Emit(const std::string &outfileName) const;
+  // writes through a large file buffer, formatting one function at a time; releaseFuncs frees every
+  // function right after it is written, for the last emit of a module
+  void Emit(const std::string &outfileName, bool releaseFuncs = false) const;
   uint32 GetAndIncFloatNum() {
     return floatNum++;
   }
@@ -310,6 +340,17 @@ class MIRModule {
     binMplt = binaryMplt;
   }
 
+  MIRParser *GetLazyBodyParser() const {
+    return lazyBodyParser;
+  }
+  void SetLazyBodyParser(MIRParser *parser) {
+    lazyBodyParser = parser;
+  }
+  // parse the body of func if it was skipped by a lazy parse; returns true if a body was loaded
+  bool LoadFunctionBody(MIRFunction &func) const;
+  // write the body of func that a lazy parse skipped and nothing has read since, as it is in the file
+  void DumpUnparsedFunctionBody(const MIRFunction &func) const;
+
   bool IsInIPA() const {
     return inIPA;
   }
@@ -362,6 +403,9 @@ class MIRModule {
     srcLang = sourceLanguage;
   }
 
+  uint16 GetID() const {
+    return id;
+  }
   void SetID(uint16 num) {
     id = num;
   }
@@ -394,6 +438,9 @@ class MIRModule {
     globalWordsRefCounted = counted;
   }
 
+  uint32 GetNumFuncs() const {
+    return numFuncs;
+  }
   void SetNumFuncs(uint32 numFunc) {
     numFuncs = numFunc;
   }
@@ -402,6 +449,9 @@ class MIRModule {
     return importFiles;
   }
 
+  const MapleVector<GStrIdx> &GetImportPaths() const {
+    return importPaths;
+  }
   void PushbackImportPath(GStrIdx path) {
     importPaths.push_back(path);
   }
@@ -470,6 +520,8 @@ class MIRModule {
   bool withProfileInfo = false;
   // for cg in mplt
   BinaryMplt *binMplt = nullptr;
+  // reads back the function bodies skipped by a lazy parse
+  MIRParser *lazyBodyParser = nullptr;
   bool inIPA = false;
   MIRInfoVector fileInfo;              // store info provided under fileInfo keyword
   MapleVector<bool> fileInfoIsString;  // tells if an entry has string value
@@ -511,6 +563,8 @@ class MIRModule {
   // if puIdx appears in the map, and the value of first corresponding MapleSet is 0, the puIdx appears in this module
   // and writes to all field id otherwise, it writes the field ids in MapleSet
   MapleMap<PUIdx, MapleSet<FieldID>*> puIdxFieldInitializedMap;
+  bool multiThreaded = false;
+  static thread_local MIRFunction *threadCurFunction;
 };
 #endif  // MIR_FEATURE_FULL
 }  // namespace maple
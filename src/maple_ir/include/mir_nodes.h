@@ -1875,6 +1875,10 @@ class MultiwayNode : public StmtNode {
     multiWayOpnd = multiwayopndPara;
   }
 
+  LabelIdx GetDefaultLabel() const {
+    return defaultLabel;
+  }
+
   void SetDefaultlabel(LabelIdx defaultlabelPara) {
     defaultLabel = defaultlabelPara;
   }
@@ -3013,6 +3017,10 @@ class CallinstantNode : public CallNode {
     return &GetReturnVec();
   }
 
+  TyIdx GetInstVecTyIdx() const {
+    return instVecTyIdx;
+  }
+
  private:
   TyIdx instVecTyIdx;
 };
@@ -19,6 +19,7 @@
 #include "mir_nodes.h"
 #include "mir_preg.h"
 #include "parser_opt.h"
+#include <array>
 
 namespace maple {
 using BaseNodePtr = BaseNode*;
@@ -107,6 +108,9 @@ class MIRParser {
   bool ParseStmtBlock(BlockNodePtr &blk);
   bool ParsePrototype(MIRFunction &fn, MIRSymbol &funcSt, TyIdx &funcTyIdx);
   bool ParseFunction(uint32 fileIdx = 0);
+  bool ParseFuncBody(MIRFunction &func);
+  bool ParseLazyFuncBody(MIRFunction &func);
+  void CopyLazyFuncBody(const MIRFunction &func, std::ostream &out);
   bool ParseStorageClass(MIRSymbol &st) const;
   bool ParseDeclareVar(MIRSymbol&);
   bool ParseDeclareReg(MIRSymbol&, MIRFunction&);
@@ -217,10 +221,14 @@ class MIRParser {
   }
 
  private:
+  // handlers indexed by TokenKind, nullptr for the tokens a table does not handle
+  template <typename FuncPtr>
+  using TokenDispatchTable = std::array<FuncPtr, kTkEof + 1>;
+
   // func ptr map for ParseMIR()
   using FuncPtrParseMIRForElem = bool (MIRParser::*)();
-  static std::map<TokenKind, FuncPtrParseMIRForElem> funcPtrMapForParseMIR;
-  static std::map<TokenKind, FuncPtrParseMIRForElem> InitFuncPtrMapForParseMIR();
+  static TokenDispatchTable<FuncPtrParseMIRForElem> funcPtrMapForParseMIR;
+  static TokenDispatchTable<FuncPtrParseMIRForElem> InitFuncPtrMapForParseMIR();
 
   // func for ParseMIR
   bool ParseMIRForFunc();
@@ -244,21 +252,21 @@ class MIRParser {
 
   // func for ParseExpr
   using FuncPtrParseExpr = bool (MIRParser::*)(BaseNodePtr &ptr);
-  static std::map<TokenKind, FuncPtrParseExpr> funcPtrMapForParseExpr;
-  static std::map<TokenKind, FuncPtrParseExpr> InitFuncPtrMapForParseExpr();
+  static TokenDispatchTable<FuncPtrParseExpr> funcPtrMapForParseExpr;
+  static TokenDispatchTable<FuncPtrParseExpr> InitFuncPtrMapForParseExpr();
 
   // func and param for ParseStmt
   Opcode paramOpForStmt;
   TokenKind paramTokenKindForStmt;
   using FuncPtrParseStmt = bool (MIRParser::*)(StmtNodePtr &stmt);
-  static std::map<TokenKind, FuncPtrParseStmt> funcPtrMapForParseStmt;
-  static std::map<TokenKind, FuncPtrParseStmt> InitFuncPtrMapForParseStmt();
+  static TokenDispatchTable<FuncPtrParseStmt> funcPtrMapForParseStmt;
+  static TokenDispatchTable<FuncPtrParseStmt> InitFuncPtrMapForParseStmt();
 
   // func and param for ParseStmtBlock
   MIRFunction *paramCurrFuncForParseStmtBlock;
   using FuncPtrParseStmtBlock = bool (MIRParser::*)();
-  static std::map<TokenKind, FuncPtrParseStmtBlock> funcPtrMapForParseStmtBlock;
-  static std::map<TokenKind, FuncPtrParseStmtBlock> InitFuncPtrMapForParseStmtBlock();
+  static TokenDispatchTable<FuncPtrParseStmtBlock> funcPtrMapForParseStmtBlock;
+  static TokenDispatchTable<FuncPtrParseStmtBlock> InitFuncPtrMapForParseStmtBlock();
   void ParseStmtBlockForSeenComment(BlockNodePtr blk, uint32 mplNum);
   bool ParseStmtBlockForVar(TokenKind stmtTK);
   bool ParseStmtBlockForVar();
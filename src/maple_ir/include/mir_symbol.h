@@ -404,6 +404,11 @@ class MIRSymbolTable {
     return st;
   }
 
+  // keep a hole at the next index, used when reading back a table with deleted entries
+  void PushNullSymbol() {
+    symbolTable.push_back(nullptr);
+  }
+
   // add sym from other symbol table, happens in inline
   bool AddStOutside(MIRSymbol *sym) {
     if (sym == nullptr) {
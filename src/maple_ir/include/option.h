@@ -60,8 +60,10 @@ class Options {
   static bool mapleLinker;
   static bool dumpMuidFile;
   static bool emitVtableImpl;
+  static uint32 jobs;
 #if MIR_JAVA
   static bool skipVirtualMethod;
+  static bool closedWorld;
 #endif
  private:
   MapleAllocator optionAlloc;
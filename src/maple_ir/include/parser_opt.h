@@ -24,6 +24,7 @@ enum ParserOptions : uint8 {
   kKeepFirst = 0x2,    // ignore second type def, not emit error
   kWithProfileInfo = 0x4,
   kParseOptFunc = 0x08,    // parse optimized function mpl file
+  kLazyFuncBody = 0x10,    // skip function bodies, each one is parsed on first use
 };
 }  // namespace maple
 #endif  // MAPLE_IR_INCLUDE_PARSER_OPT_H
@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "bin_mpl_export.h"
+#include <unordered_set>
+#include "mir_function.h"
+#include "name_mangler.h"
+#include "opcode_info.h"
+
+// Function bodies of the binary format. Local symbols, pregs and labels keep the
+// indices they have in their function, so the nodes refer to them by index; global
+// symbols and functions go through OutputSymbol/OutputFunction like everywhere else.
+namespace maple {
+void BinaryMplExport::OutputSrcPos(const SrcPosition &pos) {
+  WriteNum(pos.RawData());
+  WriteNum(pos.LineNum());
+  WriteNum(pos.MplLineNum());
+}
+
+void BinaryMplExport::OutputStIdx(const StIdx &stIdx) {
+  WriteNum(stIdx.Scope());
+  if (stIdx.IsGlobal()) {
+    OutputSymbol(GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx()));
+  } else {
+    WriteNum(stIdx.Idx());
+  }
+}
+
+void BinaryMplExport::OutputLocalSymbol(const MIRSymbol *sym) {
+  if (sym == nullptr) {
+    WriteNum(0);
+    return;
+  }
+  WriteNum(kBinSymbol);
+  WriteNum(sym->GetScopeIdx());
+  OutputStr(sym->GetNameStrIdx());
+  WriteNum(sym->GetSKind());
+  WriteNum(sym->GetStorageClass());
+  OutputTypeAttrs(sym->GetAttrs());
+  WriteNum(sym->GetIsTmp() ? 1 : 0);
+  WriteNum(sym->IsDeleted() ? 1 : 0);
+  OutputType(sym->GetTyIdx());
+  if (sym->GetSKind() == kStPreg) {
+    WriteNum(sym->GetPreg() == nullptr ? 0 : sym->GetPreg()->GetPregNo());
+  } else if (sym->GetSKind() == kStVar || sym->GetSKind() == kStConst) {
+    OutputConst(sym->GetKonst());
+  }
+}
+
+void BinaryMplExport::OutputPregTab(const MIRFunction &func) {
+  const MIRPregTable *pregTab = func.GetPregTab();
+  WriteNum(pregTab->Size());
+  for (size_t i = 1; i < pregTab->Size(); ++i) {
+    const MIRPreg *preg = pregTab->PregFromPregIdx(i);
+    WriteNum(preg->GetPregNo());
+    WriteNum(preg->GetPrimType());
+    WriteNum(preg->IsRef() ? 1 : 0);
+    WriteNum(preg->NeedRC() ? 1 : 0);
+    OutputType(preg->GetMIRType() == nullptr ? TyIdx(0) : preg->GetMIRType()->GetTypeIndex());
+  }
+  WriteNum(pregTab->GetIndex());
+}
+
+void BinaryMplExport::OutputLocalSymTab(const MIRFunction &func) {
+  const MIRSymbolTable *symTab = func.GetSymTab();
+  WriteNum(symTab->GetSymbolTableSize());
+  for (size_t i = 1; i < symTab->GetSymbolTableSize(); ++i) {
+    const MIRSymbol *sym = symTab->GetSymbolFromStIdx(i);
+    OutputLocalSymbol(sym);
+    if (sym != nullptr) {
+      // symbols created by the optimizer may share a name; only one of them is found by name
+      WriteNum(symTab->GetStIdxFromStrIdx(sym->GetNameStrIdx()).Idx() == i ? 1 : 0);
+    }
+  }
+}
+
+void BinaryMplExport::OutputLabelTab(const MIRFunction &func) {
+  const MIRLabelTable *labelTab = func.GetLabelTab();
+  WriteNum(labelTab->Size());
+  for (size_t i = 1; i < labelTab->Size(); ++i) {
+    GStrIdx strIdx = labelTab->GetSymbolFromStIdx(i);
+    OutputStr(strIdx);
+    WriteNum((strIdx != 0 && labelTab->GetStIdxFromStrIdx(strIdx) == i) ? 1 : 0);
+  }
+}
+
+void BinaryMplExport::OutputLocalTypeNameTab(const MIRFunction &func) {
+  WriteNum(func.GetGStrIdxToTyIdxMap().size());
+  for (const auto &it : func.GetGStrIdxToTyIdxMap()) {
+    OutputStr(it.first);
+    OutputType(it.second);
+  }
+}
+
+void BinaryMplExport::OutputAliasMap(const MIRFunction &func) {
+  WriteNum(func.GetAliasVarMap().size());
+  for (const auto &it : func.GetAliasVarMap()) {
+    OutputStr(it.first);
+    OutputStr(it.second.memPoolStrIdx);
+    OutputType(it.second.tyIdx);
+    OutputStr(it.second.sigStrIdx);
+  }
+}
+
+void BinaryMplExport::OutputFunctionBody(MIRFunction &func, bool inFuncList) {
+  OutputFunction(func.GetPuidx());
+  WriteNum(inFuncList ? 1 : 0);
+  bool hasBody = func.GetBody() != nullptr;
+  WriteNum(hasBody ? 1 : 0);
+  WriteNum(func.GetPuidxOrigin());
+  WriteNum(func.GetFrameSize());
+  WriteNum(func.GetUpFormalSize());
+  WriteNum(func.GetModuleId());
+  WriteNum(func.GetFuncSize());
+  OutputWords(func.GetFormalWordsTypeTagged(), BlockSize2BitVectorSize(func.GetUpFormalSize()));
+  OutputWords(func.GetFormalWordsRefCounted(), BlockSize2BitVectorSize(func.GetUpFormalSize()));
+  OutputWords(func.GetLocalWordsTypeTagged(), BlockSize2BitVectorSize(func.GetFrameSize()));
+  OutputWords(func.GetLocalWordsRefCounted(), BlockSize2BitVectorSize(func.GetFrameSize()));
+  const MIRInfoVector &info = func.GetInfoVector();
+  WriteNum(info.size());
+  for (size_t i = 0; i < info.size(); ++i) {
+    OutputStr(info[i].first);
+    bool isString = func.InfoIsString()[i];
+    WriteNum(isString ? 1 : 0);
+    if (isString) {
+      OutputStr(GStrIdx(info[i].second));
+    } else {
+      WriteNum(info[i].second);
+    }
+  }
+  WriteNum(func.WithLocInfo() ? 1 : 0);
+  OutputSrcPos(func.GetSrcPosition());
+
+  OutputPregTab(func);
+  OutputLocalSymTab(func);
+  WriteNum(func.GetFormalCount());
+  for (size_t i = 0; i < func.GetFormalCount(); ++i) {
+    const MIRSymbol *formal = func.GetFormal(i);
+    CHECK_FATAL(formal != nullptr && func.GetSymTab()->GetSymbolFromStIdx(formal->GetStIndex()) == formal,
+                "formal of %s is not in its symbol table", func.GetName().c_str());
+    WriteNum(formal->GetStIndex());
+  }
+  if (!hasBody) {
+    return;
+  }
+  OutputLabelTab(func);
+  OutputLocalTypeNameTab(func);
+  OutputAliasMap(func);
+  MIRFunction *savedFunc = mod.CurFunction();
+  mod.SetCurFunction(&func);
+  OutputBlockNode(func.GetBody());
+  mod.SetCurFunction(savedFunc);
+}
+
+void BinaryMplExport::OutputReturnValues(const CallReturnVector &retVec) {
+  WriteNum(kBinReturnvals);
+  WriteNum(retVec.size());
+  for (const CallReturnPair &retPair : retVec) {
+    OutputStIdx(retPair.first);
+    WriteNum(retPair.second.GetFieldID());
+    WriteNum(retPair.second.GetPregIdx());
+  }
+}
+
+void BinaryMplExport::OutputExpression(BaseNode *e) {
+  WriteNum(e->GetOpCode());
+  WriteNum(e->GetPrimType());
+  switch (e->GetOpCode()) {
+    case OP_dread:
+    case OP_addrof: {
+      auto *addrofNode = static_cast<AddrofNode*>(e);
+      OutputStIdx(addrofNode->GetStIdx());
+      WriteNum(addrofNode->GetFieldID());
+      break;
+    }
+    case OP_regread:
+      WriteNum(static_cast<RegreadNode*>(e)->GetRegIdx());
+      break;
+    case OP_addroffunc:
+      OutputFunction(static_cast<AddroffuncNode*>(e)->GetPUIdx());
+      break;
+    case OP_addroflabel:
+      WriteNum(static_cast<AddroflabelNode*>(e)->GetOffset());
+      break;
+    case OP_constval:
+      OutputConst(static_cast<ConstvalNode*>(e)->GetConstVal());
+      break;
+    case OP_conststr:
+      OutputUsrStr(static_cast<ConststrNode*>(e)->GetStrIdx());
+      break;
+    case OP_conststr16: {
+      std::u16string str16 =
+          GlobalTables::GetU16StrTable().GetStringFromStrIdx(static_cast<Conststr16Node*>(e)->GetStrIdx());
+      std::string str;
+      NameMangler::UTF16ToUTF8(str, str16);
+      WriteAsciiStr(str);
+      break;
+    }
+    case OP_sizeoftype:
+      OutputType(static_cast<SizeoftypeNode*>(e)->GetTyIdx());
+      break;
+    case OP_fieldsdist: {
+      auto *distNode = static_cast<FieldsDistNode*>(e);
+      OutputType(distNode->GetTyIdx());
+      WriteNum(distNode->GetFiledID1());
+      WriteNum(distNode->GetFiledID2());
+      break;
+    }
+    case OP_iread:
+    case OP_iaddrof: {
+      auto *ireadNode = static_cast<IreadNode*>(e);
+      OutputType(ireadNode->GetTyIdx());
+      WriteNum(ireadNode->GetFieldID());
+      break;
+    }
+    case OP_ireadoff:
+      WriteNum(static_cast<IreadoffNode*>(e)->GetOffset());
+      break;
+    case OP_ireadfpoff:
+      WriteNum(static_cast<IreadFPoffNode*>(e)->GetOffset());
+      break;
+    case OP_ceil:
+    case OP_cvt:
+    case OP_floor:
+    case OP_round:
+    case OP_trunc:
+      WriteNum(static_cast<TypeCvtNode*>(e)->FromType());
+      break;
+    case OP_retype: {
+      auto *retypeNode = static_cast<RetypeNode*>(e);
+      WriteNum(retypeNode->FromType());
+      OutputType(retypeNode->GetTyIdx());
+      break;
+    }
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits: {
+      auto *extractNode = static_cast<ExtractbitsNode*>(e);
+      WriteNum(extractNode->GetBitsOffset());
+      WriteNum(extractNode->GetBitsSize());
+      break;
+    }
+    case OP_depositbits: {
+      auto *depositNode = static_cast<DepositbitsNode*>(e);
+      WriteNum(depositNode->GetBitsOffset());
+      WriteNum(depositNode->GetBitsSize());
+      break;
+    }
+    case OP_gcmalloc:
+    case OP_gcpermalloc:
+      OutputType(static_cast<GCMallocNode*>(e)->GetTyIdx());
+      break;
+    case OP_gcmallocjarray:
+    case OP_gcpermallocjarray:
+      OutputType(static_cast<JarrayMallocNode*>(e)->GetTyIdx());
+      break;
+    case OP_eq:
+    case OP_ge:
+    case OP_gt:
+    case OP_le:
+    case OP_lt:
+    case OP_ne:
+    case OP_cmp:
+    case OP_cmpl:
+    case OP_cmpg:
+      WriteNum(static_cast<CompareNode*>(e)->GetOpndType());
+      break;
+    case OP_resolveinterfacefunc:
+    case OP_resolvevirtualfunc:
+      OutputFunction(static_cast<ResolveFuncNode*>(e)->GetPuIdx());
+      break;
+    case OP_array: {
+      auto *arrayNode = static_cast<ArrayNode*>(e);
+      OutputType(arrayNode->GetTyIdx());
+      WriteNum(arrayNode->GetBoundsCheck() ? 1 : 0);
+      break;
+    }
+    case OP_intrinsicop:
+    case OP_intrinsicopwithtype: {
+      auto *intrinNode = static_cast<IntrinsicopNode*>(e);
+      WriteNum(intrinNode->GetIntrinsic());
+      OutputType(intrinNode->GetTyIdx());
+      break;
+    }
+    default:
+      // the remaining expressions carry nothing besides their operands
+      break;
+  }
+  WriteNum(e->NumOpnds());
+  for (size_t i = 0; i < e->NumOpnds(); ++i) {
+    OutputExpression(e->Opnd(i));
+  }
+}
+
+void BinaryMplExport::OutputStatement(StmtNode *s) {
+  Opcode op = s->GetOpCode();
+  WriteNum(op);
+  WriteNum(s->GetPrimType());
+  OutputSrcPos(s->GetSrcPos());
+  switch (op) {
+    case OP_block:
+      OutputBlockNode(static_cast<BlockNode*>(s));
+      return;
+    case OP_if: {
+      auto *ifNode = static_cast<IfStmtNode*>(s);
+      OutputExpression(ifNode->Opnd(0));
+      OutputBlockNode(ifNode->GetThenPart());
+      WriteNum(ifNode->GetElsePart() != nullptr ? 1 : 0);
+      if (ifNode->GetElsePart() != nullptr) {
+        OutputBlockNode(ifNode->GetElsePart());
+      }
+      return;
+    }
+    case OP_while:
+    case OP_dowhile: {
+      auto *whileNode = static_cast<WhileStmtNode*>(s);
+      OutputExpression(whileNode->Opnd(0));
+      OutputBlockNode(whileNode->GetBody());
+      return;
+    }
+    case OP_doloop: {
+      auto *doloopNode = static_cast<DoloopNode*>(s);
+      WriteNum(doloopNode->IsPreg() ? 1 : 0);
+      if (doloopNode->IsPreg()) {
+        // the loop variable is a preg index stored in the StIdx
+        WriteNum(doloopNode->GetDoVarStIdx().FullIdx());
+      } else {
+        OutputStIdx(doloopNode->GetDoVarStIdx());
+      }
+      OutputExpression(doloopNode->GetStartExpr());
+      OutputExpression(doloopNode->GetCondExpr());
+      OutputExpression(doloopNode->GetIncrExpr());
+      OutputBlockNode(doloopNode->GetDoBody());
+      return;
+    }
+    case OP_foreachelem: {
+      auto *foreachNode = static_cast<ForeachelemNode*>(s);
+      OutputStIdx(foreachNode->GetElemStIdx());
+      OutputStIdx(foreachNode->GetArrayStIdx());
+      OutputBlockNode(foreachNode->GetLoopBody());
+      return;
+    }
+    case OP_multiway: {
+      auto *multiwayNode = static_cast<MultiwayNode*>(s);
+      OutputExpression(multiwayNode->Opnd(0));
+      WriteNum(multiwayNode->GetDefaultLabel());
+      WriteNum(multiwayNode->GetMultiWayTable().size());
+      for (const MCasePair &casePair : multiwayNode->GetMultiWayTable()) {
+        OutputExpression(casePair.first);
+        WriteNum(casePair.second);
+      }
+      return;
+    }
+    case OP_dassign:
+    case OP_maydassign: {
+      auto *dassignNode = static_cast<DassignNode*>(s);
+      OutputStIdx(dassignNode->GetStIdx());
+      WriteNum(dassignNode->GetFieldID());
+      break;
+    }
+    case OP_iassign: {
+      auto *iassignNode = static_cast<IassignNode*>(s);
+      OutputType(iassignNode->GetTyIdx());
+      WriteNum(iassignNode->GetFieldID());
+      break;
+    }
+    case OP_iassignoff:
+      WriteNum(static_cast<IassignoffNode*>(s)->GetOffset());
+      break;
+    case OP_iassignfpoff:
+      WriteNum(static_cast<IassignFPoffNode*>(s)->GetOffset());
+      break;
+    case OP_regassign:
+      WriteNum(static_cast<RegassignNode*>(s)->GetRegIdx());
+      break;
+    case OP_label:
+      WriteNum(static_cast<LabelNode*>(s)->GetLabelIdx());
+      break;
+    case OP_goto:
+    case OP_gosub:
+      WriteNum(static_cast<GotoNode*>(s)->GetOffset());
+      break;
+    case OP_brtrue:
+    case OP_brfalse:
+      WriteNum(static_cast<CondGotoNode*>(s)->GetOffset());
+      break;
+    case OP_switch: {
+      auto *switchNode = static_cast<SwitchNode*>(s);
+      WriteNum(switchNode->GetDefaultLabel());
+      WriteNum(switchNode->GetSwitchTable().size());
+      for (const CasePair &casePair : switchNode->GetSwitchTable()) {
+        WriteNum(casePair.first);
+        WriteNum(casePair.second);
+      }
+      break;
+    }
+    case OP_rangegoto: {
+      auto *rangeGotoNode = static_cast<RangeGotoNode*>(s);
+      WriteNum(rangeGotoNode->GetTagOffset());
+      WriteNum(rangeGotoNode->GetRangeGotoTable().size());
+      for (const SmallCasePair &casePair : rangeGotoNode->GetRangeGotoTable()) {
+        WriteNum(casePair.first);
+        WriteNum(casePair.second);
+      }
+      break;
+    }
+    case OP_call:
+    case OP_virtualcall:
+    case OP_superclasscall:
+    case OP_interfacecall:
+    case OP_customcall:
+    case OP_polymorphiccall:
+    case OP_interfaceicall:
+    case OP_virtualicall:
+    case OP_callassigned:
+    case OP_virtualcallassigned:
+    case OP_superclasscallassigned:
+    case OP_interfacecallassigned:
+    case OP_customcallassigned:
+    case OP_polymorphiccallassigned:
+    case OP_interfaceicallassigned:
+    case OP_virtualicallassigned: {
+      auto *callNode = static_cast<CallNode*>(s);
+      OutputFunction(callNode->GetPUIdx());
+      OutputType(callNode->GetTyIdx());
+      break;
+    }
+    case OP_callinstant:
+    case OP_callinstantassigned:
+    case OP_virtualcallinstant:
+    case OP_virtualcallinstantassigned:
+    case OP_superclasscallinstant:
+    case OP_superclasscallinstantassigned:
+    case OP_interfacecallinstant:
+    case OP_interfacecallinstantassigned: {
+      auto *callInstantNode = static_cast<CallinstantNode*>(s);
+      OutputFunction(callInstantNode->GetPUIdx());
+      OutputType(callInstantNode->GetTyIdx());
+      OutputType(callInstantNode->GetInstVecTyIdx());
+      break;
+    }
+    case OP_icall:
+    case OP_icallassigned:
+      OutputType(static_cast<IcallNode*>(s)->GetRetTyIdx());
+      break;
+    case OP_intrinsiccall:
+    case OP_intrinsiccallwithtype:
+    case OP_xintrinsiccall:
+    case OP_intrinsiccallassigned:
+    case OP_intrinsiccallwithtypeassigned:
+    case OP_xintrinsiccallassigned: {
+      auto *intrinNode = static_cast<IntrinsiccallNode*>(s);
+      WriteNum(intrinNode->GetIntrinsic());
+      OutputType(intrinNode->GetTyIdx());
+      break;
+    }
+    case OP_jstry: {
+      auto *jsTryNode = static_cast<JsTryNode*>(s);
+      WriteNum(jsTryNode->GetCatchOffset());
+      WriteNum(jsTryNode->GetFinallyOffset());
+      break;
+    }
+    case OP_try: {
+      auto *tryNode = static_cast<TryNode*>(s);
+      WriteNum(tryNode->GetOffsetsCount());
+      for (size_t i = 0; i < tryNode->GetOffsetsCount(); ++i) {
+        WriteNum(tryNode->GetOffset(i));
+      }
+      break;
+    }
+    case OP_catch: {
+      auto *catchNode = static_cast<CatchNode*>(s);
+      WriteNum(catchNode->GetExceptionTyIdxVec().size());
+      for (TyIdx tyIdx : catchNode->GetExceptionTyIdxVec()) {
+        OutputType(tyIdx);
+      }
+      break;
+    }
+    case OP_comment:
+      WriteAsciiStr(static_cast<CommentNode*>(s)->GetComment().c_str());
+      break;
+    default:
+      // the remaining statements carry nothing besides their operands
+      break;
+  }
+  WriteNum(s->NumOpnds());
+  for (size_t i = 0; i < s->NumOpnds(); ++i) {
+    OutputExpression(s->Opnd(i));
+  }
+  if (kOpcodeInfo.IsCallAssigned(op)) {
+    OutputReturnValues(*s->GetCallReturnVector());
+  }
+}
+
+void BinaryMplExport::OutputBlockNode(BlockNode *block) {
+  WriteNum(kBinNodeBlock);
+  OutputSrcPos(block->GetSrcPos());
+  size_t numStmtsIdx = buf.size();
+  ExpandFourBuffSize();  // number of statements, fixed up below
+  int32 num = 0;
+  for (StmtNode &stmt : block->GetStmtNodes()) {
+    OutputStatement(&stmt);
+    ++num;
+  }
+  Fixup(numStmtsIdx, num);
+}
+
+void BinaryMplExport::WriteFunctionBodyField(uint64 contentIdx) {
+  Fixup(contentIdx, buf.size());
+  WriteNum(kBinFunctionBodyStart);
+  size_t totalSizeIdx = buf.size();
+  ExpandFourBuffSize();  // total size of this field to ~BIN_FUNCTIONBODY_START
+  size_t outFunctionBodySizeIdx = buf.size();
+  ExpandFourBuffSize();  // number of function bodies
+  int32 size = 0;
+  // functions of the module in their order, then the declarations only reachable from a symbol
+  std::unordered_set<const MIRFunction*> written;
+  for (MIRFunction *func : mod.GetFunctionList()) {
+    bool loaded = mod.LoadFunctionBody(*func);
+    OutputFunctionBody(*func, true);
+    if (loaded) {
+      func->ReleaseBody();
+    }
+    (void)written.insert(func);
+    ++size;
+  }
+  for (StIdx stIdx : mod.GetSymbolDefOrder()) {
+    MIRSymbol *sym = GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx());
+    if (sym == nullptr || sym->GetSKind() != kStFunc || !IsInFunctionTable(sym->GetFunction()) ||
+        written.find(sym->GetFunction()) != written.end()) {
+      continue;
+    }
+    OutputFunctionBody(*sym->GetFunction(), false);
+    (void)written.insert(sym->GetFunction());
+    ++size;
+  }
+  Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
+  Fixup(outFunctionBodySizeIdx, size);
+  WriteNum(~kBinFunctionBodyStart);
+}
+}  // namespace maple
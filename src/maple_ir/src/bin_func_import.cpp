@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "bin_mpl_import.h"
+#include <sstream>
+#include "bin_mpl_export.h"
+#include "mir_function.h"
+#include "name_mangler.h"
+#include "opcode_info.h"
+
+// Function bodies of the binary format, see bin_func_export.cpp for the layout.
+namespace maple {
+void BinaryMplImport::ImportSrcPos(SrcPosition &pos) {
+  pos.SetRawData(ReadNum());
+  pos.SetLineNum(ReadNum());
+  pos.SetMplLineNum(ReadNum());
+}
+
+StIdx BinaryMplImport::ImportStIdx() {
+  uint32 scope = ReadNum();
+  if (scope == kScopeGlobal) {
+    MIRSymbol *sym = InSymbol(nullptr);
+    CHECK_FATAL(sym != nullptr, "null ptr check");
+    return sym->GetStIdx();
+  }
+  return StIdx(scope, ReadNum());
+}
+
+void BinaryMplImport::ImportLocalSymbol(MIRFunction &func) {
+  int64 tag = ReadNum();
+  if (tag == 0) {
+    // keep the indices of the symbols that follow
+    func.GetSymTab()->PushNullSymbol();
+    return;
+  }
+  CHECK_FATAL(tag == kBinSymbol, "expecting kBinSymbol");
+  MIRSymbol *sym = func.GetSymTab()->CreateSymbol(ReadNum());
+  sym->SetNameStrIdx(ImportStr());
+  sym->SetSKind(static_cast<MIRSymKind>(ReadNum()));
+  sym->SetStorageClass(static_cast<MIRStorageClass>(ReadNum()));
+  sym->SetAttrs(ImportTypeAttrs());
+  sym->SetIsTmp(ReadNum() != 0);
+  if (ReadNum() != 0) {
+    sym->SetIsDeleted();
+  }
+  sym->SetTyIdx(ImportType());
+  if (sym->GetSKind() == kStPreg) {
+    int32 pregNo = ReadNum();
+    MIRPregTable *pregTab = func.GetPregTab();
+    PregIdx pregIdx = pregTab->GetPregIdxFromPregno(pregNo);
+    sym->SetPreg(pregIdx != 0 ? pregTab->PregFromPregIdx(pregIdx) : mod.GetMemPool()->New<MIRPreg>(pregNo));
+  } else if (sym->GetSKind() == kStVar || sym->GetSKind() == kStConst) {
+    sym->SetKonst(ImportConst(&func));
+  }
+  if (ReadNum() != 0) {
+    (void)func.GetSymTab()->AddToStringSymbolMap(*sym);
+  }
+}
+
+void BinaryMplImport::ImportPregTab(MIRFunction &func) {
+  MIRPregTable *pregTab = func.GetPregTab();
+  int64 size = ReadNum();
+  for (int64 i = 1; i < size; ++i) {
+    auto *preg = mod.GetMemPool()->New<MIRPreg>(static_cast<uint32>(ReadNum()));
+    preg->SetPrimType(static_cast<PrimType>(ReadNum()));
+    preg->SetIsRef(ReadNum() != 0);
+    preg->SetNeedRC(ReadNum() != 0);
+    TyIdx tyIdx = ImportType();
+    preg->SetMIRType(tyIdx == 0 ? nullptr : GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyIdx));
+    pregTab->AddPreg(preg);
+  }
+  pregTab->SetIndex(ReadNum());
+}
+
+void BinaryMplImport::ImportLocalSymTab(MIRFunction &func) {
+  int64 size = ReadNum();
+  for (int64 i = 1; i < size; ++i) {
+    ImportLocalSymbol(func);
+  }
+}
+
+void BinaryMplImport::ImportLabelTab(MIRFunction &func) {
+  MIRLabelTable *labelTab = func.GetLabelTab();
+  int64 size = ReadNum();
+  for (int64 i = 1; i < size; ++i) {
+    LabelIdx labelIdx = labelTab->CreateLabel();
+    labelTab->SetSymbolFromStIdx(labelIdx, ImportStr());
+    if (ReadNum() != 0) {
+      (void)labelTab->AddToStringLabelMap(labelIdx);
+    }
+  }
+}
+
+void BinaryMplImport::ImportLocalTypeNameTab(MIRFunction &func) {
+  int64 size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx strIdx = ImportStr();
+    func.SetGStrIdxToTyIdx(strIdx, ImportType());
+  }
+}
+
+void BinaryMplImport::ImportAliasMap(MIRFunction &func) {
+  int64 size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx strIdx = ImportStr();
+    MIRAliasVars aliasVars;
+    aliasVars.memPoolStrIdx = ImportStr();
+    aliasVars.tyIdx = ImportType();
+    aliasVars.sigStrIdx = ImportStr();
+    func.SetAliasVarMap(strIdx, aliasVars);
+  }
+}
+
+void BinaryMplImport::ImportFunctionBody() {
+  MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(ImportFunction());
+  CHECK_FATAL(func != nullptr, "null ptr check");
+  bool inFuncList = ReadNum() != 0;
+  bool hasBody = ReadNum() != 0;
+  MIRFunction *savedFunc = mod.CurFunction();
+  mod.SetCurFunction(func);
+  if (inFuncList) {
+    mod.AddFunction(func);
+  }
+  if (hasBody) {
+    func->NewBody();
+  }
+  func->SetPuidxOrigin(ReadNum());
+  func->SetFrameSize(ReadNum());
+  func->SetUpFormalSize(ReadNum());
+  func->SetModuleID(ReadNum());
+  func->SetFuncSize(ReadNum());
+  func->SetFormalWordsTypeTagged(ImportWords(BlockSize2BitVectorSize(func->GetUpFormalSize())));
+  func->SetFormalWordsRefCounted(ImportWords(BlockSize2BitVectorSize(func->GetUpFormalSize())));
+  func->SetLocalWordsTypeTagged(ImportWords(BlockSize2BitVectorSize(func->GetFrameSize())));
+  func->SetLocalWordsRefCounted(ImportWords(BlockSize2BitVectorSize(func->GetFrameSize())));
+  int64 size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx strIdx = ImportStr();
+    bool isString = ReadNum() != 0;
+    uint32 value = isString ? ImportStr().GetIdx() : static_cast<uint32>(ReadNum());
+    func->PushbackMIRInfo(MIRInfoPair(strIdx, value));
+    func->PushbackIsString(isString);
+  }
+  func->SetWithLocInfo(ReadNum() != 0);
+  ImportSrcPos(func->GetSrcPosition());
+
+  ImportPregTab(*func);
+  ImportLocalSymTab(*func);
+  func->ClearFormals();
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    func->AddFormal(func->GetSymTab()->GetSymbolFromStIdx(ReadNum()));
+  }
+  if (hasBody) {
+    ImportLabelTab(*func);
+    ImportLocalTypeNameTab(*func);
+    ImportAliasMap(*func);
+    func->SetBody(ImportBlockNode());
+  }
+  mod.SetCurFunction(savedFunc);
+}
+
+void BinaryMplImport::ImportReturnValues(CallReturnVector &retVec) {
+  CHECK_FATAL(ReadNum() == kBinReturnvals, "expecting return values");
+  int64 size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    StIdx stIdx = ImportStIdx();
+    FieldID fieldID = ReadNum();
+    PregIdx16 pregIdx = ReadNum();
+    retVec.push_back(CallReturnPair(stIdx, RegFieldPair(fieldID, pregIdx)));
+  }
+}
+
+BaseNode *BinaryMplImport::ImportExpression() {
+  auto op = static_cast<Opcode>(ReadNum());
+  auto primType = static_cast<PrimType>(ReadNum());
+  MemPool *memPool = mod.CurFuncCodeMemPool();
+  BaseNode *expr = nullptr;
+  bool isNary = false;
+  switch (op) {
+    case OP_dread:
+    case OP_addrof: {
+      StIdx stIdx = ImportStIdx();
+      expr = memPool->New<AddrofNode>(op, primType, stIdx, ReadNum());
+      break;
+    }
+    case OP_regread:
+      expr = memPool->New<RegreadNode>(ReadNum());
+      break;
+    case OP_addroffunc:
+      expr = memPool->New<AddroffuncNode>(primType, ImportFunction());
+      break;
+    case OP_addroflabel:
+      expr = memPool->New<AddroflabelNode>(ReadNum());
+      break;
+    case OP_constval:
+      expr = memPool->New<ConstvalNode>(ImportConst(mod.CurFunction()));
+      break;
+    case OP_conststr:
+      expr = memPool->New<ConststrNode>(ImportUsrStr());
+      break;
+    case OP_conststr16: {
+      std::string str;
+      ReadAsciiStr(str);
+      std::u16string str16;
+      NameMangler::UTF8ToUTF16(str16, str);
+      expr = memPool->New<Conststr16Node>(GlobalTables::GetU16StrTable().GetOrCreateStrIdxFromName(str16));
+      break;
+    }
+    case OP_sizeoftype:
+      expr = memPool->New<SizeoftypeNode>(ImportType());
+      break;
+    case OP_fieldsdist: {
+      TyIdx tyIdx = ImportType();
+      FieldID fieldID1 = ReadNum();
+      expr = memPool->New<FieldsDistNode>(tyIdx, fieldID1, ReadNum());
+      break;
+    }
+    case OP_iread:
+    case OP_iaddrof: {
+      TyIdx tyIdx = ImportType();
+      expr = memPool->New<IreadNode>(op, primType, tyIdx, ReadNum());
+      break;
+    }
+    case OP_ireadoff:
+      expr = memPool->New<IreadoffNode>(primType, ReadNum());
+      break;
+    case OP_ireadfpoff:
+      expr = memPool->New<IreadFPoffNode>(primType, ReadNum());
+      break;
+    case OP_ceil:
+    case OP_cvt:
+    case OP_floor:
+    case OP_round:
+    case OP_trunc: {
+      auto *cvtNode = memPool->New<TypeCvtNode>(op, primType);
+      cvtNode->SetFromType(static_cast<PrimType>(ReadNum()));
+      expr = cvtNode;
+      break;
+    }
+    case OP_retype: {
+      auto *retypeNode = memPool->New<RetypeNode>(primType);
+      retypeNode->SetFromType(static_cast<PrimType>(ReadNum()));
+      retypeNode->SetTyIdx(ImportType());
+      expr = retypeNode;
+      break;
+    }
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits: {
+      auto *extractNode = memPool->New<ExtractbitsNode>(op, primType);
+      extractNode->SetBitsOffset(ReadNum());
+      extractNode->SetBitsSize(ReadNum());
+      expr = extractNode;
+      break;
+    }
+    case OP_depositbits: {
+      auto *depositNode = memPool->New<DepositbitsNode>(op, primType);
+      depositNode->SetBitsOffset(ReadNum());
+      depositNode->SetBitsSize(ReadNum());
+      expr = depositNode;
+      break;
+    }
+    case OP_gcmalloc:
+    case OP_gcpermalloc: {
+      auto *mallocNode = memPool->New<GCMallocNode>(op, primType, ImportType());
+      mallocNode->SetOrigPType(primType);
+      expr = mallocNode;
+      break;
+    }
+    case OP_gcmallocjarray:
+    case OP_gcpermallocjarray:
+      expr = memPool->New<JarrayMallocNode>(op, primType, ImportType());
+      break;
+    case OP_eq:
+    case OP_ge:
+    case OP_gt:
+    case OP_le:
+    case OP_lt:
+    case OP_ne:
+    case OP_cmp:
+    case OP_cmpl:
+    case OP_cmpg: {
+      auto *compareNode = memPool->New<CompareNode>(op, primType);
+      compareNode->SetOpndType(static_cast<PrimType>(ReadNum()));
+      expr = compareNode;
+      break;
+    }
+    case OP_resolveinterfacefunc:
+    case OP_resolvevirtualfunc:
+      expr = memPool->New<ResolveFuncNode>(op, primType, ImportFunction());
+      break;
+    case OP_array: {
+      TyIdx tyIdx = ImportType();
+      expr = memPool->New<ArrayNode>(mod, primType, tyIdx, ReadNum() != 0);
+      isNary = true;
+      break;
+    }
+    case OP_intrinsicop:
+    case OP_intrinsicopwithtype: {
+      auto *intrinNode = memPool->New<IntrinsicopNode>(mod, op, primType);
+      intrinNode->SetIntrinsic(static_cast<MIRIntrinsicID>(ReadNum()));
+      intrinNode->SetTyIdx(ImportType());
+      expr = intrinNode;
+      isNary = true;
+      break;
+    }
+    case OP_abs:
+    case OP_bnot:
+    case OP_lnot:
+    case OP_neg:
+    case OP_recip:
+    case OP_sqrt:
+    case OP_alloca:
+    case OP_malloc:
+      expr = memPool->New<UnaryNode>(op, primType);
+      break;
+    case OP_add:
+    case OP_sub:
+    case OP_mul:
+    case OP_div:
+    case OP_rem:
+    case OP_ashr:
+    case OP_lshr:
+    case OP_shl:
+    case OP_max:
+    case OP_min:
+    case OP_band:
+    case OP_bior:
+    case OP_bxor:
+    case OP_CG_array_elem_add:
+    case OP_land:
+    case OP_lior:
+    case OP_cand:
+    case OP_cior:
+      expr = memPool->New<BinaryNode>(op, primType);
+      break;
+    case OP_select:
+      expr = memPool->New<TernaryNode>(op, primType);
+      break;
+    default:
+      CHECK_FATAL(false, "unexpected expression %s in a function body", kOpcodeInfo.GetName(op));
+  }
+  expr->SetPrimType(primType);
+  int64 numOpnds = ReadNum();
+  for (int64 i = 0; i < numOpnds; ++i) {
+    BaseNode *opnd = ImportExpression();
+    if (isNary) {
+      static_cast<NaryNode*>(expr)->GetNopnd().push_back(opnd);
+    } else {
+      expr->SetOpnd(opnd, i);
+    }
+  }
+  if (isNary) {
+    expr->SetNumOpnds(numOpnds);
+  }
+  return expr;
+}
+
+StmtNode *BinaryMplImport::ImportStatement() {
+  auto op = static_cast<Opcode>(ReadNum());
+  auto primType = static_cast<PrimType>(ReadNum());
+  SrcPosition srcPos;
+  ImportSrcPos(srcPos);
+  MemPool *memPool = mod.CurFuncCodeMemPool();
+  StmtNode *stmt = nullptr;
+  bool isNary = false;
+  switch (op) {
+    case OP_block:
+      stmt = ImportBlockNode();
+      stmt->SetSrcPos(srcPos);
+      return stmt;
+    case OP_if: {
+      auto *ifNode = memPool->New<IfStmtNode>();
+      ifNode->SetOpnd(ImportExpression(), 0);
+      ifNode->SetThenPart(ImportBlockNode());
+      if (ReadNum() != 0) {
+        ifNode->SetElsePart(ImportBlockNode());
+        ifNode->SetNumOpnds(kOperandNumTernary);
+      }
+      stmt = ifNode;
+      break;
+    }
+    case OP_while:
+    case OP_dowhile: {
+      auto *whileNode = memPool->New<WhileStmtNode>(op);
+      whileNode->SetOpnd(ImportExpression(), 0);
+      whileNode->SetBody(ImportBlockNode());
+      stmt = whileNode;
+      break;
+    }
+    case OP_doloop: {
+      auto *doloopNode = memPool->New<DoloopNode>();
+      bool isPreg = ReadNum() != 0;
+      doloopNode->SetIsPreg(isPreg);
+      if (isPreg) {
+        doloopNode->SetDoVarStFullIdx(ReadNum());
+      } else {
+        doloopNode->SetDoVarStIdx(ImportStIdx());
+      }
+      doloopNode->SetStartExpr(ImportExpression());
+      doloopNode->SetContExpr(ImportExpression());
+      doloopNode->SetIncrExpr(ImportExpression());
+      doloopNode->SetDoBody(ImportBlockNode());
+      stmt = doloopNode;
+      break;
+    }
+    case OP_foreachelem: {
+      auto *foreachNode = memPool->New<ForeachelemNode>();
+      foreachNode->SetElemStIdx(ImportStIdx());
+      foreachNode->SetArrayStIdx(ImportStIdx());
+      foreachNode->SetLoopBody(ImportBlockNode());
+      stmt = foreachNode;
+      break;
+    }
+    case OP_multiway: {
+      auto *multiwayNode = memPool->New<MultiwayNode>(mod);
+      multiwayNode->SetMultiWayOpnd(ImportExpression());
+      multiwayNode->SetDefaultlabel(ReadNum());
+      int64 size = ReadNum();
+      for (int64 i = 0; i < size; ++i) {
+        BaseNode *caseExpr = ImportExpression();
+        multiwayNode->AppendElemToMultiWayTable(MCasePair(caseExpr, ReadNum()));
+      }
+      stmt = multiwayNode;
+      break;
+    }
+    default:
+      break;
+  }
+  if (stmt != nullptr) {
+    // the statements above are read completely
+    stmt->SetPrimType(primType);
+    stmt->SetSrcPos(srcPos);
+    return stmt;
+  }
+  switch (op) {
+    case OP_dassign:
+    case OP_maydassign: {
+      auto *dassignNode = memPool->New<DassignNode>();
+      dassignNode->SetOpCode(op);
+      dassignNode->SetStIdx(ImportStIdx());
+      dassignNode->SetFieldID(ReadNum());
+      stmt = dassignNode;
+      break;
+    }
+    case OP_iassign: {
+      auto *iassignNode = memPool->New<IassignNode>();
+      iassignNode->SetTyIdx(ImportType());
+      iassignNode->SetFieldID(ReadNum());
+      stmt = iassignNode;
+      break;
+    }
+    case OP_iassignoff:
+      stmt = memPool->New<IassignoffNode>(ReadNum());
+      break;
+    case OP_iassignfpoff:
+      stmt = memPool->New<IassignFPoffNode>(ReadNum());
+      break;
+    case OP_regassign: {
+      auto *regassignNode = memPool->New<RegassignNode>();
+      regassignNode->SetRegIdx(ReadNum());
+      stmt = regassignNode;
+      break;
+    }
+    case OP_label: {
+      auto *labelNode = memPool->New<LabelNode>();
+      labelNode->SetLabelIdx(ReadNum());
+      stmt = labelNode;
+      break;
+    }
+    case OP_goto:
+    case OP_gosub:
+      stmt = memPool->New<GotoNode>(op, ReadNum());
+      break;
+    case OP_brtrue:
+    case OP_brfalse: {
+      auto *condGotoNode = memPool->New<CondGotoNode>(op);
+      condGotoNode->SetOffset(ReadNum());
+      stmt = condGotoNode;
+      break;
+    }
+    case OP_switch: {
+      auto *switchNode = memPool->New<SwitchNode>(mod);
+      switchNode->SetDefaultLabel(ReadNum());
+      int64 size = ReadNum();
+      for (int64 i = 0; i < size; ++i) {
+        int32 caseValue = ReadNum();
+        switchNode->InsertCasePair(CasePair(caseValue, ReadNum()));
+      }
+      stmt = switchNode;
+      break;
+    }
+    case OP_rangegoto: {
+      auto *rangeGotoNode = memPool->New<RangeGotoNode>(mod);
+      rangeGotoNode->SetTagOffset(ReadNum());
+      int64 size = ReadNum();
+      for (int64 i = 0; i < size; ++i) {
+        uint32 tag = ReadNum();
+        rangeGotoNode->AddRangeGoto(tag, ReadNum());
+      }
+      stmt = rangeGotoNode;
+      break;
+    }
+    case OP_call:
+    case OP_virtualcall:
+    case OP_superclasscall:
+    case OP_interfacecall:
+    case OP_customcall:
+    case OP_polymorphiccall:
+    case OP_interfaceicall:
+    case OP_virtualicall:
+    case OP_callassigned:
+    case OP_virtualcallassigned:
+    case OP_superclasscallassigned:
+    case OP_interfacecallassigned:
+    case OP_customcallassigned:
+    case OP_polymorphiccallassigned:
+    case OP_interfaceicallassigned:
+    case OP_virtualicallassigned: {
+      auto *callNode = memPool->New<CallNode>(mod, op);
+      callNode->SetPUIdx(ImportFunction());
+      callNode->SetTyIdx(ImportType());
+      stmt = callNode;
+      isNary = true;
+      break;
+    }
+    case OP_callinstant:
+    case OP_callinstantassigned:
+    case OP_virtualcallinstant:
+    case OP_virtualcallinstantassigned:
+    case OP_superclasscallinstant:
+    case OP_superclasscallinstantassigned:
+    case OP_interfacecallinstant:
+    case OP_interfacecallinstantassigned: {
+      PUIdx puIdx = ImportFunction();
+      TyIdx tyIdx = ImportType();
+      auto *callInstantNode = memPool->New<CallinstantNode>(mod, op, ImportType());
+      callInstantNode->SetPUIdx(puIdx);
+      callInstantNode->SetTyIdx(tyIdx);
+      stmt = callInstantNode;
+      isNary = true;
+      break;
+    }
+    case OP_icall:
+    case OP_icallassigned:
+      stmt = memPool->New<IcallNode>(mod, op, ImportType());
+      isNary = true;
+      break;
+    case OP_intrinsiccall:
+    case OP_intrinsiccallwithtype:
+    case OP_xintrinsiccall:
+    case OP_intrinsiccallassigned:
+    case OP_intrinsiccallwithtypeassigned:
+    case OP_xintrinsiccallassigned: {
+      auto *intrinNode = memPool->New<IntrinsiccallNode>(mod, op, static_cast<MIRIntrinsicID>(ReadNum()));
+      intrinNode->SetTyIdx(ImportType());
+      stmt = intrinNode;
+      isNary = true;
+      break;
+    }
+    case OP_return:
+    case OP_syncenter:
+    case OP_syncexit:
+      stmt = memPool->New<NaryStmtNode>(mod, op);
+      isNary = true;
+      break;
+    case OP_jstry: {
+      uint16 catchOffset = ReadNum();
+      stmt = memPool->New<JsTryNode>(catchOffset, ReadNum());
+      break;
+    }
+    case OP_try: {
+      auto *tryNode = memPool->New<TryNode>(mod);
+      int64 size = ReadNum();
+      for (int64 i = 0; i < size; ++i) {
+        tryNode->AddOffset(ReadNum());
+      }
+      stmt = tryNode;
+      break;
+    }
+    case OP_catch: {
+      auto *catchNode = memPool->New<CatchNode>(mod);
+      int64 size = ReadNum();
+      for (int64 i = 0; i < size; ++i) {
+        catchNode->PushBack(ImportType());
+      }
+      stmt = catchNode;
+      break;
+    }
+    case OP_comment: {
+      std::string comment;
+      ReadAsciiStr(comment);
+      stmt = memPool->New<CommentNode>(mod, comment);
+      break;
+    }
+    case OP_eval:
+    case OP_free:
+    case OP_assertnonnull:
+    case OP_throw:
+    case OP_decref:
+    case OP_incref:
+    case OP_decrefreset:
+      stmt = memPool->New<UnaryStmtNode>(op);
+      break;
+    case OP_assertge:
+    case OP_assertlt:
+      stmt = memPool->New<AssertStmtNode>(op);
+      break;
+    case OP_jscatch:
+    case OP_finally:
+    case OP_cleanuptry:
+    case OP_endtry:
+    case OP_retsub:
+    case OP_membaracquire:
+    case OP_membarrelease:
+    case OP_membarstoreload:
+    case OP_membarstorestore:
+      stmt = memPool->New<StmtNode>(op);
+      break;
+    default:
+      CHECK_FATAL(false, "unexpected statement %s in a function body", kOpcodeInfo.GetName(op));
+  }
+  stmt->SetPrimType(primType);
+  stmt->SetSrcPos(srcPos);
+  int64 numOpnds = ReadNum();
+  for (int64 i = 0; i < numOpnds; ++i) {
+    BaseNode *opnd = ImportExpression();
+    if (isNary) {
+      static_cast<NaryStmtNode*>(stmt)->GetNopnd().push_back(opnd);
+    } else {
+      stmt->SetOpnd(opnd, i);
+    }
+  }
+  if (isNary) {
+    stmt->SetNumOpnds(numOpnds);
+  }
+  if (kOpcodeInfo.IsCallAssigned(op)) {
+    ImportReturnValues(*stmt->GetCallReturnVector());
+  }
+  return stmt;
+}
+
+BlockNode *BinaryMplImport::ImportBlockNode() {
+  CHECK_FATAL(ReadNum() == kBinNodeBlock, "expecting a block");
+  auto *block = mod.CurFuncCodeMemPool()->New<BlockNode>();
+  ImportSrcPos(block->GetSrcPos());
+  int32 num = ReadInt();
+  for (int32 i = 0; i < num; ++i) {
+    block->AddStatement(ImportStatement());
+  }
+  return block;
+}
+
+void BinaryMplImport::ReadFunctionBodyField() {
+  SkipTotalSize();
+
+  int32 size = ReadInt();
+  for (int64 i = 0; i < size; ++i) {
+    ImportFunctionBody();
+  }
+  CHECK_FATAL(ReadNum() == ~kBinFunctionBodyStart, "pattern mismatch in Read FUNCTIONBODY");
+}
+}  // namespace maple
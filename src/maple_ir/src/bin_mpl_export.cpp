@@ -35,10 +35,18 @@ void OutputConstInt(const MIRConst &constVal, BinaryMplExport &mplExport) {
 }
 
 void OutputConstAddrof(const MIRConst &constVal, BinaryMplExport &mplExport) {
-  mplExport.WriteNum(kBinKindConstAddrof);
-  mplExport.OutputConstBase(constVal);
   const auto &addrof = static_cast<const MIRAddrofConst&>(constVal);
-  mplExport.OutputSymbol(mplExport.GetMIRModule().CurFunction()->GetLocalOrGlobalSymbol(addrof.GetSymbolIndex()));
+  const StIdx &stIdx = addrof.GetSymbolIndex();
+  if (stIdx.IsGlobal()) {
+    mplExport.WriteNum(kBinKindConstAddrof);
+    mplExport.OutputConstBase(constVal);
+    mplExport.OutputSymbol(GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx()));
+  } else {
+    // a local symbol keeps its index in the symbol table of the function being written
+    mplExport.WriteNum(kBinKindConstAddrofLocal);
+    mplExport.OutputConstBase(constVal);
+    mplExport.WriteNum(stIdx.FullIdx());
+  }
   mplExport.WriteNum(addrof.GetFieldID());
 }
 
@@ -50,7 +58,10 @@ void OutputConstAddrofFunc(const MIRConst &constVal, BinaryMplExport &mplExport)
 }
 
 void OutputConstLbl(const MIRConst &constVal, BinaryMplExport &mplExport) {
-  ASSERT(false, "NYI");
+  mplExport.WriteNum(kBinKindConstAddrofLabel);
+  mplExport.OutputConstBase(constVal);
+  const auto &lblConst = static_cast<const MIRLblConst&>(constVal);
+  mplExport.WriteNum(lblConst.GetValue());
 }
 
 void OutputConstStr(const MIRConst &constVal, BinaryMplExport &mplExport) {
@@ -75,12 +86,18 @@ void OutputConstStr16(const MIRConst &constVal, BinaryMplExport &mplExport) {
 
 void OutputConstFloat(const MIRConst &constVal, BinaryMplExport &mplExport) {
   mplExport.WriteNum(kBinKindConstFloat);
+  if (mplExport.IsWithFuncBody()) {
+    mplExport.OutputConstBase(constVal);
+  }
   const auto &fconst = static_cast<const MIRFloatConst&>(constVal);
   mplExport.WriteNum(fconst.GetIntValue());
 }
 
 void OutputConstDouble(const MIRConst &constVal, BinaryMplExport &mplExport) {
   mplExport.WriteNum(kBinKindConstDouble);
+  if (mplExport.IsWithFuncBody()) {
+    mplExport.OutputConstBase(constVal);
+  }
   const auto &dconst = static_cast<const MIRDoubleConst&>(constVal);
   mplExport.WriteNum(dconst.GetIntValue());
 }
@@ -221,7 +238,7 @@ void OutputTypeStruct(MIRType &ty, BinaryMplExport &mplExport) {
   mplExport.WriteNum(kBinKindTypeStruct);
   mplExport.OutputTypeBase(type);
   MIRTypeKind kind = ty.GetKind();
-  if (type.IsImported()) {
+  if (type.IsImported() && !mplExport.IsWithFuncBody()) {
     CHECK_FATAL(ty.GetKind() != kTypeUnion, "Must be.");
     kind = kTypeStructIncomplete;
   }
@@ -236,7 +253,7 @@ void OutputTypeClass(MIRType &ty, BinaryMplExport &mplExport) {
   mplExport.WriteNum(kBinKindTypeClass);
   mplExport.OutputTypeBase(type);
   MIRTypeKind kind = ty.GetKind();
-  if (type.IsImported()) {
+  if (type.IsImported() && !mplExport.IsWithFuncBody()) {
     kind = kTypeClassIncomplete;
   }
   mplExport.WriteNum(kind);
@@ -251,7 +268,7 @@ void OutputTypeInterface(MIRType &ty, BinaryMplExport &mplExport) {
   mplExport.WriteNum(kBinKindTypeInterface);
   mplExport.OutputTypeBase(type);
   MIRTypeKind kind = ty.GetKind();
-  if (type.IsImported()) {
+  if (type.IsImported() && !mplExport.IsWithFuncBody()) {
     kind = kTypeInterfaceIncomplete;
   }
   mplExport.WriteNum(kind);
@@ -484,10 +501,15 @@ void BinaryMplExport::OutputFieldPair(const FieldPair &fp) {
 }
 
 void BinaryMplExport::OutputMethodPair(const MethodPair &memPool) {
-  // use GStrIdx instead, StIdx will be created by ImportMethodPair
   MIRSymbol *funcSt = GlobalTables::GetGsymTable().GetSymbolFromStidx(memPool.first.Idx());
   CHECK_FATAL(funcSt != nullptr, "Pointer funcSt is nullptr, can't get symbol! Check it!");
-  WriteAsciiStr(GlobalTables::GetStrTable().GetStringFromStrIdx(funcSt->GetNameStrIdx()));
+  if (withFuncBody) {
+    // the method symbol is a module symbol like any other
+    OutputSymbol(funcSt);
+  } else {
+    // use GStrIdx instead, StIdx will be created by ImportMethodPair
+    WriteAsciiStr(GlobalTables::GetStrTable().GetStringFromStrIdx(funcSt->GetNameStrIdx()));
+  }
   OutputType(memPool.second.first);               // TyIdx
   WriteNum(memPool.second.second.GetAttrFlag());  // FuncAttrs
 }
@@ -511,6 +533,9 @@ void BinaryMplExport::OutputStructTypeData(MIRStructType &type) {
   OutputFieldsOfStruct(type.GetStaticFields());
   OutputFieldsOfStruct(type.GetParentFields());
   OutputMethodsOfStruct(type.GetMethods());
+  if (withFuncBody) {
+    WriteNum(type.IsImported());
+  }
 }
 
 void BinaryMplExport::OutputImplementedInterfaces(const std::vector<TyIdx> &interfaces) {
@@ -563,6 +588,7 @@ void BinaryMplExport::OutputInterfaceTypeData(MIRInterfaceType &type) {
 }
 
 void BinaryMplExport::Init() {
+  BinaryMplExport::typeMarkOffset = 0;
   gStrMark[GStrIdx(0)] = 0;
   uStrMark[UStrIdx(0)] = 0;
   symMark[nullptr] = 0;
@@ -584,7 +610,8 @@ void BinaryMplExport::OutputSymbol(const MIRSymbol *sym) {
     return;
   }
 
-  ASSERT(sym->GetSKind() == kStFunc, "Should not be used");
+  ASSERT(withFuncBody || sym->GetSKind() == kStFunc, "Should not be used");
+  CHECK_FATAL(sym->IsGlobal(), "local symbols are written with their function");
   WriteNum(kBinSymbol);
   WriteNum(sym->GetScopeIdx());
   OutputStr(sym->GetNameStrIdx());
@@ -594,8 +621,28 @@ void BinaryMplExport::OutputSymbol(const MIRSymbol *sym) {
   symMark[sym] = mark;
   OutputTypeAttrs(sym->GetAttrs());
   WriteNum(sym->GetIsTmp() ? 1 : 0);
-  OutputFunction(sym->GetFunction()->GetPuidx());
+  if (withFuncBody) {
+    WriteNum(sym->GetIsImported() ? 1 : 0);
+    WriteNum(sym->IsDeleted() ? 1 : 0);
+    WriteNum(sym->IsNeedForwDecl() ? 1 : 0);
+  }
+  if (sym->GetSKind() == kStFunc) {
+    OutputFunction(IsInFunctionTable(sym->GetFunction()) ? sym->GetFunction()->GetPuidx() : 0);
+    OutputType(sym->GetTyIdx());
+    return;
+  }
   OutputType(sym->GetTyIdx());
+  if (sym->GetSKind() == kStVar || sym->GetSKind() == kStConst) {
+    OutputConst(sym->GetKonst());
+  }
+}
+
+// the parser's dummy function holds a puIdx without being registered under it
+bool BinaryMplExport::IsInFunctionTable(const MIRFunction *func) {
+  if (func == nullptr || func->GetPuidx() >= GlobalTables::GetFunctionTable().GetFuncTable().size()) {
+    return false;
+  }
+  return GlobalTables::GetFunctionTable().GetFunctionFromPuidx(func->GetPuidx()) == func;
 }
 
 void BinaryMplExport::OutputFunction(PUIdx puIdx) {
@@ -605,6 +652,11 @@ void BinaryMplExport::OutputFunction(PUIdx puIdx) {
   }
   MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(puIdx);
   ASSERT(func != nullptr, "Cannot get MIRFunction.");
+  auto it = funcMark.find(func);
+  if (it != funcMark.end()) {
+    WriteNum(-(it->second));
+    return;
+  }
   size_t mark = funcMark.size();
   funcMark[func] = mark;
   MIRFunction *savedFunc = mod.CurFunction();
@@ -621,6 +673,77 @@ void BinaryMplExport::OutputFunction(PUIdx puIdx) {
   mod.SetCurFunction(savedFunc);
 }
 
+void BinaryMplExport::OutputWords(const uint8 *words, uint32 size) {
+  if (words == nullptr) {
+    WriteNum(0);
+    return;
+  }
+  WriteNum(1);
+  for (uint32 i = 0; i < size; ++i) {
+    Write(words[i]);
+  }
+}
+
+void BinaryMplExport::WriteHeaderField(uint64 contentIdx) {
+  Fixup(contentIdx, buf.size());
+  WriteNum(kBinHeaderStart);
+  size_t totalSizeIdx = buf.size();
+  ExpandFourBuffSize();  // total size of this field to ~BIN_HEADER_START
+
+  WriteNum(mod.GetFlavor());
+  WriteNum(mod.GetSrcLang());
+  WriteNum(mod.GetID());
+  WriteNum(mod.GetNumFuncs());
+  WriteNum(mod.GetGlobalMemSize());
+  OutputWords(mod.GetGlobalBlockMap(), mod.GetGlobalMemSize());
+  OutputWords(mod.GetGlobalWordsTypeTagged(), BlockSize2BitVectorSize(mod.GetGlobalMemSize()));
+  OutputWords(mod.GetGlobalWordsRefCounted(), BlockSize2BitVectorSize(mod.GetGlobalMemSize()));
+  WriteAsciiStr(mod.GetEntryFuncName());
+  WriteNum(mod.GetWithProfileInfo());
+  WriteNum(mod.IsSomeSymbolNeedForDecl());
+
+  WriteNum(mod.GetImportFiles().size());
+  for (GStrIdx strIdx : mod.GetImportFiles()) {
+    OutputStr(strIdx);
+  }
+  WriteNum(mod.GetImportPaths().size());
+  for (GStrIdx strIdx : mod.GetImportPaths()) {
+    OutputStr(strIdx);
+  }
+  WriteNum(mod.GetImportedMplt().size());
+  for (const std::string &mpltName : mod.GetImportedMplt()) {
+    WriteAsciiStr(mpltName);
+  }
+
+  const MIRInfoVector &fileInfo = mod.GetFileInfo();
+  WriteNum(fileInfo.size());
+  for (size_t i = 0; i < fileInfo.size(); ++i) {
+    OutputStr(fileInfo[i].first);
+    bool isString = mod.GetFileInfoIsString()[i];
+    WriteNum(isString);
+    if (isString) {
+      OutputStr(GStrIdx(fileInfo[i].second));
+    } else {
+      WriteNum(fileInfo[i].second);
+    }
+  }
+  WriteNum(mod.GetSrcFileInfo().size());
+  for (const MIRInfoPair &infoPair : mod.GetSrcFileInfo()) {
+    OutputStr(infoPair.first);
+    WriteNum(infoPair.second);
+  }
+  WriteNum(mod.GetFileData().size());
+  for (const MIRDataPair &dataPair : mod.GetFileData()) {
+    OutputStr(dataPair.first);
+    WriteNum(dataPair.second.size());
+    for (uint8 data : dataPair.second) {
+      Write(data);
+    }
+  }
+  Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
+  WriteNum(~kBinHeaderStart);
+}
+
 void BinaryMplExport::WriteStrField(uint64 contentIdx) {
   Fixup(contentIdx, buf.size());
   WriteNum(kBinStrStart);
@@ -650,6 +773,22 @@ void BinaryMplExport::WriteTypeField(uint64 contentIdx) {
   size_t outTypeSizeIdx = buf.size();
   ExpandFourBuffSize();  // size of OutputType
   int32 size = 0;
+  if (withFuncBody) {
+    // all the named types of the module, in the order they were defined
+    for (GStrIdx strIdx : mod.GetTypeDefOrder()) {
+      OutputStr(strIdx);
+      OutputType(mod.GetTypeNameTab()->GetTyIdxFromGStrIdx(strIdx));
+      ++size;
+    }
+    Fixup(outTypeSizeIdx, size);
+    WriteNum(mod.GetExternStructTypeSet().size());
+    for (TyIdx tyIdx : mod.GetExternStructTypeSet()) {
+      OutputType(tyIdx);
+    }
+    Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
+    WriteNum(~kBinTypeStart);
+    return;
+  }
   for (uint32 tyIdx : mod.GetClassList()) {
     TyIdx curTyidx(tyIdx);
     MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(curTyidx);
@@ -668,6 +807,22 @@ void BinaryMplExport::WriteTypeField(uint64 contentIdx) {
   WriteNum(~kBinTypeStart);
 }
 
+void BinaryMplExport::WriteSymField(uint64 contentIdx) {
+  Fixup(contentIdx, buf.size());
+  WriteNum(kBinSymStart);
+  size_t totalSizeIdx = buf.size();
+  ExpandFourBuffSize();  // total size of this field to ~BIN_SYM_START
+  size_t outSymSizeIdx = buf.size();
+  ExpandFourBuffSize();  // size of OutputSymbol
+  int32 size = 0;
+  for (StIdx stIdx : mod.GetSymbolDefOrder()) {
+    OutputSymbol(GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx()));
+    ++size;
+  }
+  Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
+  Fixup(outSymSizeIdx, size);
+  WriteNum(~kBinSymStart);
+}
 
 void BinaryMplExport::WriteContentField(int fieldNum, uint64 &fieldStartP) {
   WriteNum(kBinContentStart);
@@ -676,29 +831,64 @@ void BinaryMplExport::WriteContentField(int fieldNum, uint64 &fieldStartP) {
 
   WriteInt(fieldNum);  // size of Content item
 
-  WriteNum(kBinStrStart);
-  (&fieldStartP)[0] = buf.size();
-  ExpandFourBuffSize();
+  if (withFuncBody) {
+    WriteNum(kBinHeaderStart);
+    (&fieldStartP)[0] = buf.size();
+    ExpandFourBuffSize();
 
-  WriteNum(kBinTypeStart);
-  (&fieldStartP)[1] = buf.size();
-  ExpandFourBuffSize();
+    WriteNum(kBinStrStart);
+    (&fieldStartP)[1] = buf.size();
+    ExpandFourBuffSize();
+
+    WriteNum(kBinTypeStart);
+    (&fieldStartP)[2] = buf.size();
+    ExpandFourBuffSize();
 
-  WriteNum(kBinCgStart);
-  (&fieldStartP)[2] = buf.size();
-  ExpandFourBuffSize();
+    WriteNum(kBinSymStart);
+    (&fieldStartP)[3] = buf.size();
+    ExpandFourBuffSize();
+
+    WriteNum(kBinFunctionBodyStart);
+    (&fieldStartP)[4] = buf.size();
+    ExpandFourBuffSize();
+  } else {
+    WriteNum(kBinStrStart);
+    (&fieldStartP)[0] = buf.size();
+    ExpandFourBuffSize();
+
+    WriteNum(kBinTypeStart);
+    (&fieldStartP)[1] = buf.size();
+    ExpandFourBuffSize();
+
+    WriteNum(kBinCgStart);
+    (&fieldStartP)[2] = buf.size();
+    ExpandFourBuffSize();
+  }
 
   Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
   WriteNum(~kBinContentStart);
 }
 
-void BinaryMplExport::Export(const std::string &fname) {
-  constexpr int fieldNum = 3;
-  uint64 fieldStartPoint[fieldNum];
+void BinaryMplExport::Export(const std::string &fname, bool withBody) {
+  withFuncBody = withBody;
   WriteInt(kMpltMagicNumber);
-  WriteContentField(fieldNum, *fieldStartPoint);
-  WriteStrField(fieldStartPoint[0]);
-  WriteTypeField(fieldStartPoint[1]);
+  if (withFuncBody) {
+    constexpr int fieldNum = 5;
+    uint64 fieldStartPoint[fieldNum];
+    WriteContentField(fieldNum, *fieldStartPoint);
+    // the header goes first: it tells the importer how to read everything after it
+    WriteHeaderField(fieldStartPoint[0]);
+    WriteStrField(fieldStartPoint[1]);
+    WriteTypeField(fieldStartPoint[2]);
+    WriteSymField(fieldStartPoint[3]);
+    WriteFunctionBodyField(fieldStartPoint[4]);
+  } else {
+    constexpr int fieldNum = 3;
+    uint64 fieldStartPoint[fieldNum];
+    WriteContentField(fieldNum, *fieldStartPoint);
+    WriteStrField(fieldStartPoint[0]);
+    WriteTypeField(fieldStartPoint[1]);
+  }
   WriteNum(kBinFinish);
   importFileName = fname;
   DumpBuf(fname);
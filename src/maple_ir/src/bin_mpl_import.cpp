@@ -13,6 +13,11 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "bin_mpl_import.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
 #include <sstream>
 #include <vector>
 #include <unordered_set>
@@ -26,7 +31,7 @@
 
 namespace maple {
 uint8 BinaryMplImport::Read() {
-  CHECK_FATAL(bufI < buf.size(), "Index out of bound in BinaryMplImport::Read()");
+  CHECK_FATAL(bufI < bufSize, "Index out of bound in BinaryMplImport::Read()");
   return buf[bufI++];
 }
 
@@ -61,34 +66,47 @@ int64 BinaryMplImport::ReadNum() {
 }
 
 void BinaryMplImport::ReadAsciiStr(std::string &str) {
-  uint8 ch = Read();
-  std::ostringstream strStream(str);
-  while (ch != '\0') {
-    strStream << ch;
-    ch = Read();
-  }
-  str = strStream.str();
+  CHECK_FATAL(bufI < bufSize, "Index out of bound in BinaryMplImport::ReadAsciiStr()");
+  const uint8 *start = buf + bufI;
+  const void *end = memchr(start, '\0', bufSize - bufI);
+  CHECK_FATAL(end != nullptr, "unterminated string in BinaryMplImport::ReadAsciiStr()");
+  size_t len = static_cast<const uint8*>(end) - start;
+  str.assign(reinterpret_cast<const char*>(start), len);
+  bufI += len + 1;
 }
 
 void BinaryMplImport::ReadFileAt(const std::string &name, int32 offset) {
-  FILE *f = fopen(name.c_str(), "rb");
-  CHECK_FATAL(f != nullptr, "Error while reading the binary file: %s", name.c_str());
-
-  int seekRet = fseek(f, 0, SEEK_END);
-  CHECK_FATAL(seekRet == 0, "call fseek failed");
-
-  long size = ftell(f);
-  size -= offset;
+  UnmapFile();
+  int fd = open(name.c_str(), O_RDONLY);
+  CHECK_FATAL(fd >= 0, "Error while reading the binary file: %s", name.c_str());
 
-  CHECK_FATAL(size >= 0, "should not be negative");
+  struct stat fileStat;
+  int statRet = fstat(fd, &fileStat);
+  CHECK_FATAL(statRet == 0, "call fstat failed");
+  size_t size = static_cast<size_t>(fileStat.st_size);
+  CHECK_FATAL(offset >= 0 && static_cast<size_t>(offset) <= size, "offset out of range in the binary file");
 
-  seekRet = fseek(f, offset, SEEK_SET);
-  CHECK_FATAL(seekRet == 0, "call fseek failed");
-  buf.resize(size);
+  if (size != 0) {
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK_FATAL(addr != MAP_FAILED, "Error while mapping the binary file: %s", name.c_str());
+    // the file is decoded front to back
+    (void)madvise(addr, size, MADV_SEQUENTIAL);
+    mapAddr = addr;
+    mapSize = size;
+    buf = static_cast<const uint8*>(addr) + offset;
+    bufSize = size - offset;
+  }
+  close(fd);
+}
 
-  long result = fread(&buf[0], sizeof(uint8), size, f);
-  fclose(f);
-  CHECK_FATAL(result == size, "Error while reading the binary file: %s", name.c_str());
+void BinaryMplImport::UnmapFile() {
+  if (mapAddr != nullptr) {
+    (void)munmap(mapAddr, mapSize);
+  }
+  mapAddr = nullptr;
+  mapSize = 0;
+  buf = nullptr;
+  bufSize = 0;
 }
 
 void BinaryMplImport::ImportConstBase(MIRConstKind &kind, MIRTypePtr &type, uint32 &fieldID) {
@@ -117,7 +135,22 @@ MIRConst *BinaryMplImport::ImportConst(MIRFunction *func) {
     MIRSymbol *sym = InSymbol(func);
     CHECK_FATAL(sym != nullptr, "null ptr check");
     FieldID fi = ReadNum();
-    return memPool->New<MIRAddrofConst>(sym->GetStIdx(), fi, *type);
+    MIRAddrofConst *addrofConst = memPool->New<MIRAddrofConst>(sym->GetStIdx(), fi, *type);
+    addrofConst->SetFieldID(fieldID);
+    return addrofConst;
+  } else if (tag == kBinKindConstAddrofLocal) {
+    ImportConstBase(kind, type, fieldID);
+    StIdx stIdx;
+    stIdx.SetFullIdx(ReadNum());
+    FieldID fi = ReadNum();
+    MIRAddrofConst *addrofConst = memPool->New<MIRAddrofConst>(stIdx, fi, *type);
+    addrofConst->SetFieldID(fieldID);
+    return addrofConst;
+  } else if (tag == kBinKindConstAddrofLabel) {
+    ImportConstBase(kind, type, fieldID);
+    MIRLblConst *lblConst = memPool->New<MIRLblConst>(ReadNum(), *type);
+    lblConst->SetFieldID(fieldID);
+    return lblConst;
   } else if (tag == kBinKindConstAddrofFunc) {
     ImportConstBase(kind, type, fieldID);
     PUIdx puidx = ImportFunction();
@@ -139,23 +172,45 @@ MIRConst *BinaryMplImport::ImportConst(MIRFunction *func) {
     std::u16string str16;
     NameMangler::UTF8ToUTF16(str16, ostr.str());
     cs->SetStrIdx(GlobalTables::GetU16StrTable().GetOrCreateStrIdxFromName(str16));
-    return memPool->New<MIRStr16Const>(cs->GetStrIdx(), *type);
+    MIRStr16Const *str16Const = memPool->New<MIRStr16Const>(cs->GetStrIdx(), *type);
+    str16Const->SetFieldID(fieldID);
+    return str16Const;
   } else if (tag == kBinKindConstFloat) {
+    // mplt files carry no const base for floating point values
+    fieldID = 0;
+    if (withFuncBody) {
+      ImportConstBase(kind, type, fieldID);
+    }
     union {
       float fvalue;
       int32 ivalue;
     } value;
 
     value.ivalue = ReadNum();
-    return GlobalTables::GetFpConstTable().GetOrCreateFloatConst(value.fvalue);
+    if (fieldID == 0) {
+      return GlobalTables::GetFpConstTable().GetOrCreateFloatConst(value.fvalue);
+    }
+    // the shared constants of the fp table have no field id
+    MIRFloatConst *floatConst = memPool->New<MIRFloatConst>(value.fvalue, *type);
+    floatConst->SetFieldID(fieldID);
+    return floatConst;
   } else if (tag == kBinKindConstDouble) {
+    fieldID = 0;
+    if (withFuncBody) {
+      ImportConstBase(kind, type, fieldID);
+    }
     union {
       double dvalue;
       int64 ivalue;
     } value;
 
     value.ivalue = ReadNum();
-    return GlobalTables::GetFpConstTable().GetOrCreateDoubleConst(value.dvalue);
+    if (fieldID == 0) {
+      return GlobalTables::GetFpConstTable().GetOrCreateDoubleConst(value.dvalue);
+    }
+    MIRDoubleConst *doubleConst = memPool->New<MIRDoubleConst>(value.dvalue, *type);
+    doubleConst->SetFieldID(fieldID);
+    return doubleConst;
   } else if (tag == kBinKindConstAgg) {
     ImportConstBase(kind, type, fieldID);
     MIRAggConst *aggConst = mod.GetMemPool()->New<MIRAggConst>(mod, *type);
@@ -265,6 +320,16 @@ void BinaryMplImport::ImportFieldPair(FieldPair &fp) {
 }
 
 void BinaryMplImport::ImportMethodPair(MethodPair &memPool) {
+  if (withFuncBody) {
+    // the method symbol and its function come from the file like any other module symbol
+    MIRSymbol *funcSt = InSymbol(nullptr);
+    CHECK_FATAL(funcSt != nullptr, "null ptr check");
+    TyIdx funcTyIdx = ImportType();
+    memPool.first.SetFullIdx(funcSt->GetStIdx().FullIdx());
+    memPool.second.first.SetIdx(funcTyIdx.GetIdx());
+    memPool.second.second.SetAttrFlag(ReadNum());
+    return;
+  }
   std::string funcName;
   ReadAsciiStr(funcName);
   TyIdx funcTyidx = ImportType();
@@ -292,8 +357,7 @@ void BinaryMplImport::ImportMethodPair(MethodPair &memPool) {
 
     fn = mod.GetMemPool()->New<MIRFunction>(&mod, funcSt->GetStIdx());
     fn->Init();
-    fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
-    GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
+    GlobalTables::GetFunctionTable().AddFunction(*fn);
     funcSt->SetFunction(fn);
     MIRFuncType *funcType = static_cast<MIRFuncType*>(funcSt->GetType());
     fn->SetMIRFuncType(funcType);
@@ -346,7 +410,7 @@ void BinaryMplImport::ImportStructTypeData(MIRStructType &type) {
   ImportFieldsOfStructType(type.GetStaticFields(), methodSize);
   ImportFieldsOfStructType(type.GetParentFields(), methodSize);
   ImportMethodsOfStructType(type.GetMethods());
-  type.SetIsImported(imported);
+  type.SetIsImported(withFuncBody ? ReadNum() != 0 : imported);
 }
 
 void BinaryMplImport::ImportInterfacesOfClassType(std::vector<TyIdx> &interfaces) {
@@ -406,7 +470,9 @@ void BinaryMplImport::SetClassTyidxOfMethods(MIRStructType &type) {
       MIRSymbol *st = GlobalTables::GetGsymTable().GetSymbolFromStidx(stidx.Idx());
       CHECK_FATAL(st != nullptr, "st is null");
       CHECK_FATAL(st->GetSKind() == kStFunc, "unexpected st->sKind");
-      st->GetFunction()->SetClassTyIdx(type.GetTypeIndex());
+      if (st->GetFunction() != nullptr) {
+        st->GetFunction()->SetClassTyIdx(type.GetTypeIndex());
+      }
     }
   }
 }
@@ -433,7 +499,7 @@ void BinaryMplImport::ImportInterfaceTypeData(MIRInterfaceType &type) {
 }
 
 void BinaryMplImport::Reset() {
-  buf.clear();
+  UnmapFile();
   bufI = 0;
   gStrTab.clear();
   uStrTab.clear();
@@ -754,20 +820,42 @@ MIRSymbol *BinaryMplImport::InSymbol(MIRFunction *func) {
     MIRSymKind skind = static_cast<MIRSymKind>(ReadNum());
     MIRStorageClass sclass = static_cast<MIRStorageClass>(ReadNum());
     TyIdx tyTmp(0);
-    MIRSymbol *sym = GetOrCreateSymbol(tyTmp, stridx, skind, sclass, func, scope);
+    // a whole module is rebuilt from the file, so its symbols are never merged with existing ones by name
+    MIRSymbol *sym = withFuncBody ? mirBuilder.CreateSymbol(tyTmp, stridx, skind, sclass, func, scope)
+                                  : GetOrCreateSymbol(tyTmp, stridx, skind, sclass, func, scope);
     symTab.push_back(sym);
     sym->SetAttrs(ImportTypeAttrs());
     sym->SetIsTmp(ReadNum() != 0);
-    sym->SetIsImported(imported);
-    if (skind == kStPreg) {
-      CHECK_FATAL(false, "outing kStPreg");
-    } else if (skind == kStConst || skind == kStVar) {
-      CHECK_FATAL(false, "outing kStConst or kStVar");
-    } else if (skind == kStFunc) {
+    if (withFuncBody) {
+      sym->SetIsImported(ReadNum() != 0);
+      if (ReadNum() != 0) {
+        sym->SetIsDeleted();
+      }
+      if (ReadNum() != 0) {
+        sym->SetNeedForwDecl();
+      }
+    } else {
+      sym->SetIsImported(imported);
+    }
+    if (skind == kStFunc) {
       PUIdx puidx = ImportFunction();
       TyIdx tyidx = ImportType();
       sym->SetTyIdx(tyidx);
-      sym->SetFunction(GlobalTables::GetFunctionTable().GetFunctionFromPuidx(puidx));
+      if (puidx != 0) {
+        MIRFunction *mirFunc = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(puidx);
+        sym->SetFunction(mirFunc);
+        if (withFuncBody && tyidx != 0) {
+          auto *funcType = static_cast<MIRFuncType*>(GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyidx));
+          mirFunc->SetMIRFuncType(funcType);
+          mirFunc->SetReturnStruct(*GlobalTables::GetTypeTable().GetTypeFromTyIdx(funcType->GetRetTyIdx()));
+        }
+      }
+      return sym;
+    }
+    CHECK_FATAL(withFuncBody, "only function symbols are expected in a mplt");
+    sym->SetTyIdx(ImportType());
+    if (skind == kStConst || skind == kStVar) {
+      sym->SetKonst(ImportConst(func));
     }
     return sym;
   }
@@ -779,21 +867,27 @@ PUIdx BinaryMplImport::ImportFunction() {
     return 0;
   } else if (tag < 0) {
     CHECK_FATAL(static_cast<size_t>(-tag) < funcTab.size(), "index out of bounds");
-    return funcTab.at(-tag)->GetPuidx();
+    // a null entry is a function whose symbol is being read right now
+    return funcTab.at(-tag) == nullptr ? 0 : funcTab.at(-tag)->GetPuidx();
   }
   CHECK_FATAL(tag == kBinFunction, "expecting kBinFunction");
+  // reserve the mark first: the function symbol refers back to this function before it is created
+  size_t funcMark = funcTab.size();
+  funcTab.push_back(nullptr);
   MIRSymbol *funcSt = InSymbol(nullptr);
   CHECK_FATAL(funcSt != nullptr, "null ptr check");
   MIRFunction *func = nullptr;
   if (funcSt->GetFunction() == nullptr) {
     maple::MIRBuilder builder(&mod);
     func = builder.CreateFunction(funcSt->GetStIdx());
-    funcTab.push_back(func);
   } else {
     func = funcSt->GetFunction();
-    funcTab.push_back(func);
   }
+  funcTab[funcMark] = func;
   funcSt->SetFunction(func);
+  if (withFuncBody && funcSt->GetTyIdx() != 0) {
+    func->SetMIRFuncType(static_cast<MIRFuncType*>(funcSt->GetType()));
+  }
   if (mod.IsJavaModule()) {
     func->SetBaseClassFuncNames(funcSt->GetNameStrIdx());
   }
@@ -807,7 +901,7 @@ PUIdx BinaryMplImport::ImportFunction() {
   return func->GetPuidx();
 }
 
-inline void BinaryMplImport::SkipTotalSize() {
+void BinaryMplImport::SkipTotalSize() {
   ReadInt();
 }
 
@@ -824,18 +918,139 @@ void BinaryMplImport::ReadStrField() {
   CHECK_FATAL(tag == ~kBinStrStart, "pattern mismatch in Read STR");
 }
 
+uint8 *BinaryMplImport::ImportWords(uint32 size) {
+  if (ReadNum() == 0) {
+    return nullptr;
+  }
+  auto *words = static_cast<uint8*>(mod.GetMemPool()->Malloc(size));
+  for (uint32 i = 0; i < size; ++i) {
+    words[i] = Read();
+  }
+  return words;
+}
+
+void BinaryMplImport::ReadHeaderField() {
+  SkipTotalSize();
+  withFuncBody = true;
+  mod.SetFlavor(static_cast<MIRFlavor>(ReadNum()));
+  mod.SetSrcLang(static_cast<MIRSrcLang>(ReadNum()));
+  mod.SetID(ReadNum());
+  mod.SetNumFuncs(ReadNum());
+  mod.SetGlobalMemSize(ReadNum());
+  mod.SetGlobalBlockMap(ImportWords(mod.GetGlobalMemSize()));
+  mod.SetGlobalWordsTypeTagged(ImportWords(BlockSize2BitVectorSize(mod.GetGlobalMemSize())));
+  mod.SetGlobalWordsRefCounted(ImportWords(BlockSize2BitVectorSize(mod.GetGlobalMemSize())));
+  std::string entryFuncName;
+  ReadAsciiStr(entryFuncName);
+  mod.SetEntryFuncName(entryFuncName);
+  mod.SetWithProfileInfo(ReadNum() != 0);
+  mod.SetSomeSymbolNeedForDecl(ReadNum() != 0);
+
+  int64 size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    mod.GetImportFiles().push_back(ImportStr());
+  }
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    mod.PushbackImportPath(ImportStr());
+  }
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    std::string mpltName;
+    ReadAsciiStr(mpltName);
+    mod.PushbackImportedMplt(mpltName);
+  }
+
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx idx = ImportStr();
+    bool isString = ReadNum() != 0;
+    uint32 value = isString ? ImportStr().GetIdx() : static_cast<uint32>(ReadNum());
+    mod.PushFileInfoPair(MIRInfoPair(idx, value));
+    mod.PushFileInfoIsString(isString);
+  }
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx idx = ImportStr();
+    mod.PushbackFileInfo(MIRInfoPair(idx, static_cast<uint32>(ReadNum())));
+  }
+  size = ReadNum();
+  for (int64 i = 0; i < size; ++i) {
+    GStrIdx idx = ImportStr();
+    int64 len = ReadNum();
+    std::vector<uint8> data;
+    for (int64 j = 0; j < len; ++j) {
+      data.push_back(Read());
+    }
+    mod.PushbackFileData(MIRDataPair(idx, data));
+  }
+  CHECK_FATAL(ReadNum() == ~kBinHeaderStart, "pattern mismatch in Read HEADER");
+}
+
 void BinaryMplImport::ReadTypeField() {
   SkipTotalSize();
 
   int32 size = ReadInt();
-  for (int64 i = 0; i < size; ++i) {
-    ImportType();
+  if (withFuncBody) {
+    // the named types of the module replace whatever InsertInTypeTables recorded, keeping their order
+    std::vector<GStrIdx> typeDefOrder;
+    for (int64 i = 0; i < size; ++i) {
+      GStrIdx strIdx = ImportStr();
+      TyIdx tyIdx = ImportType();
+      mod.GetTypeNameTab()->SetGStrIdxToTyIdx(strIdx, tyIdx);
+      MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyIdx);
+      if (IsObject(*type) && GlobalTables::GetTypeNameTable().GetTyIdxFromGStrIdx(strIdx) == 0) {
+        GlobalTables::GetTypeNameTable().SetGStrIdxToTyIdx(strIdx, tyIdx);
+      }
+      typeDefOrder.push_back(strIdx);
+    }
+    int64 externSize = ReadNum();
+    for (int64 i = 0; i < externSize; ++i) {
+      mod.AddExternStructType(ImportType());
+    }
+    mod.ClearTypeDefOrder();
+    for (GStrIdx strIdx : typeDefOrder) {
+      mod.PushbackTypeDefOrder(strIdx);
+    }
+  } else {
+    for (int64 i = 0; i < size; ++i) {
+      ImportType();
+    }
   }
   int64 tag = 0;
   tag = ReadNum();
   CHECK_FATAL(tag == ~kBinTypeStart, "pattern mismatch in Read TYPE");
 }
 
+void BinaryMplImport::ReadSymField() {
+  SkipTotalSize();
+
+  int32 size = ReadInt();
+  std::vector<StIdx> symbolDefOrder;
+  for (int64 i = 0; i < size; ++i) {
+    MIRSymbol *sym = InSymbol(nullptr);
+    CHECK_FATAL(sym != nullptr, "null ptr check");
+    symbolDefOrder.push_back(sym->GetStIdx());
+  }
+  // symbols reached through other symbols were appended to the definition order as they were created;
+  // restore the order of the file and keep the others after it
+  MapleVector<StIdx> &defOrder = mod.GetSymbolDefOrder();
+  std::unordered_set<uint32> exported;
+  for (StIdx stIdx : symbolDefOrder) {
+    (void)exported.insert(stIdx.FullIdx());
+  }
+  for (StIdx stIdx : defOrder) {
+    if (exported.find(stIdx.FullIdx()) == exported.end()) {
+      symbolDefOrder.push_back(stIdx);
+    }
+  }
+  defOrder.clear();
+  for (StIdx stIdx : symbolDefOrder) {
+    defOrder.push_back(stIdx);
+  }
+  CHECK_FATAL(ReadNum() == ~kBinSymStart, "pattern mismatch in Read SYM");
+}
+
 void BinaryMplImport::ReadContentField() {
   SkipTotalSize();
 
@@ -861,7 +1076,7 @@ bool BinaryMplImport::Import(const std::string &fname, bool readSymbols, bool re
   ReadFileAt(fname, 0);
   int32 magic = ReadInt();
   if (kMpltMagicNumber != magic) {  // not a binary mplt file
-    buf.clear();
+    UnmapFile();
     return false;
   }
   int64 fieldID = ReadNum();
@@ -883,6 +1098,18 @@ bool BinaryMplImport::Import(const std::string &fname, bool readSymbols, bool re
         Jump2NextField();
         break;
       }
+      case kBinHeaderStart: {
+        ReadHeaderField();
+        break;
+      }
+      case kBinSymStart: {
+        ReadSymField();
+        break;
+      }
+      case kBinFunctionBodyStart: {
+        ReadFunctionBodyField();
+        break;
+      }
       default:
         CHECK_FATAL(false, "should not run here");
     }
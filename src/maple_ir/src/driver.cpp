@@ -43,9 +43,10 @@ int main(int argc, char **argv) {
   constexpr int judgeNumber = 2;
   if (argc < judgeNumber) {
     MIR_PRINTF(
-        "usage: ./irbuild [i|e] <any number of mpl files>\n\n"
-        "The optional 'i' flag will convert the binary mplt input file to ascii\n\n"
-        "The optional 'e' flag will convert the textual mplt input file to binary\n");
+        "usage: ./irbuild [i|e|b] <any number of mpl files>\n\n"
+        "The optional 'i' flag will convert the binary mplt or bpl input file to ascii\n\n"
+        "The optional 'e' flag will convert the textual mplt input file to binary\n\n"
+        "The optional 'b' flag will convert the textual mpl input file to binary, function bodies included\n");
     exit(1);
   }
   char flag = '\0';
@@ -56,6 +57,9 @@ int main(int argc, char **argv) {
   } else if (argv[1][0] == 'e' && argv[1][1] == '\0') {
     flag = 'e';
     i = judgeNumber;
+  } else if (argv[1][0] == 'b' && argv[1][1] == '\0') {
+    flag = 'b';
+    i = judgeNumber;
   }
   while (i < argc) {
     maple::MIRModule module{ argv[i] };
@@ -68,13 +72,13 @@ int main(int argc, char **argv) {
         theParser.EmitError(module.GetFileName().c_str());
         return 1;
       }
-    } else if (flag == 'e') {
+    } else if (flag == 'e' || flag == 'b') {
       maple::MIRParser theParser(module);
       if (theParser.ParseMIR()) {
         ConstantFoldModule(module);
         BinaryMplt binMplt(module);
         std::string modID = module.GetFileName();
-        binMplt.Export("bin." + modID);
+        binMplt.Export("bin." + modID, flag == 'b');
       } else {
         theParser.EmitError(module.GetFileName().c_str());
         return 1;
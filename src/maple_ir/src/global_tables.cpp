@@ -17,6 +17,7 @@
 #include <cstring>
 #include "mir_type.h"
 #include "mir_symbol.h"
+#include "mir_function.h"
 
 #if MIR_FEATURE_FULL
 namespace maple {
@@ -50,21 +51,34 @@ TypeTable::~TypeTable() {
 }
 
 void TypeTable::PutToHashTable(MIRType *mirType) {
-  typeHashTable.insert(mirType);
+  HashShard &shard = GetHashShard(*mirType);
+  TableLockGuard<std::shared_timed_mutex> guard(shard.mutex);
+  shard.typeHashTable.insert(mirType);
 }
 
 TyIdx TypeTable::GetOrCreateMIRType(MIRType *pType) {
-  const auto it = typeHashTable.find(pType);
-  if (it != typeHashTable.end()) {
+  HashShard &shard = GetHashShard(*pType);
+  if (TableConcurrency::IsEnabled()) {
+    // most requested types already exist, look them up without excluding other readers
+    TableSharedLockGuard guard(shard.mutex);
+    const auto it = shard.typeHashTable.find(pType);
+    if (it != shard.typeHashTable.end()) {
+      return (*it)->GetTypeIndex();
+    }
+  }
+  TableLockGuard<std::shared_timed_mutex> guard(shard.mutex);
+  const auto it = shard.typeHashTable.find(pType);
+  if (it != shard.typeHashTable.end()) {
     return (*it)->GetTypeIndex();
   }
 
   MIRType *newTy = CreateType(*pType);
-  PutToHashTable(newTy);
+  shard.typeHashTable.insert(newTy);
   return newTy->GetTypeIndex();
 }
 
 MIRType *TypeTable::voidPtrType = nullptr;
+std::atomic<bool> TableConcurrency::enabled{ false };
 // get or create a type that pointing to pointedTyIdx
 MIRType *TypeTable::GetOrCreatePointerType(TyIdx pointedTyIdx, PrimType primType) {
   MIRPtrType type(pointedTyIdx, primType);
@@ -201,6 +215,7 @@ MIRFloatConst *FPConstTable::GetOrCreateFloatConst(float fval) {
   if (fval == 0.0 && std::signbit(fval)) {
     return minusZeroFloatConst;
   }
+  TableLockGuard<std::mutex> guard(mutex);
   const auto it = floatConstTable.find(fval);
   if (it == floatConstTable.cend()) {
     // create a new one
@@ -222,6 +237,7 @@ MIRDoubleConst *FPConstTable::GetOrCreateDoubleConst(double fval) {
   if (fval == 0.0 && std::signbit(fval)) {
     return minusZeroDoubleConst;
   }
+  TableLockGuard<std::mutex> guard(mutex);
   const auto it = doubleConstTable.find(fval);
   if (it == doubleConstTable.cend()) {
     // create a new one
@@ -255,12 +271,13 @@ GSymbolTable::GSymbolTable() {
 }
 
 GSymbolTable::~GSymbolTable() {
-  for (MIRSymbol *symbol : symbolTable) {
-    delete symbol;
+  for (size_t i = 0; i < symbolTable.size(); ++i) {
+    delete symbolTable[i];
   }
 }
 
 MIRSymbol *GSymbolTable::CreateSymbol(uint8 scopeID) {
+  TableLockGuard<std::recursive_mutex> guard(mutex);
   auto *st = new MIRSymbol(symbolTable.size(), scopeID);
   symbolTable.push_back(st);
   module->AddSymbol(st);
@@ -268,6 +285,7 @@ MIRSymbol *GSymbolTable::CreateSymbol(uint8 scopeID) {
 }
 
 bool GSymbolTable::AddToStringSymbolMap(const MIRSymbol &st) {
+  TableLockGuard<std::recursive_mutex> guard(mutex);
   GStrIdx strIdx = st.GetNameStrIdx();
   if (strIdxToStIdxMap[strIdx].FullIdx() != 0) {
     return false;
@@ -277,6 +295,7 @@ bool GSymbolTable::AddToStringSymbolMap(const MIRSymbol &st) {
 }
 
 bool GSymbolTable::RemoveFromStringSymbolMap(const MIRSymbol &st) {
+  TableLockGuard<std::recursive_mutex> guard(mutex);
   const auto it = strIdxToStIdxMap.find(st.GetNameStrIdx());
   if (it != strIdxToStIdxMap.cend()) {
     strIdxToStIdxMap.erase(it);
@@ -285,6 +304,12 @@ bool GSymbolTable::RemoveFromStringSymbolMap(const MIRSymbol &st) {
   return false;
 }
 
+void FunctionTable::AddFunction(MIRFunction &func) {
+  TableLockGuard<std::mutex> guard(appendMutex);
+  func.SetPuidx(static_cast<PUIdx>(funcTable.size()));
+  funcTable.push_back(&func);
+}
+
 void GSymbolTable::Dump(bool islocal, int32 indent) const {
   for (size_t i = 1; i < symbolTable.size(); ++i) {
     const MIRSymbol *symbol = symbolTable[i];
@@ -13,9 +13,16 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "lexer.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <cmath>
 #include <climits>
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
 #include "mpl_logging.h"
 #include "mir_module.h"
 #include "securec.h"
@@ -33,6 +40,114 @@ static uint8 Char2num(char c) {
   return ret;
 }
 
+namespace {
+// Perfect hash of the MIR keywords, built with hash and displace: the keywords are spread over
+// buckets by one part of their hash, and each bucket gets the displacement that moves all of its
+// keywords to free slots. Every keyword owns a slot, so a lookup is one hash and one compare.
+class KeywordTable {
+ public:
+  KeywordTable() {
+    const std::vector<Keyword> keywords = {
+#define KEYWORD(STR) { #STR, sizeof(#STR) - 1, TK_##STR },
+#include "keywords.def"
+#undef KEYWORD
+    };
+    size_t slotNum = 1;
+    while (slotNum < keywords.size() * kSlotsPerKeyword) {
+      slotNum <<= 1;
+    }
+    slotMask = slotNum - 1;
+    slots.assign(slotNum, Keyword{ nullptr, 0, kTkInvalid });
+    displacements.assign(keywords.size() / kKeywordsPerBucket + 1, 0);
+    std::vector<std::vector<const Keyword*>> buckets(displacements.size());
+    for (const Keyword &keyword : keywords) {
+      buckets[BucketOf(Hash(keyword.name, keyword.length))].push_back(&keyword);
+    }
+    std::vector<size_t> order(buckets.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    // place the crowded buckets first, while most slots are still free
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+    for (size_t bucketIdx : order) {
+      displacements[bucketIdx] = Place(buckets[bucketIdx]);
+    }
+  }
+  ~KeywordTable() = default;
+
+  TokenKind Find(const std::string &name) const {
+    uint64 hash = Hash(name.data(), name.size());
+    const Keyword &keyword = slots[SlotOf(hash, displacements[BucketOf(hash)])];
+    if (keyword.length == name.size() && keyword.name != nullptr &&
+        memcmp(keyword.name, name.data(), keyword.length) == 0) {
+      return keyword.kind;
+    }
+    return kTkInvalid;
+  }
+
+ private:
+  struct Keyword {
+    const char *name;
+    size_t length;
+    TokenKind kind;
+  };
+  static constexpr size_t kSlotsPerKeyword = 2;
+  static constexpr size_t kKeywordsPerBucket = 4;
+  static constexpr uint32 kMaxDisplacement = 1U << 20;
+
+  static uint64 Hash(const char *str, size_t length) {
+    // FNV-1a
+    uint64 hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+      hash = (hash ^ static_cast<uint8>(str[i])) * 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  size_t BucketOf(uint64 hash) const {
+    return static_cast<size_t>(hash >> 32) % displacements.size();
+  }
+
+  size_t SlotOf(uint64 hash, uint32 displacement) const {
+    uint32 base = static_cast<uint32>(hash);
+    uint32 step = static_cast<uint32>((hash * 0x9e3779b97f4a7c15ULL) >> 32) | 1;
+    return (base + displacement * step) & slotMask;
+  }
+
+  uint32 Place(const std::vector<const Keyword*> &bucket) {
+    std::vector<size_t> taken;
+    for (uint32 displacement = 0; displacement < kMaxDisplacement; ++displacement) {
+      taken.clear();
+      for (const Keyword *keyword : bucket) {
+        size_t slot = SlotOf(Hash(keyword->name, keyword->length), displacement);
+        if (slots[slot].name != nullptr || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+          break;
+        }
+        taken.push_back(slot);
+      }
+      if (taken.size() == bucket.size()) {
+        for (size_t i = 0; i < bucket.size(); ++i) {
+          slots[taken[i]] = *bucket[i];
+        }
+        return displacement;
+      }
+    }
+    CHECK_FATAL(false, "no displacement found for the keyword table");
+    return 0;
+  }
+
+  size_t slotMask = 0;
+  std::vector<Keyword> slots;
+  std::vector<uint32> displacements;
+};
+
+const KeywordTable &GetKeywordTable() {
+  static const KeywordTable keywordTable;
+  return keywordTable;
+}
+}  // namespace
+
 /* Read (next) line from the MIR (text) file, and return the read
    number of chars.
    if the line is empty (nothing but a newline), returns 0.
@@ -42,22 +157,80 @@ static uint8 Char2num(char c) {
 int MIRLexer::ReadALine() {
   if (airFile == nullptr) {
     line = "";
+    currentLineSize = 0;
     return -1;
   }
 
   curIdx = 0;
-  if (!std::getline(*airFile, line)) {  // EOF
+  if (airFile == &airFileInternal && mapAddr != nullptr) {
+    return ReadAMappedLine();
+  }
+  if (!std::getline(*airFile, lineBuf)) {  // EOF
     line = "";
     airFile = nullptr;
     currentLineSize = 0;
     return -1;
   }
+  if (airFile == &airFileInternal) {
+    lineOffset = nextLineOffset;
+    nextLineOffset += lineBuf.length() + (airFile->eof() ? 0 : 1);
+  }
 
-  RemoveReturnInline(line);
-  currentLineSize = line.length();
+  RemoveReturnInline(lineBuf);
+  line = lineBuf.c_str();
+  currentLineSize = lineBuf.length();
   return currentLineSize;
 }
 
+int MIRLexer::ReadAMappedLine() {
+  if (nextLineOffset >= mapSize) {  // EOF
+    line = "";
+    airFile = nullptr;
+    currentLineSize = 0;
+    return -1;
+  }
+  // the line is lexed where it is in the mapping, nothing is copied
+  line = mapAddr + nextLineOffset;
+  size_t rest = mapSize - nextLineOffset;
+  const char *end = static_cast<const char*>(memchr(line, '\n', rest));
+  size_t len = (end == nullptr) ? rest : static_cast<size_t>(end - line);
+  lineOffset = nextLineOffset;
+  nextLineOffset += len + (end == nullptr ? 0 : 1);
+  if (len != 0 && line[len - 1] == '\r') {
+    len--;
+  }
+  currentLineSize = static_cast<uint32>(len);
+  return currentLineSize;
+}
+
+void MIRLexer::MapFile(const std::string &filename) {
+  UnmapFile();
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat fileStat;
+  // pipes and other special files are read through the stream
+  if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      (void)madvise(addr, size, MADV_SEQUENTIAL);
+      mapAddr = static_cast<const char*>(addr);
+      mapSize = size;
+    }
+  }
+  close(fd);
+}
+
+void MIRLexer::UnmapFile() {
+  if (mapAddr != nullptr) {
+    (void)munmap(const_cast<char*>(mapAddr), mapSize);
+  }
+  mapAddr = nullptr;
+  mapSize = 0;
+}
+
 MIRLexer::MIRLexer(MIRModule &mod)
     : module(mod),
       theIntVal(0),
@@ -70,26 +243,21 @@ MIRLexer::MIRLexer(MIRModule &mod)
       curIdx(0),
       lineNum(0),
       kind(kTkInvalid),
-      name(""),
-      keywordMap(mod.GetMPAllocator().Adapter()) {
-  // initialize keywordMap
-  keywordMap.clear();
-#define KEYWORD(STR)            \
-  {                             \
-    std::string str;            \
-    str = #STR;                 \
-    keywordMap[str] = TK_##STR; \
-  }
-#include "keywords.def"
-#undef KEYWORD
-}
+      name("") {}
 
 void MIRLexer::PrepareForFile(const std::string &filename) {
-  // open MIR file
-  airFileInternal.open(filename);
-  CHECK_FATAL(airFileInternal.is_open(), "cannot open MIR file %s\n", &filename);
+  // open MIR file; it is only read through a stream if it cannot be mapped
+  if (airFileInternal.is_open()) {
+    airFileInternal.close();
+  }
+  MapFile(filename);
+  if (mapAddr == nullptr) {
+    airFileInternal.open(filename);
+    CHECK_FATAL(airFileInternal.is_open(), "cannot open MIR file %s\n", filename.c_str());
+  }
 
   airFile = &airFileInternal;
+  nextLineOffset = 0;
   // try to read the first line
   if (ReadALine() < 0) {
     lineNum = 0;
@@ -99,10 +267,104 @@ void MIRLexer::PrepareForFile(const std::string &filename) {
   kind = kTkInvalid;
 }
 
+// Continue lexing the file opened by PrepareForFile at the token starting at column of the line at offset.
+void MIRLexer::SeekToken(uint64 offset, uint32 column, uint32 lineNumber) {
+  if (mapAddr == nullptr) {
+    airFileInternal.clear();
+    (void)airFileInternal.seekg(static_cast<std::streamoff>(offset));
+  }
+  airFile = &airFileInternal;
+  nextLineOffset = offset;
+  (void)ReadALine();
+  lineNum = lineNumber;
+  curIdx = column;
+  NextToken();
+}
+
+// Skip to the closing brace of the block whose opening brace is the current token, without building the
+// tokens in between; the closing brace becomes the current token. Comments, char constants and string
+// constants are delimited by the rules LexToken uses, so the braces in them are not counted. Returns false
+// at the end of file or at a malformed constant.
+bool MIRLexer::SkipBlock() {
+  uint32 depth = 1;
+  while (true) {
+    char c = GetCurrentCharWithUpperCheck();
+    if (c == 0 || c == '#') {  // a comment runs to the end of the line
+      if (ReadALine() < 0) {
+        kind = kTkEof;
+        return false;
+      }
+      lineNum++;
+      continue;
+    }
+    curIdx++;
+    switch (c) {
+      case '{':
+        depth++;
+        break;
+      case '}':
+        depth--;
+        if (depth == 0) {
+          kind = kTkRbrace;
+          return true;
+        }
+        break;
+      case '\'':
+        if (GetTokenWithPrefixQuotation() == kTkInvalid) {
+          kind = kTkInvalid;
+          return false;
+        }
+        break;
+      case '\"':
+        curIdx = StringConstEnd(curIdx);
+        if (curIdx >= currentLineSize) {
+          kind = kTkInvalid;
+          return false;
+        }
+        curIdx++;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// index of the quote closing the string constant whose contents start at idx, or the line size if the
+// line ends first; a backslash escapes the character after it, as in GetTokenWithPrefixDoubleQuotation
+uint32 MIRLexer::StringConstEnd(uint32 idx) const {
+  while (idx < currentLineSize && line[idx] != '\"') {
+    idx += (line[idx] == '\\') ? 2 : 1;
+  }
+  return std::min(idx, currentLineSize);
+}
+
+// Write the bytes from beginOffset up to endOffset of the file opened by PrepareForFile to out.
+void MIRLexer::CopyFileRange(uint64 beginOffset, uint64 endOffset, std::ostream &out) {
+  CHECK_FATAL(beginOffset <= endOffset, "bad file range");
+  if (mapAddr != nullptr) {
+    CHECK_FATAL(endOffset <= mapSize, "file range past the end of the file");
+    (void)out.write(mapAddr + beginOffset, static_cast<std::streamsize>(endOffset - beginOffset));
+    return;
+  }
+  constexpr size_t kCopyBufferSize = 64 * 1024;
+  std::vector<char> buf(kCopyBufferSize);
+  airFileInternal.clear();
+  (void)airFileInternal.seekg(static_cast<std::streamoff>(beginOffset));
+  uint64 rest = endOffset - beginOffset;
+  while (rest != 0) {
+    size_t chunk = static_cast<size_t>(std::min<uint64>(rest, buf.size()));
+    bool read = static_cast<bool>(airFileInternal.read(buf.data(), static_cast<std::streamsize>(chunk)));
+    CHECK_FATAL(read, "file range past the end of the file");
+    (void)out.write(buf.data(), static_cast<std::streamsize>(chunk));
+    rest -= chunk;
+  }
+}
+
 void MIRLexer::PrepareForString(const std::string &src) {
-  line = src;
-  RemoveReturnInline(line);
-  currentLineSize = line.length();
+  lineBuf = src;
+  RemoveReturnInline(lineBuf);
+  line = lineBuf.c_str();
+  currentLineSize = lineBuf.length();
   curIdx = 0;
   NextToken();
 }
@@ -122,7 +384,7 @@ void MIRLexer::GenName() {
          c == '@') {
     c = GetNextCurrentCharWithUpperCheck();
   }
-  name = line.substr(startIdx, curIdx - startIdx);
+  (void)name.assign(line + startIdx, curIdx - startIdx);
 }
 
 // get the constant value
@@ -139,7 +401,7 @@ TokenKind MIRLexer::GetConstVal(){
     negative = true;
   }
   const uint32 lenHexPrefix = 2;
-  if (line.compare(curIdx, lenHexPrefix, "0x") == 0) {
+  if (LineHasAt(curIdx, "0x", lenHexPrefix)) {
     curIdx += lenHexPrefix;
     return GetHexConst(valStart, negative);
   }
@@ -161,22 +423,22 @@ TokenKind MIRLexer::GetConstVal(){
 TokenKind MIRLexer::GetSpecialFloatConst() {
   const uint32 lenSpecFloat = 4;
   const uint32 lenSpecDouble = 3;
-  if (line.compare(curIdx, lenSpecFloat, "inff") == 0 && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecFloat))) {
+  if (LineHasAt(curIdx, "inff", lenSpecFloat) && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecFloat))) {
     curIdx += lenSpecFloat;
     theFloatVal = -INFINITY;
     return kTkFloatconst;
   }
-  if (line.compare(curIdx, lenSpecDouble, "inf") == 0 && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecDouble))) {
+  if (LineHasAt(curIdx, "inf", lenSpecDouble) && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecDouble))) {
     curIdx += lenSpecDouble;
     theDoubleVal = -INFINITY;
     return kTkDoubleconst;
   }
-  if (line.compare(curIdx, lenSpecFloat, "nanf") == 0 && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecFloat))) {
+  if (LineHasAt(curIdx, "nanf", lenSpecFloat) && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecFloat))) {
     curIdx += lenSpecFloat;
     theFloatVal = -NAN;
     return kTkFloatconst;
   }
-  if (line.compare(curIdx, lenSpecDouble, "nan") == 0 && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecDouble))) {
+  if (LineHasAt(curIdx, "nan", lenSpecDouble) && !isalnum(GetCharAtWithUpperCheck(curIdx + lenSpecDouble))) {
     curIdx += lenSpecDouble;
     theDoubleVal = -NAN;
     return kTkDoubleconst;
@@ -187,7 +449,7 @@ TokenKind MIRLexer::GetSpecialFloatConst() {
 TokenKind MIRLexer::GetHexConst(uint32 valStart, bool negative) {
   char c = GetCharAtWithUpperCheck(curIdx);
   if (!isxdigit(c)) {
-    name = line.substr(valStart, curIdx - valStart);
+    (void)name.assign(line + valStart, curIdx - valStart);
     return kTkInvalid;
   }
   uint64 tmp = static_cast<uint32>(HexCharToDigit(c));
@@ -206,7 +468,7 @@ TokenKind MIRLexer::GetHexConst(uint32 valStart, bool negative) {
     theFloatVal = -theFloatVal;
     theDoubleVal = -theDoubleVal;
   }
-  name = line.substr(valStart, curIdx - valStart);
+  (void)name.assign(line + valStart, curIdx - valStart);
   return kTkIntconst;
 }
 
@@ -240,7 +502,7 @@ TokenKind MIRLexer::GetIntConst(uint32 valStart, bool negative) {
       curIdx++;
     }
   }
-  name = line.substr(valStart, curIdx - valStart);
+  (void)name.assign(line + valStart, curIdx - valStart);
   theFloatVal = static_cast<float>(theIntVal);
   theDoubleVal = static_cast<double>(theIntVal);
   if (negative && theIntVal == 0) {
@@ -262,7 +524,7 @@ TokenKind MIRLexer::GetFloatConst(uint32 valStart, uint32 startIdx, bool negativ
   if (c == 'e' || c == 'E') {
     c = GetNextCurrentCharWithUpperCheck();
     if (!isdigit(c) && c != '-' && c != '+') {
-      name = line.substr(valStart, curIdx - valStart);
+      (void)name.assign(line + valStart, curIdx - valStart);
       return kTkInvalid;
     }
     if (c == '-' || c == '+') {
@@ -281,7 +543,7 @@ TokenKind MIRLexer::GetFloatConst(uint32 valStart, uint32 startIdx, bool negativ
     curIdx++;
   }
 
-  std::string floatStr = line.substr(startIdx, curIdx - startIdx);
+  std::string floatStr(line + startIdx, curIdx - startIdx);
   // get the float constant value
   if (!doublePrec) {
     int eNum = sscanf_s(floatStr.c_str(), "%e", &theFloatVal);
@@ -295,7 +557,7 @@ TokenKind MIRLexer::GetFloatConst(uint32 valStart, uint32 startIdx, bool negativ
     if (theFloatVal == -0) {
       theDoubleVal = -theDoubleVal;
     }
-    name = line.substr(valStart, curIdx - valStart);
+    (void)name.assign(line + valStart, curIdx - valStart);
     return kTkFloatconst;
   } else {
     int eNum = sscanf_s(floatStr.c_str(), "%le", &theDoubleVal);
@@ -309,7 +571,7 @@ TokenKind MIRLexer::GetFloatConst(uint32 valStart, uint32 startIdx, bool negativ
     if (theDoubleVal == -0) {
       theFloatVal = -theFloatVal;
     }
-    name = line.substr(valStart, curIdx - valStart);
+    (void)name.assign(line + valStart, curIdx - valStart);
     return kTkDoubleconst;
   }
 }
@@ -323,7 +585,7 @@ TokenKind MIRLexer::GetTokenWithPrefixDollar() {
   } else {
     // for error reporting.
     const uint32 printLength = 2;
-    name = line.substr(curIdx - 1, printLength);
+    (void)name.assign(line + curIdx - 1, std::min(printLength, currentLineSize - (curIdx - 1)));
     return kTkInvalid;
   }
 }
@@ -339,7 +601,7 @@ TokenKind MIRLexer::GetTokenWithPrefixPercent() {
       theIntVal = (theIntVal * 10) + HexCharToDigit(c);
       c = GetNextCurrentCharWithUpperCheck();
     }
-    name = line.substr(valStart, curIdx - valStart);
+    (void)name.assign(line + valStart, curIdx - valStart);
     return kTkPreg;
   } else if (isalpha(c) || c == '_' || c == '$') {
     GenName();
@@ -362,7 +624,7 @@ TokenKind MIRLexer::GetTokenWithPrefixAmpersand() {
   } else {
     // for error reporting.
     const uint32 printLength = 2;
-    name = line.substr(curIdx - 1, printLength);
+    (void)name.assign(line + curIdx - 1, std::min(printLength, currentLineSize - (curIdx - 1)));
     return kTkInvalid;
   }
 }
@@ -391,7 +653,7 @@ TokenKind MIRLexer::GetTokenWithPrefixExclamation() {
   } else {
     // for error reporting.
     const uint32 printLength = 2;
-    name = line.substr(curIdx - 1, printLength);
+    (void)name.assign(line + curIdx - 1, std::min(printLength, currentLineSize - (curIdx - 1)));
     return kTkInvalid;
   }
 }
@@ -407,98 +669,91 @@ TokenKind MIRLexer::GetTokenWithPrefixQuotation() {
 }
 
 TokenKind MIRLexer::GetTokenWithPrefixDoubleQuotation() {
-  uint32 startIdx = curIdx;
-  uint32 shift = 0;
-  // for \", skip the \ to leave " only internally
-  // and also for the pair of chars \ and n become '\n' etc.
+  // the escapes are decoded into name: for \", the \ is dropped to leave " only internally,
+  // and the pair of chars \ and n becomes '\n' etc.
+  name.clear();
+  bool escaped = false;
   char c = GetCurrentCharWithUpperCheck();
-  while ((c != 0) && (c != '\"' || (c == '\"' && GetCharAtWithLowerCheck(curIdx - 1) == '\\'))) {
-    if (GetCharAtWithLowerCheck(curIdx - 1) == '\\') {
-      shift++;
-      switch (c) {
-        case '"':
-          line[curIdx - shift] = c;
-          break;
-        case '\\':
-          line[curIdx - shift] = c;
-          // avoid 3rd \ in \\\ being treated as an escaped one
-          line[curIdx] = 0;
-          break;
-        case 'a':
-          line[curIdx - shift] = '\a';
-          break;
-        case 'b':
-          line[curIdx - shift] = '\b';
-          break;
-        case 't':
-          line[curIdx - shift] = '\t';
-          break;
-        case 'n':
-          line[curIdx - shift] = '\n';
-          break;
-        case 'v':
-          line[curIdx - shift] = '\v';
-          break;
-        case 'f':
-          line[curIdx - shift] = '\f';
-          break;
-        case 'r':
-          line[curIdx - shift] = '\r';
-          break;
-        // support hex value \xNN
-        case 'x': {
-          const uint32 hexShift = 4;
-          const uint32 hexLength = 2;
-          uint8 c1 = Char2num(GetCharAtWithLowerCheck(curIdx + 1));
-          uint8 c2 = Char2num(GetCharAtWithLowerCheck(curIdx + 2));
-          uint32 cNew = (c1 << hexShift) + c2;
-          line[curIdx - shift] = cNew;
-          curIdx += hexLength;
-          shift += hexLength;
-          break;
-        }
-        // support oct value \NNN
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9': {
-          const uint32 octShift1 = 3;
-          const uint32 octShift2 = 6;
-          const uint32 octLength = 3;
-          uint32 cNew = (static_cast<unsigned char>(GetCharAtWithLowerCheck(curIdx + 1) - '0') << octShift2) +
-                        (static_cast<unsigned char>(GetCharAtWithLowerCheck(curIdx + 2) - '0') << octShift1) +
-                        static_cast<unsigned char>(GetCharAtWithLowerCheck(curIdx + 3) - '0');
-          line[curIdx - shift] = cNew;
-          curIdx += octLength;
-          shift += octLength;
-          break;
-        }
-        default:
-          line[curIdx - shift] = '\\';
-          shift--;
-          line[curIdx - shift] = c;
-          break;
+  while ((c != 0) && (c != '\"' || escaped)) {
+    if (!escaped) {
+      if (c == '\\') {
+        escaped = true;
+      } else {
+        name.push_back(c);
       }
-    } else if (shift) {
-      line[curIdx - shift] = c;
+      c = GetNextCurrentCharWithUpperCheck();
+      continue;
+    }
+    // a \ that was escaped itself does not escape the char after it
+    escaped = false;
+    switch (c) {
+      case '"':
+      case '\\':
+        name.push_back(c);
+        break;
+      case 'a':
+        name.push_back('\a');
+        break;
+      case 'b':
+        name.push_back('\b');
+        break;
+      case 't':
+        name.push_back('\t');
+        break;
+      case 'n':
+        name.push_back('\n');
+        break;
+      case 'v':
+        name.push_back('\v');
+        break;
+      case 'f':
+        name.push_back('\f');
+        break;
+      case 'r':
+        name.push_back('\r');
+        break;
+      // support hex value \xNN
+      case 'x': {
+        const uint32 hexShift = 4;
+        const uint32 hexLength = 2;
+        uint8 c1 = Char2num(GetCharAtWithUpperCheck(curIdx + 1));
+        uint8 c2 = Char2num(GetCharAtWithUpperCheck(curIdx + 2));
+        uint32 cNew = (c1 << hexShift) + c2;
+        name.push_back(static_cast<char>(cNew));
+        curIdx += hexLength;
+        break;
+      }
+      // support oct value \NNN
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9': {
+        const uint32 octShift1 = 3;
+        const uint32 octShift2 = 6;
+        const uint32 octLength = 3;
+        uint32 cNew = (static_cast<unsigned char>(GetCharAtWithUpperCheck(curIdx + 1) - '0') << octShift2) +
+                      (static_cast<unsigned char>(GetCharAtWithUpperCheck(curIdx + 2) - '0') << octShift1) +
+                      static_cast<unsigned char>(GetCharAtWithUpperCheck(curIdx + 3) - '0');
+        name.push_back(static_cast<char>(cNew));
+        curIdx += octLength;
+        break;
+      }
+      default:
+        name.push_back('\\');
+        name.push_back(c);
+        break;
     }
     c = GetNextCurrentCharWithUpperCheck();
   }
   if (c != '\"') {
     return kTkInvalid;
   }
-  // for empty string
-  if (startIdx == curIdx) {
-    name = "";
-  } else {
-    name = line.substr(startIdx, curIdx - startIdx - shift);
-  }
   curIdx++;
   return kTkString;
 }
@@ -508,7 +763,7 @@ TokenKind MIRLexer::GetTokenSpecial() {
   char c = GetCharAtWithLowerCheck(curIdx);
   if (isalpha(c) || c < 0 || c == '_') {
     GenName();
-    TokenKind tk = keywordMap[name];
+    TokenKind tk = GetKeywordTable().Find(name);
     switch (tk) {
       case TK_nanf:
         theFloatVal = NAN;
@@ -539,7 +794,7 @@ TokenKind MIRLexer::LexToken() {
   // check end of line
   while (c == 0 || c == '#') {
     if (c == '#') {  // process comment contents
-      seenComments.push_back(line.substr(curIdx + 1, currentLineSize - curIdx - 1));
+      seenComments.push_back(std::string(line + curIdx + 1, currentLineSize - curIdx - 1));
     }
     if (ReadALine() < 0) {
       return kTkEof;
@@ -210,6 +210,8 @@ void MIRBuilder::SetStructFieldIDFromFieldName(MIRType &structtype, const std::s
 
 // create a function named str
 MIRFunction *MIRBuilder::GetOrCreateFunction(const std::string &str, TyIdx retTyIdx) {
+  // keep the lookup and the creation of the function atomic when functions are optimized concurrently
+  TableLockGuard<std::recursive_mutex> guard(GlobalTables::GetGsymTable().GetMutex());
   GStrIdx strIdx = GetStringIndex(str);
   MIRSymbol *funcSt = nullptr;
   if (strIdx != 0) {
@@ -226,11 +228,10 @@ MIRFunction *MIRBuilder::GetOrCreateFunction(const std::string &str, TyIdx retTy
   }
   MIRFunction *fn = mirModule->GetMemPool()->New<MIRFunction>(mirModule, funcSt->GetStIdx());
   fn->Init();
-  fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
+  GlobalTables::GetFunctionTable().AddFunction(*fn);
   MIRFuncType *funcType = mirModule->GetMemPool()->New<MIRFuncType>();
   fn->SetMIRFuncType(funcType);
   fn->SetReturnTyIdx(retTyIdx);
-  GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
   funcSt->SetFunction(fn);
   return fn;
 }
@@ -253,6 +254,7 @@ MIRFunction *MIRBuilder::GetFunctionFromStidx(StIdx stIdx) {
 
 MIRFunction *MIRBuilder::CreateFunction(const std::string &name, const MIRType &returnType, const ArgVector &arguments,
                                         bool isVarg, bool createBody) const {
+  TableLockGuard<std::recursive_mutex> guard(GlobalTables::GetGsymTable().GetMutex());
   MIRSymbol *funcSymbol = GlobalTables::GetGsymTable().CreateSymbol(kScopeGlobal);
   CHECK_FATAL(funcSymbol != nullptr, "Failed to create MIRSymbol");
   GStrIdx strIdx = GetOrCreateStringIndex(name.c_str());
@@ -264,8 +266,7 @@ MIRFunction *MIRBuilder::CreateFunction(const std::string &name, const MIRType &
   funcSymbol->SetSKind(kStFunc);
   MIRFunction *fn = mirModule->GetMemPool()->New<MIRFunction>(mirModule, funcSymbol->GetStIdx());
   fn->Init();
-  fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
-  GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
+  GlobalTables::GetFunctionTable().AddFunction(*fn);
   std::vector<TyIdx> funcVecType;
   std::vector<TypeAttrs> funcVecAttrs;
   for (size_t i = 0; i < arguments.size(); ++i) {
@@ -294,9 +295,10 @@ MIRFunction *MIRBuilder::CreateFunction(const std::string &name, const MIRType &
 MIRFunction *MIRBuilder::CreateFunction(const StIdx stIdx, bool addToTable) const {
   MIRFunction *fn = mirModule->GetMemPool()->New<MIRFunction>(mirModule, stIdx);
   fn->Init();
-  fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
   if (addToTable) {
-    GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
+    GlobalTables::GetFunctionTable().AddFunction(*fn);
+  } else {
+    fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
   }
 
   MIRFuncType *funcType = mirModule->GetMemPool()->New<MIRFuncType>();
@@ -446,6 +448,8 @@ MIRSymbol *MIRBuilder::GetOrCreateSymbol(TyIdx tyIdx, const std::string &name, M
 
 MIRSymbol *MIRBuilder::GetOrCreateSymbol(TyIdx tyIdx, GStrIdx strIdx, MIRSymKind mClass, MIRStorageClass sClass,
                                          MIRFunction *func, uint8 scpID, bool sameType = false) const {
+  // keep the lookup and the creation of a global symbol atomic when functions are optimized concurrently
+  TableLockGuard<std::recursive_mutex> guard(GlobalTables::GetGsymTable().GetMutex());
   if (MIRSymbol *st = GetSymbol(tyIdx, strIdx, mClass, sClass, scpID, sameType)) {
     return st;
   }
@@ -266,13 +266,18 @@ void MIRFunction::Dump(bool withoutBody) {
   }
 
   // codeMemPool is nullptr, means maple_ir has been released for memory's sake
-  if (codeMemPool == nullptr) {
+  if (memPoolCtrl != nullptr && codeMemPool == nullptr) {
     LogInfo::MapleLogger() << '\n';
     LogInfo::MapleLogger() << "# [WARNING] skipped dumping because codeMemPool is nullptr " << '\n';
   } else if (GetBody() && !withoutBody && symbol->GetStorageClass() != kScExtern) {
     ResetInfoPrinted();  // this ensures funcinfo will be printed
     GetBody()->Dump(*module, 0, module->GetFlavor() < kMmpl ? GetSymTab() : nullptr,
                     module->GetFlavor() < kMmpl ? GetPregTab() : nullptr, false, true);  // Dump body
+  } else if (IsBodyUnparsed() && !withoutBody && symbol->GetStorageClass() != kScExtern) {
+    // the body skipped by a lazy parse is written out as it was read
+    LogInfo::MapleLogger() << ' ';
+    module->DumpUnparsedFunctionBody(*this);
+    LogInfo::MapleLogger() << '\n';
   } else {
     LogInfo::MapleLogger() << '\n';
   }
@@ -495,6 +500,7 @@ const MIRType *MIRFunction::GetNodeType(const BaseNode &node) const {
 }
 
 void MIRFunction::NewBody() {
+  InitMemPools();
   SetBody(codeMemPool->New<BlockNode>());
   // If mir_function.has been seen as a declaration, its symtab has to be moved
   // from module mempool to function mempool.
@@ -526,16 +532,75 @@ void MIRFunction::NewBody() {
   }
 }
 
+void MIRFunction::SetLazyBody(uint64 lineOffset, uint32 column, uint32 lineNum) {
+  if (lazyBody == nullptr) {
+    lazyBody = module->GetMemPool()->New<MIRLazyBody>();
+  }
+  lazyBody->lineOffset = lineOffset;
+  lazyBody->column = column;
+  lazyBody->lineNum = lineNum;
+  lazyBody->symTab = symTab;
+  lazyBody->pregTab = pregTab;
+  lazyBody->typeNameTab = typeNameTab;
+  lazyBody->labelTab = labelTab;
+}
+
+// drop a lazily parsed body and everything read along with it, so that it can be parsed again
+void MIRFunction::ReleaseBody() {
+  CHECK_FATAL(lazyBody != nullptr, "only a lazily parsed body can be released");
+  // the mempools are created again when the body is parsed again
+  codeMemPool = nullptr;
+  codeMemPoolAllocator.SetMemPool(nullptr);
+  dataMemPool = nullptr;
+  dataMPAllocator.SetMemPool(nullptr);
+  memPoolCtrl.reset();
+  body = nullptr;
+  symTab = lazyBody->symTab;
+  pregTab = lazyBody->pregTab;
+  typeNameTab = lazyBody->typeNameTab;
+  labelTab = lazyBody->labelTab;
+  info.clear();
+  infoIsString.clear();
+  aliasVarMap.clear();
+}
+
+// Functions are never destroyed, so this is the only way the blocks of their mempools go back to the
+// system. Nothing but the parts of the prototype kept on the module mempool may be used afterwards.
+void MIRFunction::ReleaseMemory() {
+  body = nullptr;
+  symTab = nullptr;
+  pregTab = nullptr;
+  typeNameTab = nullptr;
+  labelTab = nullptr;
+  codeMemPool = nullptr;
+  codeMemPoolAllocator.SetMemPool(nullptr);
+  dataMemPool = nullptr;
+  dataMPAllocator.SetMemPool(nullptr);
+  memPoolCtrl.reset();
+}
+
+// Most functions of a module are imported prototypes that never get a body or local tables, so the
+// controller and the mempools of a function are only created when they are first asked for.
+void MIRFunction::CreateMemPools() {
+  memPoolCtrl.reset(new MemPoolCtrler());
+  dataMemPool = memPoolCtrl->NewMemPool("func data mempool");
+  dataMPAllocator.SetMemPool(dataMemPool);
+  codeMemPool = memPoolCtrl->NewMemPool("func code mempool");
+  codeMemPoolAllocator.SetMemPool(codeMemPool);
+}
+
 void MIRFunction::SetUpGDBEnv() {
+  InitMemPools();
   if (codeMemPool != nullptr) {
-    memPoolCtrler.DeleteMemPool(codeMemPool);
+    memPoolCtrl->DeleteMemPool(codeMemPool);
   }
-  codeMemPool = memPoolCtrler.NewMemPool("tmp debug");
+  codeMemPool = memPoolCtrl->NewMemPool("tmp debug");
   codeMemPoolAllocator.SetMemPool(codeMemPool);
 }
 
 void MIRFunction::ResetGDBEnv() {
-  memPoolCtrler.DeleteMemPool(codeMemPool);
+  InitMemPools();
+  memPoolCtrl->DeleteMemPool(codeMemPool);
   codeMemPool = nullptr;
 }
 }  // namespace maple
@@ -18,6 +18,7 @@
 #include <string>
 #include <algorithm>
 #include <unordered_set>
+#include <vector>
 #include <cctype>
 #include "mir_const.h"
 #include "mir_preg.h"
@@ -25,9 +26,13 @@
 #include "mir_builder.h"
 #include "intrinsics.h"
 #include "bin_mplt.h"
+#include "mir_parser.h"
 
 namespace maple {
 #if MIR_FEATURE_FULL  // to avoid compilation error when MIR_FEATURE_FULL=0
+constexpr size_t kEmitBufferSize = 1U << 20;
+thread_local MIRFunction *MIRModule::threadCurFunction = nullptr;
+
 MIRModule::MIRModule(const std::string &fn)
     : memPool(memPoolCtrler.NewMemPool("maple_ir mempool")),
       memPoolAllocator(memPool),
@@ -56,6 +61,8 @@ MIRModule::MIRModule(const std::string &fn)
 }
 
 MIRModule::~MIRModule() {
+  // the lexer of the lazy body parser lives on memPool
+  delete lazyBodyParser;
   memPoolCtrler.DeleteMemPool(memPool);
   if (binMplt) {
     delete binMplt;
@@ -67,11 +74,11 @@ MemPool *MIRModule::CurFuncCodeMemPool(void) const {
 }
 
 MapleAllocator *MIRModule::CurFuncCodeMemPoolAllocator(void) const {
-  return &curFunction->GetCodeMempoolAllocator();
+  return &CurFunction()->GetCodeMempoolAllocator();
 }
 
 MapleAllocator &MIRModule::GetCurFuncCodeMPAllocator(void) const {
-  return curFunction->GetCodeMPAllocator();
+  return CurFunction()->GetCodeMPAllocator();
 }
 
 void MIRModule::AddExternStructType(TyIdx tyIdx) {
@@ -285,15 +292,25 @@ void MIRModule::DumpGlobalArraySymbol() const {
   }
 }
 
-void MIRModule::Emit(const std::string &outfileName) const {
+void MIRModule::Emit(const std::string &outfileName, bool releaseFuncs) const {
   std::ofstream file;
+  // write out in large chunks; the buffer has to be installed before the file is opened
+  std::vector<char> fileBuf(kEmitBufferSize);
+  (void)file.rdbuf()->pubsetbuf(fileBuf.data(), static_cast<std::streamsize>(fileBuf.size()));
   // Change cout's buffer to file.
   std::streambuf *backup = LogInfo::MapleLogger().rdbuf();
   LogInfo::MapleLogger().rdbuf(file.rdbuf());
   file.open(outfileName.c_str(), std::ios::trunc);
   DumpGlobals();
+  // Functions are formatted one after the other, straight into the file buffer: all of the dump code
+  // writes to the single LogInfo::MapleLogger() stream, so there are no per-function buffers that
+  // could be filled in parallel.
   for (MIRFunction *mirFunc : functionList) {
+    // a body that was never read is copied from the input file
     mirFunc->Dump();
+    if (releaseFuncs) {
+      mirFunc->ReleaseMemory();
+    }
   }
   // Restore cout's buffer.
   LogInfo::MapleLogger().rdbuf(backup);
@@ -306,6 +323,23 @@ void MIRModule::DumpFunctionList(bool skipBody) const {
   }
 }
 
+bool MIRModule::LoadFunctionBody(MIRFunction &func) const {
+  if (!func.IsBodyUnparsed()) {
+    return false;
+  }
+  CHECK_FATAL(lazyBodyParser != nullptr, "no parser to load the body of %s", func.GetName().c_str());
+  if (!lazyBodyParser->ParseLazyFuncBody(func)) {
+    lazyBodyParser->EmitError(fileName);
+    CHECK_FATAL(false, "failed to parse the body of %s", func.GetName().c_str());
+  }
+  return true;
+}
+
+void MIRModule::DumpUnparsedFunctionBody(const MIRFunction &func) const {
+  CHECK_FATAL(lazyBodyParser != nullptr, "no parser to read the body of %s", func.GetName().c_str());
+  lazyBodyParser->CopyLazyFuncBody(func, LogInfo::MapleLogger());
+}
+
 void MIRModule::OutputFunctionListAsciiMpl(const std::string &phaseName) {
   std::string fileStem;
   std::string::size_type lastDot = fileName.find_last_of('.');
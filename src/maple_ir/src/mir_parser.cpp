@@ -17,11 +17,11 @@
 #include "opcode_info.h"
 
 namespace maple {
-std::map<TokenKind, MIRParser::FuncPtrParseExpr> MIRParser::funcPtrMapForParseExpr =
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseExpr> MIRParser::funcPtrMapForParseExpr =
     MIRParser::InitFuncPtrMapForParseExpr();
-std::map<TokenKind, MIRParser::FuncPtrParseStmt> MIRParser::funcPtrMapForParseStmt =
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseStmt> MIRParser::funcPtrMapForParseStmt =
     MIRParser::InitFuncPtrMapForParseStmt();
-std::map<TokenKind, MIRParser::FuncPtrParseStmtBlock> MIRParser::funcPtrMapForParseStmtBlock =
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseStmtBlock> MIRParser::funcPtrMapForParseStmtBlock =
     MIRParser::InitFuncPtrMapForParseStmtBlock();
 
 bool MIRParser::ParseStmtDassign(StmtNodePtr &stmt) {
@@ -697,8 +697,7 @@ PUIdx MIRParser::EnterUndeclaredFunction(bool isMcount) {
   funcSt->SetSKind(kStFunc);
   auto *fn = mod.GetMemPool()->New<MIRFunction>(&mod, funcSt->GetStIdx());
   fn->Init();
-  fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
-  GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
+  GlobalTables::GetFunctionTable().AddFunction(*fn);
   funcSt->SetFunction(fn);
   auto *funcType = mod.GetMemPool()->New<MIRFuncType>();
   fn->SetMIRFuncType(funcType);
@@ -1365,9 +1364,9 @@ bool MIRParser::ParseStatement(StmtNodePtr &stmt) {
   uint32 mplNum = lexer.GetLineNum();
   uint32 lnum = lastLineNum;
   uint32 fnum = lastFileNum;
-  std::map<TokenKind, FuncPtrParseStmt>::iterator itFuncPtr = funcPtrMapForParseStmt.find(paramTokenKindForStmt);
-  if (itFuncPtr != funcPtrMapForParseStmt.end()) {
-    if (!(this->*(itFuncPtr->second))(stmt)) {
+  FuncPtrParseStmt funcPtr = funcPtrMapForParseStmt[paramTokenKindForStmt];
+  if (funcPtr != nullptr) {
+    if (!(this->*funcPtr)(stmt)) {
       return false;
     }
   } else {
@@ -1416,8 +1415,8 @@ bool MIRParser::ParseStmtBlock(BlockNodePtr &blk) {
         blk->AddStatement(stmt);
       }
     } else {
-      std::map<TokenKind, FuncPtrParseStmtBlock>::iterator itFuncPtr = funcPtrMapForParseStmtBlock.find(stmtTk);
-      if (itFuncPtr == funcPtrMapForParseStmtBlock.end()) {
+      FuncPtrParseStmtBlock funcPtr = funcPtrMapForParseStmtBlock[stmtTk];
+      if (funcPtr == nullptr) {
         if (stmtTk == kTkRbrace) {
           ParseStmtBlockForSeenComment(blk, mplNum);
           lexer.NextToken();
@@ -1427,7 +1426,7 @@ bool MIRParser::ParseStmtBlock(BlockNodePtr &blk) {
           return false;
         }
       } else {
-        if (!(this->*(itFuncPtr->second))()) {
+        if (!(this->*funcPtr)()) {
           return false;
         }
       }
@@ -2677,20 +2676,20 @@ bool MIRParser::ParseConstAddrLeafExpr(MIRConstPtr &cexpr, MIRType &type) {
 
 bool MIRParser::ParseExpression(BaseNodePtr &expr) {
   TokenKind tk = lexer.GetTokenKind();
-  std::map<TokenKind, MIRParser::FuncPtrParseExpr>::iterator itFuncPtr = funcPtrMapForParseExpr.find(tk);
-  if (itFuncPtr == funcPtrMapForParseExpr.end()) {
+  FuncPtrParseExpr funcPtr = funcPtrMapForParseExpr[tk];
+  if (funcPtr == nullptr) {
     Error("expect expression but get ");
     return false;
   } else {
-    if (!(this->*(itFuncPtr->second))(expr)) {
+    if (!(this->*funcPtr)(expr)) {
       return false;
     }
   }
   return true;
 }
 
-std::map<TokenKind, MIRParser::FuncPtrParseExpr> MIRParser::InitFuncPtrMapForParseExpr() {
-  std::map<TokenKind, MIRParser::FuncPtrParseExpr> funcPtrMap;
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseExpr> MIRParser::InitFuncPtrMapForParseExpr() {
+  TokenDispatchTable<FuncPtrParseExpr> funcPtrMap{};
   funcPtrMap[TK_addrof] = &MIRParser::ParseExprAddrof;
   funcPtrMap[TK_addroffunc] = &MIRParser::ParseExprAddroffunc;
   funcPtrMap[TK_addroflabel] = &MIRParser::ParseExprAddroflabel;
@@ -2761,8 +2760,8 @@ std::map<TokenKind, MIRParser::FuncPtrParseExpr> MIRParser::InitFuncPtrMapForPar
   return funcPtrMap;
 }
 
-std::map<TokenKind, MIRParser::FuncPtrParseStmt> MIRParser::InitFuncPtrMapForParseStmt() {
-  std::map<TokenKind, MIRParser::FuncPtrParseStmt> funcPtrMap;
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseStmt> MIRParser::InitFuncPtrMapForParseStmt() {
+  TokenDispatchTable<FuncPtrParseStmt> funcPtrMap{};
   funcPtrMap[TK_dassign] = &MIRParser::ParseStmtDassign;
   funcPtrMap[TK_iassign] = &MIRParser::ParseStmtIassign;
   funcPtrMap[TK_iassignoff] = &MIRParser::ParseStmtIassignoff;
@@ -2842,8 +2841,8 @@ std::map<TokenKind, MIRParser::FuncPtrParseStmt> MIRParser::InitFuncPtrMapForPar
   return funcPtrMap;
 }
 
-std::map<TokenKind, MIRParser::FuncPtrParseStmtBlock> MIRParser::InitFuncPtrMapForParseStmtBlock() {
-  std::map<TokenKind, MIRParser::FuncPtrParseStmtBlock> funcPtrMap;
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseStmtBlock> MIRParser::InitFuncPtrMapForParseStmtBlock() {
+  TokenDispatchTable<FuncPtrParseStmtBlock> funcPtrMap{};
   funcPtrMap[TK_var] = &MIRParser::ParseStmtBlockForVar;
   funcPtrMap[TK_tempvar] = &MIRParser::ParseStmtBlockForTempVar;
   funcPtrMap[TK_reg] = &MIRParser::ParseStmtBlockForReg;
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <cstring>
 #include <cctype>
+#include <string>
 #include "mpl_logging.h"
 #include "option_parser.h"
 
@@ -38,8 +39,10 @@ bool Options::usePreg = false;
 bool Options::mapleLinker = false;
 bool Options::dumpMuidFile = false;
 bool Options::emitVtableImpl = false;
+uint32 Options::jobs = 1;
 #if MIR_JAVA
 bool Options::skipVirtualMethod = false;
+bool Options::closedWorld = false;
 #endif
 enum OptionIndex {
   kUnknown,
@@ -57,9 +60,11 @@ enum OptionIndex {
   kDumpBefore,
   kDumpAfter,
   kSkipVirtual,
+  kClosedWorld,
   kMapleLinker,
   kMplnkDumpMuid,
   kEmitVtableImpl,
+  kJobs,
 };
 
 const Descriptor kUsage[] = {
@@ -101,8 +106,14 @@ const Descriptor kUsage[] = {
     "  --dump-muid                       Dump MUID def information into a .muid file" },
   { kEmitVtableImpl, 0, "", "emitVtableImpl", kBuildTypeAll, kArgCheckPolicyNone,
     "  --emitVtableImpl                  Generate VtableImpl file" },
+  { kJobs, 0, "", "jobs", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --jobs=NUM                        Run function-local lowering phases on NUM threads" },
 #if MIR_JAVA
   { kSkipVirtual, 0, "", "skipvirtual", kBuildTypeAll, kArgCheckPolicyNone, "  --skipvirtual" },
+  { kClosedWorld, 0, "", "closed-world", kBuildTypeAll, kArgCheckPolicyNone,
+    "  --closed-world                    Assume no classes are loaded besides the ones in the module and its\n"
+    "                                    imports, so that virtual calls with one target in the class hierarchy\n"
+    "                                    are made direct" },
 #endif
   { 0, 0, nullptr, nullptr, kBuildTypeAll, kArgCheckPolicyNone, nullptr }
 };
@@ -167,10 +178,16 @@ bool Options::ParseOptions(int argc, char **argv, std::string &fileName) const {
       case kEmitVtableImpl:
         Options::emitVtableImpl = true;
         break;
+      case kJobs:
+        Options::jobs = std::stoul(opt.Args(), nullptr);
+        break;
 #if MIR_JAVA
       case kSkipVirtual:
         Options::skipVirtualMethod = true;
         break;
+      case kClosedWorld:
+        Options::closedWorld = true;
+        break;
 #endif
       default:
         result = false;
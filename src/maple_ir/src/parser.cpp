@@ -31,7 +31,7 @@ constexpr char kLexerStringFp[] = "FP";
 constexpr char kLexerStringGp[] = "GP";
 constexpr char kLexerStringThrownval[] = "thrownval";
 constexpr char kLexerStringRetval[] = "retval";
-std::map<TokenKind, MIRParser::FuncPtrParseMIRForElem> MIRParser::funcPtrMapForParseMIR =
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseMIRForElem> MIRParser::funcPtrMapForParseMIR =
     MIRParser::InitFuncPtrMapForParseMIR();
 
 MIRFunction *MIRParser::CreateDummyFunction() {
@@ -740,8 +740,7 @@ bool MIRParser::ParseFields(MIRStructType &type) {
     MIRFunction *fn = mod.GetMemPool()->New<MIRFunction>(&mod, funcSymbol->GetStIdx());
     ASSERT(fn != nullptr, "Failed to create MIRFunction");
     fn->Init();
-    fn->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
-    GlobalTables::GetFunctionTable().GetFuncTable().push_back(fn);
+    GlobalTables::GetFunctionTable().AddFunction(*fn);
     funcSymbol->SetFunction(fn);
     fn->SetFileIndex(0);
     fn->SetBaseClassFuncNames(funcSymbol->GetNameStrIdx());
@@ -1885,8 +1884,7 @@ bool MIRParser::ParseFunction(uint32 fileIdx) {
     funcSymbol = mirBuilder.CreateSymbol(TyIdx(0), strIdx, kStFunc, kScText, nullptr, kScopeGlobal);
     func = mod.GetMemPool()->New<MIRFunction>(&mod, funcSymbol->GetStIdx());
     func->Init();
-    func->SetPuidx(GlobalTables::GetFunctionTable().GetFuncTable().size());
-    GlobalTables::GetFunctionTable().GetFuncTable().push_back(func);
+    GlobalTables::GetFunctionTable().AddFunction(*func);
     funcSymbol->SetFunction(func);
     func->SetFuncAttrs(funcAttrs);
   }
@@ -1900,48 +1898,85 @@ bool MIRParser::ParseFunction(uint32 fileIdx) {
     return false;
   }
   if (lexer.GetTokenKind() == kTkLbrace) {  // #2 parse Function body
-    definedLabels.clear();
-    maxPregNo = 0;
-    ResetMaxPregNo(*func);  // reset the maxPregNo due to the change of parameters
-    mod.SetCurFunction(func);
     mod.AddFunction(func);
-    // set maple line number for function
-    func->GetSrcPosition().SetMplLineNum(lexer.GetLineNum());
-    // initialize source line number to be 0
-    // to avoid carrying over info from previous function
-    firstLineNum = 0;
-    lastLineNum = 0;
-    func->NewBody();
-    BlockNode *block = nullptr;
-    if (!ParseStmtBlock(block)) {
-      Error("ParseFunction failed when parsing stmt block");
-      ResetCurrentFunction();
-      return false;
-    }
-    func->SetBody(block);
-    mod.CurFunction()->GetPregTab()->SetIndex(maxPregNo + 1);
-    // set source file number for function
-    func->GetSrcPosition().SetLineNum(firstLineNum);
-    func->GetSrcPosition().SetFileNum(lastFileNum);
-    // check if any local type name is undefined
-    for (auto it : func->GetGStrIdxToTyIdxMap()) {
-      MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(it.second);
-      if (type->GetKind() == kTypeByName) {
-        std::string strStream;
-        const std::string &name = GlobalTables::GetStrTable().GetStringFromStrIdx(it.first);
-        strStream += "type %";
-        strStream += name;
-        strStream += " used but not defined\n";
-        message += strStream;
-        ResetCurrentFunction();
+    if ((options & kLazyFuncBody) != 0 && lexer.IsLexingPreparedFile()) {
+      // only remember where the body is, it is parsed by ParseLazyFuncBody on first use
+      func->GetSrcPosition().SetMplLineNum(lexer.GetLineNum());
+      func->SetLazyBody(lexer.GetLineOffset(), lexer.GetCurIdx() - 1, lexer.GetLineNum());
+      if (!lexer.SkipBlock()) {
+        Error("ParseFunction failed to find the end of the function body");
         return false;
       }
+      func->SetLazyBodyEnd(lexer.GetLineOffset() + lexer.GetCurIdx());
+      lexer.NextToken();
+      ResetCurrentFunction();
+      return true;
+    }
+    if (!ParseFuncBody(*func)) {
+      ResetCurrentFunction();
+      return false;
     }
   }
   ResetCurrentFunction();
   return true;
 }
 
+bool MIRParser::ParseFuncBody(MIRFunction &func) {
+  definedLabels.clear();
+  maxPregNo = 0;
+  ResetMaxPregNo(func);  // reset the maxPregNo due to the change of parameters
+  mod.SetCurFunction(&func);
+  // set maple line number for function
+  func.GetSrcPosition().SetMplLineNum(lexer.GetLineNum());
+  // initialize source line number to be 0
+  // to avoid carrying over info from previous function
+  firstLineNum = 0;
+  lastLineNum = 0;
+  func.NewBody();
+  BlockNode *block = nullptr;
+  if (!ParseStmtBlock(block)) {
+    Error("ParseFunction failed when parsing stmt block");
+    return false;
+  }
+  func.SetBody(block);
+  mod.CurFunction()->GetPregTab()->SetIndex(maxPregNo + 1);
+  // set source file number for function
+  func.GetSrcPosition().SetLineNum(firstLineNum);
+  func.GetSrcPosition().SetFileNum(lastFileNum);
+  // check if any local type name is undefined
+  for (auto it : func.GetGStrIdxToTyIdxMap()) {
+    MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(it.second);
+    if (type->GetKind() == kTypeByName) {
+      std::string strStream;
+      const std::string &name = GlobalTables::GetStrTable().GetStringFromStrIdx(it.first);
+      strStream += "type %";
+      strStream += name;
+      strStream += " used but not defined\n";
+      message += strStream;
+      return false;
+    }
+  }
+  return true;
+}
+
+// parse the body skipped by a lazy parse of the module file; this parser is kept by the module for that
+bool MIRParser::ParseLazyFuncBody(MIRFunction &func) {
+  const MIRLazyBody *lazyBody = func.GetLazyBody();
+  CHECK_FATAL(lazyBody != nullptr, "function body was not skipped by a lazy parse");
+  lexer.SeekToken(lazyBody->lineOffset, lazyBody->column, lazyBody->lineNum);
+  MIRFunction *savedFunc = mod.CurFunction();
+  bool parsed = ParseFuncBody(func);
+  mod.SetCurFunction(savedFunc);
+  return parsed;
+}
+
+// write the text of a body skipped by a lazy parse, from its opening to its closing brace
+void MIRParser::CopyLazyFuncBody(const MIRFunction &func, std::ostream &out) {
+  const MIRLazyBody *lazyBody = func.GetLazyBody();
+  CHECK_FATAL(lazyBody != nullptr, "function body was not skipped by a lazy parse");
+  lexer.CopyFileRange(lazyBody->lineOffset + lazyBody->column, lazyBody->endOffset, out);
+}
+
 bool MIRParser::ParseInitValue(MIRConstPtr &theConst, TyIdx tyIdx) {
   TokenKind tokenKind = lexer.GetTokenKind();
   MIRType &type = *GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyIdx);
@@ -2224,6 +2259,12 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
   if (option != 0) {
     this->options |= option;
   }
+  if ((this->options & kLazyFuncBody) != 0 && mod.GetLazyBodyParser() == nullptr) {
+    // the skipped function bodies are read back through a parser of their own
+    auto *lazyBodyParser = new MIRParser(mod);
+    lazyBodyParser->lexer.PrepareForFile(mod.GetFileName());
+    mod.SetLazyBodyParser(lazyBodyParser);
+  }
   // profiling setup
   mod.SetWithProfileInfo(((this->options & kWithProfileInfo) != 0));
   bool atEof = false;
@@ -2233,8 +2274,8 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
   lexer.NextToken();
   while (!atEof) {
     paramTokenKind = lexer.GetTokenKind();
-    std::map<TokenKind, FuncPtrParseMIRForElem>::iterator itFuncPtr = funcPtrMapForParseMIR.find(paramTokenKind);
-    if (itFuncPtr == funcPtrMapForParseMIR.end()) {
+    FuncPtrParseMIRForElem funcPtr = funcPtrMapForParseMIR[paramTokenKind];
+    if (funcPtr == nullptr) {
       if (paramTokenKind == kTkEof) {
         atEof = true;
       } else {
@@ -2242,7 +2283,7 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
         return false;
       }
     } else {
-      if (!(this->*(itFuncPtr->second))()) {
+      if (!(this->*funcPtr)()) {
         return false;
       }
     }
@@ -2284,8 +2325,8 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
   return true;
 }
 
-std::map<TokenKind, MIRParser::FuncPtrParseMIRForElem> MIRParser::InitFuncPtrMapForParseMIR() {
-  std::map<TokenKind, MIRParser::FuncPtrParseMIRForElem> funcPtrMap;
+MIRParser::TokenDispatchTable<MIRParser::FuncPtrParseMIRForElem> MIRParser::InitFuncPtrMapForParseMIR() {
+  TokenDispatchTable<FuncPtrParseMIRForElem> funcPtrMap{};
   funcPtrMap[TK_func] = &MIRParser::ParseMIRForFunc;
   funcPtrMap[TK_tempvar] = &MIRParser::ParseMIRForVar;
   funcPtrMap[TK_var] = &MIRParser::ParseMIRForVar;
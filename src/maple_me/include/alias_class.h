@@ -65,18 +65,20 @@ class AliasElem {
     nextLevNotAllDefsSeen = allDefsSeen;
   }
 
-  const MapleSet<unsigned int> *GetClassSet() const {
+  const MapleVector<unsigned int> *GetClassSet() const {
     return classSet;
   }
   void AddClassToSet(unsigned int id) {
-    classSet->emplace(id);
+    ASSERT(classSet->empty() || classSet->back() < id, "class set members must be added in ascending id order");
+    classSet->push_back(id);
   }
 
-  const MapleSet<unsigned int> *GetAssignSet() const {
+  const MapleVector<unsigned int> *GetAssignSet() const {
     return assignSet;
   }
   void AddAssignToSet(unsigned int id) {
-    assignSet->emplace(id);
+    ASSERT(assignSet->empty() || assignSet->back() < id, "assign set members must be added in ascending id order");
+    assignSet->push_back(id);
   }
 
  private:
@@ -84,8 +86,9 @@ class AliasElem {
   OriginalSt &ost;
   bool notAllDefsSeen;         // applied to current level; unused for lev -1
   bool nextLevNotAllDefsSeen;  // remember that next level's elements need to be made notAllDefsSeen
-  MapleSet<unsigned int> *classSet;    // points to the set of members of its class; nullptr for single-member classes
-  MapleSet<unsigned int> *assignSet;   // points to the set of members that have assignments among themselves
+  // both sets hold alias elem ids in ascending order; they are filled by walking id2Elem once
+  MapleVector<unsigned int> *classSet;   // points to the set of members of its class; nullptr for single-member classes
+  MapleVector<unsigned int> *assignSet;  // points to the set of members that have assignments among themselves
 };
 
 class AliasClass : public AnalysisResult {
@@ -103,6 +106,10 @@ class AliasClass : public AnalysisResult {
         notAllDefsSeenClassSetRoots(acAlloc.Adapter()),
         globalsAffectedByCalls(std::less<unsigned int>(), acAlloc.Adapter()),
         globalsMayAffectedByClinitCheck(acAlloc.Adapter()),
+        nadsMayUseOsts(acAlloc.Adapter()),
+        globalsMayUseOsts(acAlloc.Adapter()),
+        typeAliasCache(acAlloc.Adapter()),
+        fieldIDOffsetCache(acAlloc.Adapter()),
         lessThrowAlias(lessThrowAliasParam),
         finalFieldAlias(finalFieldHasAlias),
         ignoreIPA(ignoreIpa),
@@ -146,7 +153,7 @@ class AliasClass : public AnalysisResult {
   void ApplyUnionForPointedTos();
   void CollectRootIDOfNextLevelNodes(const OriginalSt &ost, std::set<unsigned int> &rootIDOfNADSs);
   void UnionForNotAllDefsSeen();
-  void CollectAliasGroups(std::map<unsigned int, std::set<unsigned int>> &aliasGroups);
+  void CollectAliasGroups(std::vector<std::vector<unsigned int>> &aliasGroups);
   bool AliasAccordingToType(TyIdx tyidxA, TyIdx tyidxB);
   bool AliasAccordingToFieldID(const OriginalSt &ostA, const OriginalSt &ostB);
   void ReconstructAliasGroups();
@@ -173,6 +180,12 @@ class AliasClass : public AnalysisResult {
   MapleSet<unsigned int> globalsAffectedByCalls;                // set of class ids of globals
   // aliased at calls; needed only when wholeProgramScope is true
   MapleSet<OStIdx> globalsMayAffectedByClinitCheck;
+  // osts every call, return and intrinsiccall may use; built once from the class sets instead of per statement
+  MapleVector<OriginalSt*> nadsMayUseOsts;     // members of the not_all_defs_seen classes
+  MapleVector<OriginalSt*> globalsMayUseOsts;  // osts of globalsAffectedByCalls, rebuilt when that set grows
+  // memoized results of the type based alias queries, keyed by the TyIdx pair
+  MapleUnorderedMap<uint64, bool> typeAliasCache;
+  MapleUnorderedMap<uint64, std::pair<bool, FieldID>> fieldIDOffsetCache;
   bool lessThrowAlias;
   bool finalFieldAlias;  // whether to regard final fields as having alias;
   bool ignoreIPA;        // whether to ignore information provided by IPA
@@ -196,9 +209,15 @@ class AliasClass : public AnalysisResult {
   void InsertMayDefNodeForCall(std::set<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes,
                                StmtNode &stmt, BBId bbid, bool hasNoPrivateDefEffect);
   void InsertMayUseExpr(BaseNode &expr);
-  void CollectMayUseFromGlobalsAffectedByCalls(std::set<OriginalSt*> &mayUseOsts);
-  void CollectMayUseFromNADS(std::set<OriginalSt*> &mayUseOsts);
+  bool AliasAccordingToTypeImpl(TyIdx tyidxA, TyIdx tyidxB);
+  bool GetFieldIDOffset(TyIdx tyIdxA, TyIdx tyIdxB, FieldID &offset);
+  void CollectNADSMayUseOsts();
+  const MapleVector<OriginalSt*> &GetGlobalsMayUseOsts();
   void InsertMayUseNode(std::set<OriginalSt*> &mayUseOsts, MapleMap<OStIdx, MayUseNode> &mayUseNodes);
+  void InsertSharedMayUseNodes(const MapleVector<OriginalSt*> &mayUseOsts, MapleMap<OStIdx, MayUseNode> &mayUseNodes,
+                               bool excludeFinalOst);
+  void InsertSharedMayDefNodes(const MapleVector<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes,
+                               StmtNode &stmt, bool excludeFinalOst, bool excludePrivateOst);
   void InsertMayUseReturn(const StmtNode &stmt);
   void CollectPtsToOfReturnOpnd(const OriginalSt &ost, std::set<OriginalSt*> &mayUseOsts);
   void InsertReturnOpndMayUse(const StmtNode &stmt);
@@ -207,7 +226,7 @@ class AliasClass : public AnalysisResult {
   void InsertMayDefNode(std::set<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes, StmtNode &stmt,
                         BBId bbid);
   void InsertMayDefDassign(StmtNode &stmt, BBId bbid);
-  bool IsEquivalentField(TyIdx tyIdxA, FieldID fldA, TyIdx tyIdxB, FieldID fldB) const;
+  bool IsEquivalentField(TyIdx tyIdxA, FieldID fldA, TyIdx tyIdxB, FieldID fldB);
   void CollectMayDefForIassign(StmtNode &stmt, std::set<OriginalSt*> &mayDefOsts);
   void InsertMayDefNodeExcludeFinalOst(std::set<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes,
                                        StmtNode &stmt, BBId bbid);
@@ -218,7 +237,7 @@ class AliasClass : public AnalysisResult {
   void InsertMayDefUseIntrncall(StmtNode &stmt, BBId bbid);
   void InsertMayDefUseClinitCheck(IntrinsiccallNode &stmt, BBId bbid);
   virtual BB *GetBB(BBId id) = 0;
-  void ProcessIdsAliasWithRoot(const std::set<unsigned int> &idsAliasWithRoot, std::vector<unsigned int> &newGroups);
+  void ProcessIdsAliasWithRoot(const std::vector<unsigned int> &idsAliasWithRoot, std::vector<unsigned int> &newGroups);
   void UpdateNextLevelNodes(std::vector<OriginalSt*> &nextLevelOsts, const AliasElem &aliasElem);
   void UnionNodes(std::vector<OriginalSt*> &nextLevelOsts);
   int GetOffset(const Klass &super, Klass &base) const;
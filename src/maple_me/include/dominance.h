@@ -18,6 +18,57 @@
 #include "bb.h"
 
 namespace maple {
+// the ids in one row of a FlatBBIdLists, in increasing order
+class BBIdRange {
+ public:
+  BBIdRange(const BBId *first, const BBId *last) : first(first), last(last) {}
+  ~BBIdRange() = default;
+
+  const BBId *begin() const {
+    return first;
+  }
+
+  const BBId *end() const {
+    return last;
+  }
+
+  size_t size() const {
+    return static_cast<size_t>(last - first);
+  }
+
+  bool empty() const {
+    return first == last;
+  }
+
+ private:
+  const BBId *first;
+  const BBId *last;
+};
+
+// A list of BB ids for every BB, kept in two flat arrays: the list of the BB with id i is
+// ids[offsets[i]] up to ids[offsets[i + 1]].
+class FlatBBIdLists {
+ public:
+  FlatBBIdLists(size_t bbNum, MapleAllocator &alloc)
+      : offsets(bbNum + 1, 0, alloc.Adapter()), ids(alloc.Adapter()) {}
+  ~FlatBBIdLists() = default;
+
+  // each pair adds its second id to the list of its first one; pairs are sorted and duplicates dropped
+  void Build(std::vector<std::pair<BBId, BBId>> &pairs);
+
+  BBIdRange operator[](size_t idx) const {
+    return BBIdRange(ids.data() + offsets[idx], ids.data() + offsets[idx + 1]);
+  }
+
+  size_t size() const {
+    return offsets.size() - 1;
+  }
+
+ private:
+  MapleVector<uint32> offsets;
+  MapleVector<BBId> ids;
+};
+
 class Dominance : public AnalysisResult {
  public:
   Dominance(MemPool &memPool, MemPool &tmpPool, MapleVector<BB*> &bbVec, BB &commonEntryBB, BB &commonExitBB)
@@ -33,19 +84,22 @@ class Dominance : public AnalysisResult {
         pdomPostOrderIDVec(bbVec.size(), -1, tmpAllocator.Adapter()),
         pdomReversePostOrder(tmpAllocator.Adapter()),
         pdoms(bbVec.size(), nullptr, domAllocator.Adapter()),
-        domFrontier(bbVec.size(), MapleSet<BBId>(std::less<BBId>(), domAllocator.Adapter()), domAllocator.Adapter()),
-        domChildren(bbVec.size(), MapleSet<BBId>(std::less<BBId>(), domAllocator.Adapter()), domAllocator.Adapter()),
+        domFrontier(bbVec.size(), domAllocator),
+        domChildren(bbVec.size(), domAllocator),
         dtPreOrder(bbVec.size(), BBId(0), domAllocator.Adapter()),
         dtDfn(bbVec.size(), -1, domAllocator.Adapter()),
-        pdomFrontier(bbVec.size(), MapleSet<BBId>(std::less<BBId>(), domAllocator.Adapter()), domAllocator.Adapter()),
-        pdomChildren(bbVec.size(), MapleSet<BBId>(std::less<BBId>(), domAllocator.Adapter()), domAllocator.Adapter()),
+        dtSubtreeEnd(bbVec.size(), 0, domAllocator.Adapter()),
+        pdomFrontier(bbVec.size(), domAllocator),
+        pdomChildren(bbVec.size(), domAllocator),
         pdtPreOrder(bbVec.size(), BBId(0), domAllocator.Adapter()),
-        pdtDfn(bbVec.size(), -1, domAllocator.Adapter()) {}
+        pdtDfn(bbVec.size(), -1, domAllocator.Adapter()),
+        pdtSubtreeEnd(bbVec.size(), 0, domAllocator.Adapter()) {}
 
   ~Dominance() = default;
 
   void GenPostOrderID();
   void ComputeDominance();
+  void ComputeDominanceSemiNCA();
   void ComputeDomFrontiers();
   void ComputeDomChildren();
   void ComputeDtPreorder(const BB &bb, size_t &num);
@@ -54,6 +108,7 @@ class Dominance : public AnalysisResult {
   void DumpDoms();
   void PdomGenPostOrderID();
   void ComputePostDominance();
+  void ComputePostDominanceSemiNCA();
   void ComputePdomFrontiers();
   void ComputePdomChildren();
   void ComputePdtPreorder(const BB &bb, size_t &num);
@@ -117,7 +172,7 @@ class Dominance : public AnalysisResult {
     return dtDfn.size();
   }
 
-  MapleSet<BBId> &GetPdomFrontierItem(size_t idx) {
+  BBIdRange GetPdomFrontierItem(size_t idx) const {
     return pdomFrontier[idx];
   }
 
@@ -125,7 +180,7 @@ class Dominance : public AnalysisResult {
     return pdomFrontier.size();
   }
 
-  MapleSet<BBId> &GetPdomChildrenItem(size_t idx) {
+  BBIdRange GetPdomChildrenItem(size_t idx) const {
     return pdomChildren[idx];
   }
 
@@ -165,7 +220,7 @@ class Dominance : public AnalysisResult {
     return pdomReversePostOrder.size();
   }
 
-  MapleSet<BBId> &GetDomFrontier(size_t idx) {
+  BBIdRange GetDomFrontier(size_t idx) const {
     return domFrontier[idx];
   }
 
@@ -173,11 +228,7 @@ class Dominance : public AnalysisResult {
     return domFrontier.size();
   }
 
-  MapleVector<MapleSet<BBId>> &GetDomChildren() {
-    return domChildren;
-  }
-
-  MapleSet<BBId> &GetDomChildren(size_t idx) {
+  BBIdRange GetDomChildren(size_t idx) const {
     return domChildren[idx];
   }
 
@@ -197,6 +248,7 @@ class Dominance : public AnalysisResult {
   bool CommonEntryBBIsPred(const BB &bb) const;
   void PdomPostOrderWalk(BB &bb, int32 &pid, std::vector<bool> &visitedMap);
   BB *PdomIntersect(BB &bb1, const BB &bb2);
+  void SemiNCA(BB &root, bool isPdom, MapleVector<BB*> &idoms);
 
  private:
   MapleAllocator tmpAllocator;  // can be freed after dominator computation
@@ -210,14 +262,18 @@ class Dominance : public AnalysisResult {
   MapleVector<int32> pdomPostOrderIDVec;     // index is bb id
   MapleVector<BB*> pdomReversePostOrder;     // an ordering of the BB in reverse postorder
   MapleVector<BB*> pdoms;                    // index is bb id; immediate dominator for each BB
-  MapleVector<MapleSet<BBId>> domFrontier;   // index is bb id
-  MapleVector<MapleSet<BBId>> domChildren;   // index is bb id; for dom tree
-  MapleVector<BBId> dtPreOrder;              // ordering of the BBs in a preorder traversal of the dominator tree
-  MapleVector<uint32> dtDfn;                 // gives position of each BB in dt_preorder
-  MapleVector<MapleSet<BBId>> pdomFrontier;  // index is bb id
-  MapleVector<MapleSet<BBId>> pdomChildren;  // index is bb id; for pdom tree
-  MapleVector<BBId> pdtPreOrder;             // ordering of the BBs in a preorder traversal of the post-dominator tree
-  MapleVector<uint32> pdtDfn;                // gives position of each BB in pdt_preorder
+  FlatBBIdLists domFrontier;       // index is bb id
+  FlatBBIdLists domChildren;       // index is bb id; for dom tree
+  MapleVector<BBId> dtPreOrder;    // ordering of the BBs in a preorder traversal of the dominator tree
+  MapleVector<uint32> dtDfn;       // gives position of each BB in dt_preorder
+  // index is bb id; position in dt_preorder past the subtree of the BB, so that bb1 dominates bb2
+  // exactly when dtDfn[bb1] <= dtDfn[bb2] < dtSubtreeEnd[bb1]
+  MapleVector<uint32> dtSubtreeEnd;
+  FlatBBIdLists pdomFrontier;      // index is bb id
+  FlatBBIdLists pdomChildren;      // index is bb id; for pdom tree
+  MapleVector<BBId> pdtPreOrder;   // ordering of the BBs in a preorder traversal of the post-dominator tree
+  MapleVector<uint32> pdtDfn;      // gives position of each BB in pdt_preorder
+  MapleVector<uint32> pdtSubtreeEnd;  // index is bb id; the same as dtSubtreeEnd for the post-dominator tree
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_DOMINANCE_H
@@ -14,6 +14,7 @@
  */
 #ifndef MAPLE_ME_INCLUDE_IRMAP_H
 #define MAPLE_ME_INCLUDE_IRMAP_H
+#include <functional>
 #include "bb.h"
 #include "ver_symbol.h"
 #include "ssa_tab.h"
@@ -31,8 +32,8 @@ class IRMap : public AnalysisResult {
         dom(dom),
         irMapAlloc(&memPool),
         tempAlloc(&tmpMemPool),
-        mapHashLength(hashTableSize),
-        hashTable(mapHashLength, nullptr, irMapAlloc.Adapter()),
+        hashTableShift(kHashIndexBits - HashTableSizeLog2(hashTableSize)),
+        hashTable(1u << (kHashIndexBits - hashTableShift), HashSlot(), irMapAlloc.Adapter()),
         verst2MeExprTable(ssaTab.GetVersionStTableSize(), nullptr, irMapAlloc.Adapter()),
         regMeExprTable(irMapAlloc.Adapter()),
         curBB(nullptr),
@@ -49,6 +50,8 @@ class IRMap : public AnalysisResult {
   }
 
   MeExpr *HashMeExpr(MeExpr &meExpr);
+  MeExpr *FindHashedMeExpr(MeExpr &meExpr);
+  void DumpHashTableStats() const;
   void BuildBB(BB &bb, std::vector<bool> &bbIRMapProcessed);
   MeExpr *BuildExpr(BaseNode&);
   IvarMeExpr *BuildLHSIvarFromIassMeStmt(IassignMeStmt &iassignMeStmt);
@@ -60,6 +63,9 @@ class IRMap : public AnalysisResult {
   RegMeExpr *CreateRegMeExprVersion(const OriginalSt&);
   RegMeExpr *CreateRegMeExprVersion(const RegMeExpr&);
   MeExpr *ReplaceMeExprExpr(MeExpr&, MeExpr&, MeExpr&);
+  // the op, ivar or nary meExpr with each operand, or the base of an ivar, replaced by what
+  // rewriteOpnd(opnd, opndIdx) returns, hashed; meExpr itself if no operand changes or it has none
+  MeExpr *RewriteOpnds(MeExpr &meExpr, const std::function<MeExpr*(MeExpr&, size_t)> &rewriteOpnd);
   bool ReplaceMeExprStmt(MeStmt&, MeExpr&, MeExpr&);
   MeExpr *GetMeExprByVerID(uint32 verid) const {
     return verst2MeExprTable[verid];
@@ -183,8 +189,20 @@ class IRMap : public AnalysisResult {
   MapleAllocator irMapAlloc;
   MapleAllocator tempAlloc;
   int32 exprID = 0;                                // for allocating exprid_ in MeExpr
-  uint32 mapHashLength;                            // size of hashTable
-  MapleVector<MeExpr*> hashTable;                  // the value number hash table
+  // The value number hash table uses open addressing with linear probing, keyed on MeExpr::GetHashIndex().
+  // Each occupied slot heads the chain (linked through MeExpr::next) of the exprs having exactly that hash
+  // index. The table starts at the size the function asked for and doubles when it gets 3/4 full.
+  struct HashSlot {
+    uint32 hashIdx = 0;
+    MeExpr *head = nullptr;  // nullptr for an empty slot
+  };
+  static constexpr uint32 kHashIndexBits = 32;
+  uint32 hashTableShift;                           // hashTable has 1 << (kHashIndexBits - hashTableShift) slots
+  MapleVector<HashSlot> hashTable;                 // the value number hash table
+  uint32 hashTableUsed = 0;                        // number of occupied slots
+  uint64 hashLookups = 0;                          // probe statistics, see DumpHashTableStats
+  uint64 hashProbes = 0;
+  uint32 maxHashProbes = 0;
   MapleVector<MeExpr*> verst2MeExprTable;          // map versionst to MeExpr.
   MapleVector<RegMeExpr*> regMeExprTable;          // record all the regmeexpr created by ssapre
   bool needAnotherPass = false;                    // set to true if CFG has changed
@@ -194,6 +212,9 @@ class IRMap : public AnalysisResult {
 
   bool ReplaceMeExprStmtOpnd(uint32, MeStmt&, MeExpr&, MeExpr&);
   MeExpr *BuildLHSVar(const VersionSt &verSt, DassignMeStmt &defMeStmt);
+  static uint32 HashTableSizeLog2(uint32 minSize);
+  HashSlot &FindHashSlot(uint32 hashIdx);
+  void GrowHashTable();
   void PutToBucket(uint32, MeExpr&);
   MeStmt *BuildMeStmtWithNoSSAPart(StmtNode &stmt);
   MeStmt *BuildMeStmt(StmtNode&);
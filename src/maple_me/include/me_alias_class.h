@@ -55,6 +55,10 @@ class MeDoAliasClass : public MeFuncPhase {
   std::string PhaseName() const override {
     return "aliasclass";
   }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_ALIAS_CLASS_H
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_BCE_H
+#define MAPLE_ME_INCLUDE_ME_BCE_H
+#include <set>
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "me_dom_walker.h"
+
+namespace maple {
+// Bounds check elimination over the HSSA form built by IRMap. The bounds check of a java array
+// access, carried by the array expression or by an MPL_BOUNDARY_CHECK intrinsic call, is
+// removed when the index is proved to lie in [0, length): when the same array and index, or a
+// larger constant index, are checked by a dominating access, when a constant index is below the
+// constant length the array is allocated with, or when the index is not negative and a
+// dominating branch compares it below the length of the array. An index is not negative if it
+// is a constant, an array length, the result of a phi all of whose operands are not negative
+// (the usual induction variable starting at 0 and incremented by 1 while below a bound), or if a
+// dominating branch compares it with 0. An access once checked stays checked in the bbs its bb
+// dominates.
+class MeBCE : public MeDomWalker {
+ public:
+  MeBCE(MeFunction &func, Dominance &dom, bool enabledDebug)
+      : MeDomWalker(func, dom), irMap(*func.GetIRMap()), enabledDebug(enabledDebug) {}
+
+  ~MeBCE() = default;
+
+  void Run();
+
+ private:
+  struct CheckedAccess {
+    MeExpr *array;
+    MeExpr *index;
+    BB *bb;
+    bool inTry;  // a handler may be entered by the check failing
+  };
+
+  // smaller < larger if strict, smaller <= larger otherwise, as signed integers
+  struct Relation {
+    MeExpr *smaller;
+    MeExpr *larger;
+    bool strict;
+  };
+
+  bool GetConstLength(MeExpr &array, int64 &length) const;
+  bool IsLengthOf(MeExpr &expr, MeExpr &array) const;
+  void AddRelation(MeExpr &cond, bool holds, std::vector<Relation> &relations) const;
+  void CollectRelations(const BB &bb, std::vector<Relation> &relations) const;
+  bool IsBelowSome(MeExpr &expr, const BB &bb) const;
+  bool IsNonNegative(MeExpr &expr, const BB &bb, uint32 depth);
+  bool IsBelowLength(MeExpr &index, MeExpr &array, const BB &bb) const;
+  bool IsCheckedBefore(MeExpr *array, MeExpr &index, const BB &bb) const;
+  bool IsInBounds(MeExpr &array, MeExpr &index, const BB &bb);
+  MeExpr *VisitExpr(MeExpr &expr, const BB &bb, std::vector<CheckedAccess> &newChecks, bool conditional);
+  bool VisitBoundaryCheck(MeStmt &stmt);
+  void VisitStmt(MeStmt &stmt);
+  void VisitBB(BB &bb) override;
+
+  size_t GetNumFacts() const override {
+    return checkedAccesses.size();
+  }
+
+  void DropFacts(size_t numFacts) override {
+    checkedAccesses.resize(numFacts);
+  }
+
+  IRMap &irMap;
+  bool enabledDebug;
+  std::vector<CheckedAccess> checkedAccesses;  // the accesses checked on the path from the entry
+  std::set<MeExpr*> phisInProgress;            // phis assumed not negative while proving it
+  uint32 numChecksRemoved = 0;
+  uint32 numChecksKept = 0;
+};
+
+class MeDoBCE : public MeFuncPhase {
+ public:
+  explicit MeDoBCE(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoBCE() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "bce";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_BCE_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
+#define MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
+#include <vector>
+#include "class_hierarchy.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "me_dom_walker.h"
+
+namespace maple {
+// Removes the JAVA_CLINIT_CHECKs of a class that is known to be initialized: a check is
+// redundant if it is dominated by a check of the same class or of one of its subclasses, as
+// initializing a class initializes its superclasses first. In an instance method or a class
+// initializer, the class of the method and its superclasses are initialized on entry, or being
+// initialized by the current thread, for which the check succeeds. The classes checked on the
+// way down the dominator tree are the facts of the walk.
+class MeClinitOpt : public MeDomWalker {
+ public:
+  MeClinitOpt(MeFunction &func, Dominance &dom, KlassHierarchy &kh, bool enabledDebug)
+      : MeDomWalker(func, dom), klassHierarchy(kh), enabledDebug(enabledDebug) {}
+
+  ~MeClinitOpt() = default;
+
+  void Run();
+
+ private:
+  struct CheckedClass {
+    TyIdx tyIdx;
+    Klass *klass;
+    BB *bb;
+    bool inTry;  // the check may have thrown when a handler is entered
+  };
+
+  bool IsInitialized(TyIdx tyIdx, const BB &bb) const;
+  void VisitBB(BB &bb) override;
+
+  size_t GetNumFacts() const override {
+    return checkedClasses.size();
+  }
+
+  void DropFacts(size_t numFacts) override {
+    checkedClasses.resize(numFacts);
+  }
+
+  KlassHierarchy &klassHierarchy;
+  bool enabledDebug;
+  std::vector<CheckedClass> checkedClasses;  // the classes checked on the path from the entry
+  uint32 numChecksRemoved = 0;
+};
+
+class MeDoClinitOpt : public MeFuncPhase {
+ public:
+  explicit MeDoClinitOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoClinitOpt() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "clinitopt";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_CONST_FOLD_H
+#define MAPLE_ME_INCLUDE_ME_CONST_FOLD_H
+#include "irmap.h"
+
+namespace maple {
+// Evaluates an OpMeExpr whose operands are constants, with the semantics of Java: integer
+// arithmetic wraps around at the width of the result type, shift counts are masked by that
+// width, and comparisons involving NaN are false except ne. An expression that would throw
+// (integer division by zero) or whose value depends on how the target converts an out of
+// range float is left alone.
+class MeConstFold {
+ public:
+  explicit MeConstFold(IRMap &irMap) : irMap(irMap) {}
+
+  ~MeConstFold() = default;
+
+  // the constant expr evaluates to, or nullptr if it can not be folded
+  MeExpr *Fold(OpMeExpr &expr);
+
+ private:
+  MeExpr *FoldIntUnary(OpMeExpr &expr, int64 val);
+  MeExpr *FoldFloatUnary(const OpMeExpr &expr, double val);
+  MeExpr *FoldIntBinary(const OpMeExpr &expr, int64 val0, int64 val1);
+  MeExpr *FoldFloatBinary(const OpMeExpr &expr, double val0, double val1);
+  MeExpr *FoldCompare(OpMeExpr &expr, ConstMeExpr &opnd0, ConstMeExpr &opnd1);
+  MeExpr *FoldCvt(OpMeExpr &expr, ConstMeExpr &opnd);
+  MeExpr *CreateFloatConst(double val, PrimType primType);
+
+  IRMap &irMap;
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_CONST_FOLD_H
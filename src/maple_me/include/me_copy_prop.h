@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_COPY_PROP_H
+#define MAPLE_ME_INCLUDE_ME_COPY_PROP_H
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "me_const_fold.h"
+#include "me_dom_walker.h"
+
+namespace maple {
+// Copy propagation and constant folding over the HSSA form built by IRMap. A use of a
+// version assigned a constant, an address or another variable or register is replaced by
+// that right hand side, and operations whose operands have become constants are folded. The
+// dominator tree is walked in preorder, keeping the version of every symbol current at the
+// statement being visited: since the emitter maps all versions of a symbol back to the
+// symbol, a variable is only propagated to a use where its version is still the current one,
+// and, as phis are pruned where a symbol is dead, only within its bb unless it is defined once.
+// The assignments left without uses are deleted by dse.
+class MeCopyProp : public MeDomWalker {
+ public:
+  MeCopyProp(MeFunction &func, Dominance &dom, bool enabledDebug)
+      : MeDomWalker(func, dom), irMap(*func.GetIRMap()), constFold(*func.GetIRMap()), enabledDebug(enabledDebug) {}
+
+  ~MeCopyProp() = default;
+
+  void Run();
+
+ private:
+  bool IsCurrentVersion(MeExpr &expr) const;
+  bool IsPropagatableLHS(const MeExpr &lhs) const;
+  bool IsForwardable(MeExpr &rhs, const BB &useBB) const;
+  MeExpr *PropagatedValue(MeExpr &use, const BB &useBB);
+  MeExpr *VisitExpr(MeExpr &expr, const BB &useBB);
+  void VisitStmt(MeStmt &stmt);
+  void SetCurrentVersion(MeExpr &expr);
+  void CountDefs();
+  void VisitBB(BB &bb) override;
+
+  size_t GetNumFacts() const override {
+    return undoLog.size();
+  }
+
+  void DropFacts(size_t numFacts) override;
+
+  IRMap &irMap;
+  MeConstFold constFold;
+  bool enabledDebug;
+  std::vector<MeExpr*> curVersion;                    // index is ost idx; nullptr for the initial version
+  std::vector<std::pair<size_t, MeExpr*>> undoLog;    // the versions to restore on leaving a dominator subtree
+  std::vector<uint32> numDefs;                        // index is ost idx
+  uint32 numCopiesPropagated = 0;
+  uint32 numConstsPropagated = 0;
+  uint32 numFolded = 0;
+};
+
+class MeDoCopyProp : public MeFuncPhase {
+ public:
+  explicit MeDoCopyProp(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoCopyProp() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "copyprop";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_COPY_PROP_H
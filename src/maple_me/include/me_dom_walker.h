@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_DOM_WALKER_H
+#define MAPLE_ME_INCLUDE_ME_DOM_WALKER_H
+#include <vector>
+#include "me_function.h"
+#include "dominance.h"
+
+namespace maple {
+// Base of the optimizations that walk the dominator tree in preorder, keeping the facts the stmts
+// on the way establish for the stmts they dominate, and dropping the facts of a subtree on
+// leaving it.
+class MeDomWalker {
+ public:
+  MeDomWalker(MeFunction &func, Dominance &dom) : func(func), ssaTab(*func.GetMeSSATab()), dom(dom) {}
+
+  virtual ~MeDomWalker() = default;
+
+ protected:
+  // the condition of a conditional branch, and the value it has on an edge of the branch
+  struct BranchCond {
+    MeExpr *cond;
+    bool holds;
+  };
+
+  MeExpr *GetDefRHS(MeExpr &expr) const;
+  MeExpr *ResolveCopies(MeExpr &expr) const;
+  void CollectBranchConds(const BB &bb, std::vector<BranchCond> &conds) const;
+  void MarkReachableFromHandlers();
+  bool HoldsAt(const BB *factBB, bool inTry, const BB &bb) const;
+  void WalkDomTree();
+
+  // the childIdx-th child of bbID in the dominator tree, in the order the walk visits them;
+  // false past the last one
+  virtual bool GetDomChild(BBId bbID, size_t childIdx, BBId &childID) const;
+  virtual void VisitBB(BB &bb) = 0;
+  virtual size_t GetNumFacts() const = 0;
+  virtual void DropFacts(size_t numFacts) = 0;
+
+  MeFunction &func;
+  SSATab &ssaTab;
+  Dominance &dom;
+
+ private:
+  std::vector<bool> reachableFromHandler;  // index is bb id
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_DOM_WALKER_H
@@ -29,6 +29,10 @@ class MeDoDominance : public MeFuncPhase {
   std::string PhaseName() const override {
     return "dominance";
   }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_DOMINANCE_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_DSE_H
+#define MAPLE_ME_INCLUDE_ME_DSE_H
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "dominance.h"
+
+namespace maple {
+// Dead store and dead code elimination over the HSSA form built by IRMap, by mark and sweep.
+// Statements with effects visible outside the function are required; a required statement
+// makes the definitions of the versions it uses required, following phis and the chi nodes
+// of may-defs, and makes the conditional branches it is control dependent on (its BB's
+// post-dominance frontier) required. Unrequired assignments and phis are deleted, and an
+// unrequired conditional branch is replaced by a fall-through to its immediate post-dominator.
+// Stores to globals and through pointers are always required: dead stores are not found along
+// the may-def chains.
+class MeDSE {
+ public:
+  MeDSE(MeFunction &func, Dominance &dom, bool enabledDebug)
+      : func(func), irMap(*func.GetIRMap()), ssaTab(*func.GetMeSSATab()), dom(dom), enabledDebug(enabledDebug) {}
+
+  ~MeDSE() = default;
+
+  void Run();
+
+  bool IsCfgChanged() const {
+    return cfgChanged;
+  }
+
+ private:
+  bool IsOstEscaping(const OriginalSt &ost) const;
+  bool ChiListEscapes(const MapleMap<OStIdx, ChiMeNode*> &chiList) const;
+  bool ExprNonDeletable(MeExpr &expr);
+  bool StmtMustRequired(MeStmt &stmt);
+  bool IsStructuralStmt(const MeStmt &stmt) const;
+  void MarkStmtRequired(MeStmt &stmt);
+  void MarkBBRequired(const BB &bb);
+  void MarkExprUsed(MeExpr &expr);
+  void MarkVarDefRequired(VarMeExpr &var);
+  void MarkRegDefRequired(RegMeExpr &reg);
+  void MarkPhiBBRequired(BB &bb);
+  void PropagateLiveness();
+  bool CanRemoveBranch(BB &bb);
+  void RemoveBranch(BB &bb);
+  void RemoveDeadPhis(BB &bb);
+  void RemoveDeadStmts(BB &bb);
+
+  MeFunction &func;
+  IRMap &irMap;
+  SSATab &ssaTab;
+  Dominance &dom;
+  bool enabledDebug;
+  bool keepAllBranches = false;  // the post-dominance frontiers do not cover every bb
+  bool cfgChanged = false;
+  std::vector<bool> exprUsed;              // index is expr id
+  std::vector<uint8> nonDeletableCache;    // index is expr id; 0 unknown, 1 deletable, 2 not
+  std::vector<bool> bbRequired;            // index is bb id
+  std::vector<MeStmt*> stmtWorkList;       // required stmts whose operands are not marked yet
+  std::vector<MeExpr*> defWorkList;        // used vars and regs whose definitions are not marked yet
+  std::vector<uint32> regionMark;          // index is bb id; used by CanRemoveBranch
+  uint32 regionStamp = 0;
+  uint32 numStmtsRemoved = 0;
+  uint32 numPhisRemoved = 0;
+  uint32 numBranchesRemoved = 0;
+};
+
+class MeDoDSE : public MeFuncPhase {
+ public:
+  explicit MeDoDSE(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoDSE() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "dse";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_DSE_H
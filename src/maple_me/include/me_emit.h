@@ -28,6 +28,10 @@ class MeDoEmit : public MeFuncPhase {
   std::string PhaseName() const override {
     return "emit";
   }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_EMIT_H
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_FUNC_OPT_H
+#define MAPLE_ME_INCLUDE_ME_FUNC_OPT_H
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "global_tables.h"
+#include "mpl_scheduler.h"
+#include "me_phase_manager.h"
+
+namespace maple {
+class MeFuncOptScheduler;  // circular dependency exists, no other choice
+
+// Optimizes one function on a worker thread. Function-local phases run concurrently with the
+// phases of other functions; the others write module-wide data and take turns: a function runs
+// them only after the previous function in compilation list order has run all of its own, so
+// the globals they create are created in the same order as in a serial run.
+class MeFuncOptExecutor : public MplTask {
+ public:
+  MeFuncOptExecutor(MeFuncOptScheduler &scheduler, MIRFunction &mirFunc, uint64 rangeNum)
+      : scheduler(scheduler), mirFunc(mirFunc), rangeNum(rangeNum) {}
+
+  ~MeFuncOptExecutor() = default;
+
+  int Run(MplTaskParam *param = nullptr) override;
+
+ private:
+  void PrepareFunction(MemPool &versMemPool, bool isSecondTime);
+  MeFuncPhase *RunPhases(const MeFuncPhase *skipPhase);
+  void Release();
+
+  MeFuncOptScheduler &scheduler;
+  MIRFunction &mirFunc;
+  uint64 rangeNum;
+  // every function has its own mempool controller, so that workers never share a mempool
+  std::unique_ptr<MemPoolCtrler> ctrler;
+  MemPool *managerMp = nullptr;
+  MeFuncPhaseManager *phaseManager = nullptr;
+  MemPool *funcMp = nullptr;
+  MeFunction *meFunc = nullptr;
+  std::string prevPhaseName;
+  size_t lastNonLocalPhase = 0;  // phase index, the turn is passed on after it
+  bool hasNonLocalPhase = false;
+  bool turnTaken = false;
+  bool turnHeld = false;
+};
+
+class MeFuncOptScheduler : public MplScheduler {
+ public:
+  MeFuncOptScheduler(MeFuncPhaseManager &fpm, MIRModule &mod, const std::string &meInput)
+      : MplScheduler("me function optimizer"),
+        phaseManager(fpm),
+        mirModule(mod),
+        meInput(meInput) {}
+
+  ~MeFuncOptScheduler() = default;
+
+  void AddFunction(MIRFunction &func, uint64 rangeNum);
+  void Run(uint32 nthreads);
+  // Controllers of finished functions are kept for the next ones, so their blocks are reused instead of
+  // going back and forth through malloc. With --mempoolhighwater, the resident size is checked every
+  // kResidentCheckInterval recycles; the cache is dropped and malloc trimmed once when it crosses the mark.
+  // Size-class free lists and thread-local block caches would have to live in MemPoolCtrler, which comes
+  // prebuilt in libmempool, so they are not done here.
+  std::unique_ptr<MemPoolCtrler> AcquireCtrler();
+  void RecycleCtrler(std::unique_ptr<MemPoolCtrler> ctrler);
+  // the phases that are not function-local run on one function at a time, in compilation list order
+  void WaitTurn(uint32 taskId);
+  void PassTurn();
+  // everything allocated from the module mempool or written to the log is serialized by this lock;
+  // it is the one the global symbol table takes itself, so lookups that create symbols are covered
+  void LockModule() {
+    GlobalTables::GetGsymTable().GetMutex().lock();
+  }
+
+  void UnlockModule() {
+    GlobalTables::GetGsymTable().GetMutex().unlock();
+  }
+
+  MeFuncPhaseManager &GetPhaseManager() {
+    return phaseManager;
+  }
+
+  MIRModule &GetMIRModule() {
+    return mirModule;
+  }
+
+  const std::string &GetMeInput() const {
+    return meInput;
+  }
+
+ private:
+  MeFuncPhaseManager &phaseManager;
+  MIRModule &mirModule;
+  const std::string &meInput;
+  std::vector<std::unique_ptr<MeFuncOptExecutor>> executors;
+  std::mutex turnMutex;
+  std::condition_variable turnPassed;
+  uint32 turn = 0;  // the id of the task whose turn it is
+  std::mutex idleCtrlersMutex;
+  std::vector<std::unique_ptr<MemPoolCtrler>> idleCtrlers;
+  size_t maxIdleCtrlers = 0;
+  static constexpr size_t kResidentCheckInterval = 16;
+  static constexpr size_t kRearmDivisor = 4;  // trimming is re-armed below 3/4 of the high water mark
+  size_t numRecycled = 0;
+  bool trimArmed = true;
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_FUNC_OPT_H
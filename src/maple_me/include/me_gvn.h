@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_GVN_H
+#define MAPLE_ME_INCLUDE_ME_GVN_H
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "me_dom_walker.h"
+
+namespace maple {
+// Redundancy elimination over the HSSA form built by IRMap. Because IRMap hashes every
+// expression with its SSA operands (and an iread with its mu), two computations of the same
+// value are the same MeExpr node, so that node serves as the value number. The dominator
+// tree is walked in preorder with a scoped table of the values computed so far:
+//  - an occurrence dominated by an earlier computation of the same value reads the temp
+//    the earlier one is saved into;
+//  - at a join BB, a value that is available at the end of every predecessor (after
+//    translating through the phis of the join) is merged in a reg phi, and a value that
+//    is missing on one non-critical edge only is inserted on that edge when it cannot throw.
+// A first pass decides which computations must be saved; a second pass replays the same
+// walk and rewrites the code.
+class MeGVN : public MeDomWalker {
+ public:
+  MeGVN(MeFunction &func, Dominance &dom, bool enabledDebug)
+      : MeDomWalker(func, dom), irMap(*func.GetIRMap()), enabledDebug(enabledDebug) {}
+
+  ~MeGVN() = default;
+
+  void Run();
+
+ private:
+  // an evaluation of a candidate value that later occurrences can use
+  struct Occ {
+    Occ(MeExpr &expr, BB &bb, bool isMerge) : expr(&expr), bb(&bb), isMerge(isMerge) {}
+
+    MeExpr *expr;                      // the value, as hashed before the rewrite
+    BB *bb;
+    bool isMerge;                      // made available by a reg phi at the join bb
+    bool needSave = false;             // some later occurrence uses it
+    RegMeExpr *reg = nullptr;          // holds the value after the rewrite
+    std::vector<Occ*> predOccs;        // for a merge: per pred, the occ available there
+    std::vector<MeExpr*> insertExprs;  // or the translated value to compute at its end
+  };
+
+  void ComputeWalkOrder();
+  bool GetDomChild(BBId bbID, size_t childIdx, BBId &childID) const override;
+  void VisitBB(BB &bb) override;
+
+  size_t GetNumFacts() const override {
+    return availUndoLog.size();
+  }
+
+  void DropFacts(size_t numFacts) override;
+  MeExpr *VisitExpr(MeExpr &expr, MeStmt &stmt, bool conditional);
+  MeExpr *VisitOpnds(MeExpr &expr, MeStmt &stmt, bool conditional);
+  bool IsCandidate(MeExpr &expr);
+  bool HasVolatileLeaf(MeExpr &expr);
+  bool IsSafeToSpeculate(const MeExpr &expr) const;
+  bool IsDefinedAbove(MeExpr &expr, BB &join);
+  bool IsOccAvailableIn(const Occ &occ, const BB &bb) const;
+  Occ *FindAvailOcc(MeExpr &expr);
+  Occ *FindOccAtEnd(MeExpr &expr, BB &bb);
+  void MakeAvail(Occ &occ);
+  Occ *NextOcc(const MeExpr &expr, bool isMerge);
+  Occ *TryMerge(MeExpr &expr, BB &join);
+  MeExpr *PhiTranslate(MeExpr &expr, const BB &join, size_t predIdx, bool create);
+  RegMeExpr *SaveOcc(Occ &occ, MeExpr &value, MeStmt &stmt);
+  RegMeExpr *MaterializeMerge(Occ &occ);
+  void DumpStats() const;
+
+  IRMap &irMap;
+  bool enabledDebug;
+  bool rewriting = false;
+  BB *curBB = nullptr;
+  std::vector<std::vector<BBId>> domChildren;    // index is bb id; in reverse postorder
+  std::vector<bool> visited;                     // index is bb id
+  std::vector<bool> exportsOccs;                 // index is bb id
+  std::unordered_map<MeExpr*, Occ*> availTable;  // the innermost available occ of each value
+  std::vector<std::pair<MeExpr*, Occ*>> availUndoLog;  // the entries to restore on leaving a subtree
+  std::unordered_map<MeExpr*, std::vector<Occ*>> occsOfExpr;
+  std::unordered_map<MeExpr*, bool> candidateCache;
+  std::unordered_map<MeExpr*, bool> volatileCache;
+  std::deque<Occ> occs;  // in the order the walk creates them
+  size_t nextOcc = 0;    // the next occ to replay in the rewrite pass
+  uint32 numReplaced = 0;
+  uint32 numSaved = 0;
+  uint32 numMerged = 0;
+  uint32 numInserted = 0;
+};
+
+class MeDoGVN : public MeFuncPhase {
+ public:
+  explicit MeDoGVN(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoGVN() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "gvn";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_GVN_H
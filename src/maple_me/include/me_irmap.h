@@ -21,9 +21,8 @@
 namespace maple {
 class MeIRMap : public IRMap {
  public:
-  static const uint32 kHmapHashLength = 5107;
   MeIRMap(MeFunction &f, Dominance &dom, MemPool &memPool, MemPool &tmpMemPool)
-      : IRMap(*f.GetMeSSATab(), dom, memPool, tmpMemPool, kHmapHashLength), func(f) {
+      : IRMap(*f.GetMeSSATab(), dom, memPool, tmpMemPool, EstimateHashTableSize(f)), func(f) {
     SetDumpStmtNum(MeOption::stmtNum);
   }
 
@@ -47,6 +46,7 @@ class MeIRMap : public IRMap {
   }
 
  private:
+  static uint32 EstimateHashTableSize(const MeFunction &f);
   MeFunction &func;
 };
 
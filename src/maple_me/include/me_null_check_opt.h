@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
+#define MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
+#include <set>
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+#include "me_dom_walker.h"
+
+namespace maple {
+// Null check elimination over the HSSA form built by IRMap. An assertnonnull is removed, and a
+// comparison of a reference with null in a conditional branch is folded, when the reference is
+// known not to be null: when it is the result of an allocation or an addrof, the this of an
+// instance method, a phi all of whose operands are such values, when a dominating branch has
+// compared it with null, or when a dominating statement has dereferenced it, as a field access,
+// an array access with bounds check, an array length, a virtual or interface call or a null
+// check throws on null. A dereference is remembered for the bbs its bb dominates.
+class MeNullCheckOpt : public MeDomWalker {
+ public:
+  MeNullCheckOpt(MeFunction &func, Dominance &dom, bool enabledDebug)
+      : MeDomWalker(func, dom), irMap(*func.GetIRMap()), enabledDebug(enabledDebug) {}
+
+  ~MeNullCheckOpt() = default;
+
+  void Run();
+
+ private:
+  struct Dereference {
+    MeExpr *ref;
+    BB *bb;
+    bool inTry;  // a handler may be entered by the dereference throwing
+  };
+
+  bool IsThis(const MeExpr &expr) const;
+  bool IsNonNullByDef(MeExpr &expr, uint32 depth);
+  bool IsNonNullByBranch(MeExpr &expr, const BB &bb) const;
+  bool IsDereferencedBefore(MeExpr &expr, const BB &bb) const;
+  bool IsNonNull(MeExpr &expr, const BB &bb);
+  MeExpr *GetNullTestOpnd(MeExpr &cond) const;
+  void CollectDereferences(MeExpr &expr, std::vector<MeExpr*> &refs) const;
+  void CollectDereferences(const MeStmt &stmt, std::vector<MeExpr*> &refs) const;
+  bool VisitNullCheck(MeStmt &stmt);
+  void VisitCondGoto(MeStmt &stmt);
+  void VisitBB(BB &bb) override;
+
+  size_t GetNumFacts() const override {
+    return dereferences.size();
+  }
+
+  void DropFacts(size_t numFacts) override {
+    dereferences.resize(numFacts);
+  }
+
+  IRMap &irMap;
+  bool enabledDebug;
+  std::vector<Dereference> dereferences;  // the references dereferenced on the path from the entry
+  std::set<MeExpr*> phisInProgress;       // phis assumed not null while proving it
+  uint32 numChecksRemoved = 0;
+  uint32 numTestsFolded = 0;
+};
+
+class MeDoNullCheckOpt : public MeFuncPhase {
+ public:
+  explicit MeDoNullCheckOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoNullCheckOpt() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "nullcheckopt";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
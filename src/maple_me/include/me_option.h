@@ -53,6 +53,9 @@ class MeOption {
   static bool lessThrowAlias;
   static bool finalFieldAlias;
   static bool regreadAtReturn;
+  static uint32 jobs;
+  static uint32 memPoolHighWater;
+  static uint32 semiNCAThreshold;
   void SplitPhases(const std::string &str, std::unordered_set<std::string> &set) const;
   void SplitSkipPhases(const std::string &str) {
     SplitPhases(str, skipPhases);
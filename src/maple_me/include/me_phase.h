@@ -74,6 +74,12 @@ class MeFuncPhase : public Phase {
     isCFGChanged = false;
   }
 
+  // phases that write nothing but the data of the function being optimized can run
+  // while other functions of the module are optimized by other threads
+  virtual bool IsFunctionLocal() const {
+    return false;
+  }
+
  private:
   MePhaseID phaseID;
   std::string prevPhaseName; // used in filename for emit
@@ -55,6 +55,18 @@ class MeFuncPhaseManager : public PhaseManager {
   }
 
   void Run(MIRFunction *mirFunc, uint64 rangeNum, const std::string &meInput);
+  // a manager with the same phase sequence and its own phase instances and analysis results
+  MeFuncPhaseManager *Clone(MemPool &memPool) const;
+  MeFuncPhase *GetPhaseAt(size_t phaseIndex) {
+    return static_cast<MeFuncPhase*>(GetPhase(phaseSequences[phaseIndex]));
+  }
+
+  // run one phase of the sequence; a function optimized in parallel with others is driven
+  // phase by phase by its MeFuncOptExecutor
+  void RunPhaseAt(MeFunction &func, size_t phaseIndex, const std::string &prevPhaseName, bool secondTime);
+  // whether running that phase on func may write to the log, including the analyses it asks for
+  bool PhaseWritesLog(const MeFunction &func, size_t phaseIndex);
+  void AccumulateTimers(const MeFuncPhaseManager &other);
   void IPACleanUp(MeFunction *mirfunc);
   void Run() override {}
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_RC_OPT_H
+#define MAPLE_ME_INCLUDE_ME_RC_OPT_H
+#include <vector>
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes the MCCIncRef and MCCDecRef calls inserted by rclowering that have no effect on the
+// program. An IncRef and a DecRef of the same variable or register cancel out when only
+// statements that can neither throw nor release an object, nor assign it, lie between them; the
+// two are paired across the BBs of a straight-line chain, where each BB is the only successor of
+// the previous one and the previous one is its only predecessor. An IncRef or DecRef of null is
+// a no-op: localrefvars are null on entry, and a forward data flow finds where they still are.
+class MeRCOpt {
+ public:
+  MeRCOpt(MeFunction &func, bool enabledDebug)
+      : func(func), ssaTab(*func.GetMeSSATab()), enabledDebug(enabledDebug) {}
+
+  ~MeRCOpt() = default;
+
+  void Run();
+
+ private:
+  void CollectNullableVars();
+  void TransferNull(MeStmt &stmt, std::vector<bool> &isNull) const;
+  void ComputeNullVars();
+  bool IsNull(MeExpr &expr, const std::vector<bool> &isNull) const;
+  bool IsTransparent(MeStmt &stmt) const;
+  void KillRedefined(MeStmt &stmt, std::vector<IntrinsiccallMeStmt*> &pending) const;
+  bool CancelPending(IntrinsiccallMeStmt &stmt, std::vector<IntrinsiccallMeStmt*> &pending);
+  void OptimizeChain(BB &head);
+
+  MeFunction &func;
+  SSATab &ssaTab;
+  bool enabledDebug;
+  std::vector<int> nullableIdx;                   // index is ost idx; -1 unless a localrefvar or preg
+  std::vector<bool> nullOnEntry;                  // index is nullable idx
+  size_t numNullableVars = 0;
+  std::vector<std::vector<bool>> nullAtEntry;     // index is bb id, then nullable idx
+  std::vector<std::vector<bool>> nullAtExit;      // index is bb id, then nullable idx
+  std::vector<bool> visited;                      // index is bb id
+  std::vector<IntrinsiccallMeStmt*> pendingIncs;  // IncRefs that a later DecRef may cancel
+  std::vector<IntrinsiccallMeStmt*> pendingDecs;  // DecRefs that a later IncRef may cancel
+  uint32 numPairsRemoved = 0;
+  uint32 numNullOpsRemoved = 0;
+};
+
+class MeDoRCOpt : public MeFuncPhase {
+ public:
+  explicit MeDoRCOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  ~MeDoRCOpt() = default;
+
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) override;
+
+  std::string PhaseName() const override {
+    return "rcopt";
+  }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_RC_OPT_H
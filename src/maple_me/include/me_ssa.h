@@ -32,8 +32,14 @@ class MeSSA : public SSA, public AnalysisResult {
   bool VerifySSA() const;
 
  private:
+  using OStBBLists = std::vector<std::vector<BBId>>;  // index is OStIdx; BBIds in increasing order
+
   bool VerifySSAOpnd(const BaseNode &node) const;
-  void CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs);
+  void CollectDefBBs(OStBBLists &ostDefBBs);
+  void CollectUseAndKillBBs(OStBBLists &ostUseBBs, OStBBLists &ostKillBBs);
+  void ComputeLiveInBBs(const std::vector<BBId> &useBBs, const std::vector<BBId> &killBBs, uint32 stamp,
+                        std::vector<uint32> &killStamp, std::vector<uint32> &liveInStamp,
+                        std::vector<BBId> &workList) const;
   void InsertPhiNode();
   void RenameBB(BB&);
   MeFunction *func;
@@ -52,6 +58,10 @@ class MeDoSSA : public MeFuncPhase {
   std::string PhaseName() const override {
     return "ssa";
   }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_SSA_H
@@ -29,6 +29,10 @@ class MeDoSSATab : public MeFuncPhase {
   std::string PhaseName() const override {
     return "ssatab";
   }
+
+  bool IsFunctionLocal() const override {
+    return true;
+  }
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_SSA_TAB_H
@@ -29,16 +29,19 @@ class MeSSAUpdate {
         ssaUpdateMp(mp),
         ssaUpdateAlloc(&mp),
         updateCands(cands),
-        renameStacks(std::less<OStIdx>(), ssaUpdateAlloc.Adapter()) {}
+        renameStackTops(stab.GetOriginalStTable().Size(), nullptr, ssaUpdateAlloc.Adapter()),
+        renameStackLog(ssaUpdateAlloc.Adapter()) {}
 
   ~MeSSAUpdate() {
-    memPoolCtrler.DeleteMemPool(&ssaUpdateMp);
+    CurMemPoolCtrler().DeleteMemPool(&ssaUpdateMp);
   }
 
   void Run();
 
  private:
-  void GetIterDomFrontier(const BB &bb, MapleSet<BBId> &dfSet, std::vector<bool> &visitedMap);
+  void GetIterDomFrontier(const BB &bb, std::vector<BBId> &dfBBs, std::vector<uint32> &visitStamp,
+                          std::vector<uint32> &dfStamp, uint32 stamp);
+  void PushRenameStack(OStIdx ostIdx, VarMeExpr &var);
   void InsertPhis();
   void RenamePhi(BB &bb);
   MeExpr *RenameExpr(MeExpr &meExpr, bool &changed);
@@ -52,7 +55,10 @@ class MeSSAUpdate {
   MemPool &ssaUpdateMp;
   MapleAllocator ssaUpdateAlloc;
   MapleMap<OStIdx, MapleSet<BBId>*> &updateCands;
-  MapleMap<OStIdx, MapleStack<VarMeExpr*>*> renameStacks;
+  // Rename stacks of the candidates: only the tops are kept, indexed by OStIdx and nullptr for other
+  // osts; every push logs the (OStIdx, var) it hides so that the stacks can be popped back to a mark.
+  MapleVector<VarMeExpr*> renameStackTops;
+  MapleVector<std::pair<OStIdx, VarMeExpr*>> renameStackLog;
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_SSA_UPDATE_H
@@ -71,7 +71,8 @@ class SSA {
  public:
   SSA(MemPool &memPool, SSATab &stab)
       : ssaAlloc(&memPool),
-        vstStacks(ssaAlloc.Adapter()),
+        vstStackTops(ssaAlloc.Adapter()),
+        vstStackLog(ssaAlloc.Adapter()),
         vstVersions(ssaAlloc.Adapter()),
         bbRenamed(ssaAlloc.Adapter()),
         ssaTab(&stab) {}
@@ -92,16 +93,21 @@ class SSA {
     return ssaAlloc;
   }
 
-  const MapleVector<MapleStack<VersionSt*>*> &GetVstStacks() const {
-    return vstStacks;
+  VersionSt *GetVstStackTop(size_t idx) const {
+    ASSERT(idx < vstStackTops.size(), "out of range of vstStackTops");
+    return vstStackTops[idx];
   }
 
-  const MapleStack<VersionSt*> *GetVstStack(size_t idx) const {
-    ASSERT(idx < vstStacks.size(), "out of range of vstStacks");
-    return vstStacks.at(idx);
+  // the current height of all the rename stacks together, to pop back to later
+  size_t GetVstStackMark() const {
+    return vstStackLog.size();
   }
-  void PopVersionSt(size_t idx) {
-    vstStacks.at(idx)->pop();
+
+  void PopVstStacksTo(size_t mark) {
+    while (vstStackLog.size() > mark) {
+      vstStackTops[vstStackLog.back().first] = vstStackLog.back().second;
+      vstStackLog.pop_back();
+    }
   }
 
   MapleVector<bool> &GetBBRenamedVec() {
@@ -124,7 +130,10 @@ class SSA {
 
  private:
   MapleAllocator ssaAlloc;
-  MapleVector<MapleStack<VersionSt*>*> vstStacks;    // rename stack for variable versions
+  // The rename stacks for variable versions. Only the tops are kept, indexed by OStIdx; every push
+  // logs the (OStIdx, version) it hides so that the stacks can be popped back to a mark.
+  MapleVector<VersionSt*> vstStackTops;
+  MapleVector<std::pair<size_t, VersionSt*>> vstStackLog;
   MapleVector<int32> vstVersions;                    // maxium version for variables
   MapleVector<bool> bbRenamed;                       // indicate bb is renamed or not
   SSATab *ssaTab;
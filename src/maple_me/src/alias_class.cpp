@@ -37,6 +37,9 @@ static inline bool OriginalStIsZeroLevAndAuto(const OriginalSt &ost) {
   }
   return false;
 }
+static inline uint64 TyIdxPairKey(TyIdx tyIdxA, TyIdx tyIdxB) {
+  return (static_cast<uint64>(tyIdxA.GetIdx()) << 32) | tyIdxB.GetIdx();
+}
 
 bool AliasClass::CallHasNoSideEffectOrPrivateDefEffect(const CallNode &stmt, FuncAttrKind attrKind) const {
   ASSERT(attrKind == FUNCATTR_nosideeffect || attrKind == FUNCATTR_noprivate_defeffect, "Not supportted attrKind");
@@ -279,8 +282,7 @@ void AliasClass::CreateAssignSets() {
     if (unionFind.GetElementsNumber(rootID) > 1) {
       // only root id's have assignset
       if (id2Elem[rootID]->GetAssignSet() == nullptr) {
-        id2Elem[rootID]->assignSet = acMemPool.New<MapleSet<unsigned int>>(std::less<unsigned int>(),
-                                                                           acAlloc.Adapter());
+        id2Elem[rootID]->assignSet = acMemPool.New<MapleVector<unsigned int>>(acAlloc.Adapter());
       }
       id2Elem[rootID]->AddAssignToSet(id);
     }
@@ -401,6 +403,8 @@ void AliasClass::UnionForNotAllDefsSeen() {
 
 // fabricate the imaginary not_all_def_seen AliasElem
 AliasElem *AliasClass::FindOrCreateDummyNADSAe() {
+  // the dummy symbol is shared by the functions being analyzed concurrently
+  TableLockGuard<std::recursive_mutex> guard(GlobalTables::GetGsymTable().GetMutex());
   MIRSymbol *dummySym = mirModule.GetMIRBuilder()->GetOrCreateSymbol((TyIdx)PTY_i32, "__nads_dummysym__", kStVar,
                                                                       kScGlobal, nullptr, kScopeGlobal, false);
   ASSERT(dummySym != nullptr, "nullptr check");
@@ -419,25 +423,37 @@ AliasElem *AliasClass::FindOrCreateDummyNADSAe() {
 }
 
 // TBAA
-// Collect the alias groups. Each alias group is a map that maps the rootId to the ids aliasing with the root.
-void AliasClass::CollectAliasGroups(std::map<unsigned int, std::set<unsigned int>> &aliasGroups) {
-  // key is the root id. The set contains ids of aes that alias with the root.
+// Collect the alias groups. aliasGroups is indexed by the root id; each entry lists, in ascending order, the ids
+// aliasing with that root. Non-root ids keep an empty entry.
+void AliasClass::CollectAliasGroups(std::vector<std::vector<unsigned int>> &aliasGroups) {
+  aliasGroups.resize(id2Elem.size());
   for (AliasElem *ae : id2Elem) {
     unsigned int id = ae->GetClassID();
     unsigned int rootID = unionFind.Root(id);
     if (id == rootID) {
       continue;
     }
-
-    if (aliasGroups.find(rootID) == aliasGroups.end()) {
-      std::set<unsigned int> idsAliasWithRoot;
-      aliasGroups.insert(make_pair(rootID, idsAliasWithRoot));
-    }
-    aliasGroups[rootID].insert(id);
+    aliasGroups[rootID].push_back(id);
   }
 }
 
+// The type based queries are asked for every pair of ids in an alias group, over a handful of distinct types,
+// so their results are remembered per TyIdx pair.
 bool AliasClass::AliasAccordingToType(TyIdx tyidxA, TyIdx tyidxB) {
+  if (tyidxA == tyidxB) {
+    return true;
+  }
+  uint64 key = (tyidxA < tyidxB) ? TyIdxPairKey(tyidxA, tyidxB) : TyIdxPairKey(tyidxB, tyidxA);
+  auto it = typeAliasCache.find(key);
+  if (it != typeAliasCache.end()) {
+    return it->second;
+  }
+  bool result = AliasAccordingToTypeImpl(tyidxA, tyidxB);
+  typeAliasCache[key] = result;
+  return result;
+}
+
+bool AliasClass::AliasAccordingToTypeImpl(TyIdx tyidxA, TyIdx tyidxB) {
   MIRType *mirTypeA = GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyidxA);
   MIRType *mirTypeB = GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyidxB);
   if (mirTypeA == mirTypeB || mirTypeA == nullptr || mirTypeB == nullptr) {
@@ -486,26 +502,38 @@ int AliasClass::GetOffset(const Klass &super, Klass &base) const {
   return offset;
 }
 
+// Get the amount KlassHierarchy::UpdateFieldID adds to a field id of tyIdxA to express it in tyIdxB; the offset
+// only depends on the two types. Return false if the two types are unrelated.
+bool AliasClass::GetFieldIDOffset(TyIdx tyIdxA, TyIdx tyIdxB, FieldID &offset) {
+  uint64 key = TyIdxPairKey(tyIdxA, tyIdxB);
+  auto it = fieldIDOffsetCache.find(key);
+  if (it == fieldIDOffsetCache.end()) {
+    FieldID fld = 0;
+    bool related = klassHierarchy->UpdateFieldID(tyIdxA, tyIdxB, fld);
+    it = fieldIDOffsetCache.insert(std::make_pair(key, std::make_pair(related, fld))).first;
+  }
+  offset = it->second.second;
+  return it->second.first;
+}
+
 bool AliasClass::AliasAccordingToFieldID(const OriginalSt &ostA, const OriginalSt &ostB) {
   if (ostA.GetFieldID() == 0 || ostB.GetFieldID() == 0) {
     return true;
   }
-  MIRType *mirTypeA =
-      GlobalTables::GetTypeTable().GetTypeFromTyIdx(GetAliasAnalysisTable()->GetPrevLevelNode(ostA)->GetTyIdx());
-  MIRType *mirTypeB =
-      GlobalTables::GetTypeTable().GetTypeFromTyIdx(GetAliasAnalysisTable()->GetPrevLevelNode(ostB)->GetTyIdx());
-  TyIdx idxA = mirTypeA->GetTypeIndex();
-  TyIdx idxB = mirTypeB->GetTypeIndex();
+  TyIdx idxA = GetAliasAnalysisTable()->GetPrevLevelNode(ostA)->GetTyIdx();
+  TyIdx idxB = GetAliasAnalysisTable()->GetPrevLevelNode(ostB)->GetTyIdx();
   FieldID fldA = ostA.GetFieldID();
   if (idxA != idxB) {
-    if (!(klassHierarchy->UpdateFieldID(idxA, idxB, fldA))) {
+    FieldID offset = 0;
+    if (!GetFieldIDOffset(idxA, idxB, offset)) {
       return false;
     }
+    fldA += offset;
   }
   return fldA == ostB.GetFieldID();
 }
 
-void AliasClass::ProcessIdsAliasWithRoot(const std::set<unsigned int> &idsAliasWithRoot,
+void AliasClass::ProcessIdsAliasWithRoot(const std::vector<unsigned int> &idsAliasWithRoot,
                                          std::vector<unsigned int> &newGroups) {
   for (unsigned int idA : idsAliasWithRoot) {
     bool unioned = false;
@@ -527,17 +555,18 @@ void AliasClass::ProcessIdsAliasWithRoot(const std::set<unsigned int> &idsAliasW
 }
 
 void AliasClass::ReconstructAliasGroups() {
-  // map the root id to the set contains the ae-id that alias with the root.
-  std::map<unsigned int, std::set<unsigned int>> aliasGroups;
+  // map the root id to the ids that alias with the root.
+  std::vector<std::vector<unsigned int>> aliasGroups;
   CollectAliasGroups(aliasGroups);
   unionFind.Reinit();
-  // kv.first is the root id. kv.second is the id the alias with the root.
-  for (auto oneGroup : aliasGroups) {
-    std::vector<unsigned int> newGroups;  // contains one id of each new alias group.
-    unsigned int rootId = oneGroup.first;
-    std::set<unsigned int> idsAliasWithRoot = oneGroup.second;
+  std::vector<unsigned int> newGroups;  // contains one id of each new alias group.
+  for (unsigned int rootId = 0; rootId < aliasGroups.size(); ++rootId) {
+    if (aliasGroups[rootId].empty()) {
+      continue;
+    }
+    newGroups.clear();
     newGroups.push_back(rootId);
-    ProcessIdsAliasWithRoot(idsAliasWithRoot, newGroups);
+    ProcessIdsAliasWithRoot(aliasGroups[rootId], newGroups);
   }
 }
 
@@ -556,14 +585,14 @@ void AliasClass::CreateClassSets() {
     unsigned int rootID = unionFind.Root(id);
     if (unionFind.GetElementsNumber(rootID) > 1) {
       if (id2Elem[rootID]->GetClassSet() == nullptr) {
-        id2Elem[rootID]->classSet = acMemPool.New<MapleSet<unsigned int>>(std::less<unsigned int>(),
-                                                                          acAlloc.Adapter());
+        id2Elem[rootID]->classSet = acMemPool.New<MapleVector<unsigned int>>(acAlloc.Adapter());
       }
       aliasElem->classSet = id2Elem[rootID]->classSet;
       aliasElem->AddClassToSet(id);
     }
   }
   CollectNotAllDefsSeenAes();
+  CollectNADSMayUseOsts();
 #if DEBUG
   for (AliasElem *aliasElem : id2Elem) {
     if (aliasElem->GetClassSet() != nullptr && aliasElem->IsNotAllDefsSeen() == false &&
@@ -618,30 +647,63 @@ void AliasClass::InsertMayUseExpr(BaseNode &expr) {
   ASSERT(ireadNode.GetSSAVar() != nullptr, "AliasClass::InsertMayUseExpr(): iread cannot have empty mayuse");
 }
 
-// collect the mayUses caused by globalsAffectedByCalls.
-void AliasClass::CollectMayUseFromGlobalsAffectedByCalls(std::set<OriginalSt*> &mayUseOsts) {
-  for (unsigned int elemID : globalsAffectedByCalls) {
-    mayUseOsts.insert(&id2Elem[elemID]->GetOriginalSt());
+// get the mayUses caused by globalsAffectedByCalls.
+// globalsAffectedByCalls can still grow while pass 2 creates extra-level alias elems, so the list is rebuilt
+// whenever its size no longer matches.
+const MapleVector<OriginalSt*> &AliasClass::GetGlobalsMayUseOsts() {
+  if (globalsMayUseOsts.size() != globalsAffectedByCalls.size()) {
+    globalsMayUseOsts.clear();
+    for (unsigned int elemID : globalsAffectedByCalls) {
+      globalsMayUseOsts.push_back(&id2Elem[elemID]->GetOriginalSt());
+    }
   }
+  return globalsMayUseOsts;
 }
 
-// collect the mayUses caused by not_all_def_seen_ae(NADS).
-void AliasClass::CollectMayUseFromNADS(std::set<OriginalSt*> &mayUseOsts) {
+// collect the mayUses caused by not_all_def_seen_ae(NADS). The class sets are final once pass 1 is done, so this
+// is computed once and shared by all statements.
+void AliasClass::CollectNADSMayUseOsts() {
+  nadsMayUseOsts.clear();
   for (AliasElem *notAllDefsSeenAE : notAllDefsSeenClassSetRoots) {
     if (notAllDefsSeenAE->GetClassSet() == nullptr) {
       // single mayUse
-      mayUseOsts.insert(&notAllDefsSeenAE->GetOriginalSt());
+      nadsMayUseOsts.push_back(&notAllDefsSeenAE->GetOriginalSt());
     } else {
       for (unsigned int elemID : *(notAllDefsSeenAE->GetClassSet())) {
         AliasElem *ae = id2Elem[elemID];
         if (!OriginalStIsZeroLevAndAuto(ae->GetOriginalSt())) {
-          mayUseOsts.insert(&ae->GetOriginalSt());
+          nadsMayUseOsts.push_back(&ae->GetOriginalSt());
         }
       }
     }
   }
 }
 
+// insert the osts of a shared list into mayUseNodes; osts already present are kept.
+void AliasClass::InsertSharedMayUseNodes(const MapleVector<OriginalSt*> &mayUseOsts,
+                                         MapleMap<OStIdx, MayUseNode> &mayUseNodes, bool excludeFinalOst) {
+  for (OriginalSt *ost : mayUseOsts) {
+    if (excludeFinalOst && ost->IsFinal()) {
+      continue;
+    }
+    mayUseNodes.insert(std::make_pair(
+        ost->GetIndex(), MayUseNode(ssaTab.GetVersionStTable().GetVersionStFromID(ost->GetZeroVersionIndex()))));
+  }
+}
+
+// insert the osts of a shared list into mayDefNodes; osts already present are kept.
+void AliasClass::InsertSharedMayDefNodes(const MapleVector<OriginalSt*> &mayDefOsts,
+                                         MapleMap<OStIdx, MayDefNode> &mayDefNodes, StmtNode &stmt,
+                                         bool excludeFinalOst, bool excludePrivateOst) {
+  for (OriginalSt *ost : mayDefOsts) {
+    if ((excludeFinalOst && ost->IsFinal()) || (excludePrivateOst && ost->IsPrivate())) {
+      continue;
+    }
+    mayDefNodes.insert(std::make_pair(
+        ost->GetIndex(), MayDefNode(ssaTab.GetVersionStTable().GetVersionStFromID(ost->GetZeroVersionIndex()), &stmt)));
+  }
+}
+
 // insert the ost of mayUseOsts into mayUseNodes
 void AliasClass::InsertMayUseNode(std::set<OriginalSt*> &mayUseOsts, MapleMap<OStIdx, MayUseNode> &mayUseNodes) {
   for (OriginalSt *ost : mayUseOsts) {
@@ -655,13 +717,11 @@ void AliasClass::InsertMayUseNode(std::set<OriginalSt*> &mayUseOsts, MapleMap<OS
 // 1. mayUses caused by not_all_def_seen_ae;
 // 2. mayUses caused by globalsAffectedByCalls.
 void AliasClass::InsertMayUseReturn(const StmtNode &stmt) {
-  std::set<OriginalSt*> mayUseOsts;
-  // 1. collect mayUses caused by not_all_def_seen_ae.
-  CollectMayUseFromNADS(mayUseOsts);
-  // 2. collect mayUses caused by globals_affected_by_call.
-  CollectMayUseFromGlobalsAffectedByCalls(mayUseOsts);
   MapleMap<OStIdx, MayUseNode> &mayUseNodes = ssaTab.GetStmtsSSAPart().GetMayUseNodesOf(stmt);
-  InsertMayUseNode(mayUseOsts, mayUseNodes);
+  // 1. insert mayUses caused by not_all_def_seen_ae.
+  InsertSharedMayUseNodes(nadsMayUseOsts, mayUseNodes, false);
+  // 2. insert mayUses caused by globals_affected_by_call.
+  InsertSharedMayUseNodes(GetGlobalsMayUseOsts(), mayUseNodes, false);
 }
 
 // collect next_level_nodes of the ost of ReturnOpnd into mayUseOsts
@@ -745,9 +805,11 @@ void AliasClass::InsertMayDefDassign(StmtNode &stmt, BBId bbID) {
   InsertMayDefNode(mayDefOsts, mayDefNodes, stmt, bbID);
 }
 
-bool AliasClass::IsEquivalentField(TyIdx tyIdxA, FieldID fldA, TyIdx tyIdxB, FieldID fldB) const {
+bool AliasClass::IsEquivalentField(TyIdx tyIdxA, FieldID fldA, TyIdx tyIdxB, FieldID fldB) {
   if (tyIdxA != tyIdxB) {
-    (void)klassHierarchy->UpdateFieldID(tyIdxA, tyIdxB, fldA);
+    FieldID offset = 0;
+    (void)GetFieldIDOffset(tyIdxA, tyIdxB, offset);
+    fldA += offset;
   }
   return fldA == fldB;
 }
@@ -930,20 +992,20 @@ void AliasClass::InsertMayDefUseCall(StmtNode &stmt, BBId bbID, bool hasSideEffe
   std::set<OriginalSt*> mayDefUseOstsA;
   // 1. collect mayDefs and mayUses caused by callee-opnds
   CollectMayUseForCallOpnd(stmt, mayDefUseOstsA);
-  // 2. collect mayDefs and mayUses caused by not_all_def_seen_ae
-  CollectMayUseFromNADS(mayDefUseOstsA);
   InsertMayUseNode(mayDefUseOstsA, theSSAPart->GetMayUseNodes());
+  // 2. insert mayDefs and mayUses caused by not_all_def_seen_ae
+  InsertSharedMayUseNodes(nadsMayUseOsts, theSSAPart->GetMayUseNodes(), false);
   // insert may def node, if the callee has side-effect.
   if (hasSideEffect) {
     InsertMayDefNodeForCall(mayDefUseOstsA, theSSAPart->GetMayDefNodes(), stmt, bbID, hasNoPrivateDefEffect);
+    InsertSharedMayDefNodes(nadsMayUseOsts, theSSAPart->GetMayDefNodes(), stmt, false, hasNoPrivateDefEffect);
   }
   // 3. insert mayDefs and mayUses caused by globalsAffectedByCalls
-  std::set<OriginalSt*> mayDefUseOstsB;
-  CollectMayUseFromGlobalsAffectedByCalls(mayDefUseOstsB);
-  InsertMayUseNode(mayDefUseOstsB, theSSAPart->GetMayUseNodes());
+  const MapleVector<OriginalSt*> &globalsOsts = GetGlobalsMayUseOsts();
+  InsertSharedMayUseNodes(globalsOsts, theSSAPart->GetMayUseNodes(), false);
   // insert may def node, if the callee has side-effect.
   if (hasSideEffect) {
-    InsertMayDefNodeExcludeFinalOst(mayDefUseOstsB, theSSAPart->GetMayDefNodes(), stmt, bbID);
+    InsertSharedMayDefNodes(globalsOsts, theSSAPart->GetMayDefNodes(), stmt, true, false);
     if (kOpcodeInfo.IsCallAssigned(stmt.GetOpCode())) {
       // 4. insert mayDefs caused by the mustDefs
       std::set<OriginalSt*> mayDefOstsC;
@@ -971,14 +1033,14 @@ void AliasClass::InsertMayDefUseIntrncall(StmtNode &stmt, BBId bbID) {
   MayDefMayUsePart *theSSAPart = static_cast<MayDefMayUsePart*>(ssaTab.GetStmtsSSAPart().SSAPartOf(stmt));
   IntrinsiccallNode &intrinNode = static_cast<IntrinsiccallNode&>(stmt);
   IntrinDesc *intrinDesc = &IntrinDesc::intrinTable[intrinNode.GetIntrinsic()];
-  std::set<OriginalSt*> mayDefUseOsts;
-  // 1. collect mayDefs and mayUses caused by not_all_defs_seen_ae
-  CollectMayUseFromNADS(mayDefUseOsts);
-  // 2. collect mayDefs and mayUses caused by globalsAffectedByCalls
-  CollectMayUseFromGlobalsAffectedByCalls(mayDefUseOsts);
-  InsertMayUseNodeExcludeFinalOst(mayDefUseOsts, theSSAPart->GetMayUseNodes());
+  const MapleVector<OriginalSt*> &globalsOsts = GetGlobalsMayUseOsts();
+  // 1. insert mayDefs and mayUses caused by not_all_defs_seen_ae
+  InsertSharedMayUseNodes(nadsMayUseOsts, theSSAPart->GetMayUseNodes(), true);
+  // 2. insert mayDefs and mayUses caused by globalsAffectedByCalls
+  InsertSharedMayUseNodes(globalsOsts, theSSAPart->GetMayUseNodes(), true);
   if (!intrinDesc->HasNoSideEffect() || calleeHasSideEffect) {
-    InsertMayDefNodeExcludeFinalOst(mayDefUseOsts, theSSAPart->GetMayDefNodes(), stmt, bbID);
+    InsertSharedMayDefNodes(nadsMayUseOsts, theSSAPart->GetMayDefNodes(), stmt, true, false);
+    InsertSharedMayDefNodes(globalsOsts, theSSAPart->GetMayDefNodes(), stmt, true, false);
   }
   if (kOpcodeInfo.IsCallAssigned(stmt.GetOpCode())) {
     // 3. insert maydefs caused by the mustdefs
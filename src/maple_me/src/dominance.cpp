@@ -14,21 +14,79 @@
  */
 #include "dominance.h"
 #include <iostream>
+#include <algorithm>
 
-/* ================= for Dominance ================= */
 namespace maple {
+namespace {
+// Numbers the tree given by children in preorder starting from root, and records for every node the
+// preorder number just past its subtree. The walk keeps its own stack of (node, next child) so that
+// deep trees cannot overflow the call stack.
+void ComputeTreePreorder(const FlatBBIdLists &children, BBId root, size_t &num, MapleVector<BBId> &preOrder,
+                         MapleVector<uint32> &subtreeEnd) {
+  CHECK_FATAL(num < preOrder.size(), "index out of range in ComputeTreePreorder");
+  std::vector<std::pair<BBId, size_t>> workStack;
+  preOrder[num++] = root;
+  workStack.emplace_back(root, 0);
+  while (!workStack.empty()) {
+    BBId id = workStack.back().first;
+    BBIdRange kids = children[id];
+    size_t next = workStack.back().second;
+    if (next < kids.size()) {
+      ++workStack.back().second;
+      BBId kid = kids.begin()[next];
+      CHECK_FATAL(num < preOrder.size(), "index out of range in ComputeTreePreorder");
+      preOrder[num++] = kid;
+      workStack.emplace_back(kid, 0);
+      continue;
+    }
+    subtreeEnd[id] = static_cast<uint32>(num);
+    workStack.pop_back();
+  }
+}
+}  // namespace
+
+void FlatBBIdLists::Build(std::vector<std::pair<BBId, BBId>> &pairs) {
+  std::sort(pairs.begin(), pairs.end());
+  auto last = std::unique(pairs.begin(), pairs.end());
+  std::fill(offsets.begin(), offsets.end(), 0);
+  ids.clear();
+  ids.reserve(static_cast<size_t>(last - pairs.begin()));
+  for (auto it = pairs.begin(); it != last; ++it) {
+    ++offsets[it->first + 1];
+    ids.push_back(it->second);
+  }
+  for (size_t i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+}
+
+/* ================= for Dominance ================= */
+// iterative depth-first walk over the successors, numbering each BB once all of its successors are done
 void Dominance::PostOrderWalk(const BB &bb, int32 &pid, std::vector<bool> &visitedMap) {
   ASSERT(bb.GetBBId() < visitedMap.size(), "index out of range in Dominance::PostOrderWalk");
   if (visitedMap[bb.GetBBId()]) {
     return;
   }
   visitedMap[bb.GetBBId()] = true;
-  for (BB *suc : bb.GetSucc()) {
-    PostOrderWalk(*suc, pid, visitedMap);
+  std::vector<std::pair<const BB*, size_t>> workStack;
+  workStack.emplace_back(&bb, 0);
+  while (!workStack.empty()) {
+    const BB *cur = workStack.back().first;
+    size_t next = workStack.back().second;
+    if (next < cur->GetSucc().size()) {
+      ++workStack.back().second;
+      const BB *suc = cur->GetSucc(next);
+      ASSERT(suc->GetBBId() < visitedMap.size(), "index out of range in Dominance::PostOrderWalk");
+      if (!visitedMap[suc->GetBBId()]) {
+        visitedMap[suc->GetBBId()] = true;
+        workStack.emplace_back(suc, 0);
+      }
+      continue;
+    }
+    ASSERT(cur->GetBBId() < postOrderIDVec.size(), "index out of range in Dominance::PostOrderWalk");
+    postOrderIDVec[cur->GetBBId()] = pid++;
+    workStack.pop_back();
   }
-  ASSERT(bb.GetBBId() < postOrderIDVec.size(), "index out of range in Dominance::PostOrderWalk");
-  postOrderIDVec[bb.GetBBId()] = pid++;
-  return;
 }
 
 void Dominance::GenPostOrderID() {
@@ -105,8 +163,112 @@ void Dominance::ComputeDominance() {
   } while (changed);
 }
 
+// Semi-NCA from "Finding Dominators in Practice" by Loukas Georgiadis et al. It needs no fixpoint
+// iteration, so it is preferred for large or irreducible CFGs where ComputeDominance takes many rounds.
+// For the post-dominators the edges are reversed: the DFS goes from the common exit along preds and
+// the semidominators are taken over succs. The result is written into idoms as by the iterative
+// algorithm; BBs not reached from root are left untouched.
+void Dominance::SemiNCA(BB &root, bool isPdom, MapleVector<BB*> &idoms) {
+  // everything below is indexed by DFS preorder number; 0 stands for none and root is 1
+  std::vector<uint32> dfn(bbVec.size(), 0);
+  std::vector<BB*> vertex(1, nullptr);
+  std::vector<uint32> parent(1, 0);
+  std::vector<std::pair<BB*, size_t>> workStack;
+  dfn[root.GetBBId()] = 1;
+  vertex.push_back(&root);
+  parent.push_back(0);
+  workStack.emplace_back(&root, 0);
+  while (!workStack.empty()) {
+    BB *cur = workStack.back().first;
+    size_t next = workStack.back().second;
+    MapleVector<BB*> &forward = isPdom ? cur->GetPred() : cur->GetSucc();
+    if (next == forward.size()) {
+      workStack.pop_back();
+      continue;
+    }
+    ++workStack.back().second;
+    BB *nextBB = forward[next];
+    if (dfn[nextBB->GetBBId()] != 0 || bbVec[nextBB->GetBBId()] == nullptr) {
+      continue;
+    }
+    dfn[nextBB->GetBBId()] = static_cast<uint32>(vertex.size());
+    vertex.push_back(nextBB);
+    parent.push_back(dfn[cur->GetBBId()]);
+    workStack.emplace_back(nextBB, 0);
+  }
+  uint32 num = static_cast<uint32>(vertex.size() - 1);
+  // BBs with a virtual edge from the root, as the iterative algorithm assumes them
+  std::vector<bool> rootIsPred(num + 1, false);
+  for (BB *bb : isPdom ? root.GetPred() : root.GetSucc()) {
+    rootIsPred[dfn[bb->GetBBId()]] = true;
+  }
+  for (uint32 i = 2; i <= num; ++i) {
+    const BB *bb = vertex[i];
+    if (isPdom ? (bb->GetAttributes(kBBAttrIsExit) || bb->GetSucc().empty()) : bb->GetPred().empty()) {
+      rootIsPred[i] = true;
+    }
+  }
+  std::vector<uint32> semi(num + 1);
+  std::vector<uint32> label(num + 1);
+  std::vector<uint32> ancestor(num + 1, 0);  // forest of the vertices processed so far
+  for (uint32 i = 0; i <= num; ++i) {
+    semi[i] = i;
+    label[i] = i;
+  }
+  std::vector<uint32> path;
+  // the minimum semi on the forest path from v up to its root, compressing the path on the way
+  auto eval = [&semi, &label, &ancestor, &path](uint32 v) {
+    if (ancestor[v] == 0) {
+      return v;
+    }
+    for (uint32 u = v; ancestor[ancestor[u]] != 0; u = ancestor[u]) {
+      path.push_back(u);
+    }
+    while (!path.empty()) {
+      uint32 u = path.back();
+      path.pop_back();
+      uint32 a = ancestor[u];
+      if (semi[label[a]] < semi[label[u]]) {
+        label[u] = label[a];
+      }
+      ancestor[u] = ancestor[a];
+    }
+    return label[v];
+  };
+  for (uint32 i = num; i > 1; --i) {
+    BB *bb = vertex[i];
+    // the tree parent always bounds the semidominator
+    uint32 minSemi = rootIsPred[i] ? 1 : parent[i];
+    const MapleVector<BB*> &backward = isPdom ? bb->GetSucc() : bb->GetPred();
+    for (BB *pre : backward) {
+      uint32 v = dfn[pre->GetBBId()];
+      if (v != 0) {
+        minSemi = std::min(minSemi, semi[eval(v)]);
+      }
+    }
+    semi[i] = minSemi;
+    ancestor[i] = parent[i];
+  }
+  // the immediate dominator is the nearest common ancestor of the parent and the semidominator
+  std::vector<uint32> idom(parent);
+  for (uint32 i = 2; i <= num; ++i) {
+    uint32 j = idom[i];
+    while (j > semi[i]) {
+      j = idom[j];
+    }
+    idom[i] = j;
+    idoms[vertex[i]->GetBBId()] = vertex[j];
+  }
+  idoms[root.GetBBId()] = &root;
+}
+
+void Dominance::ComputeDominanceSemiNCA() {
+  SemiNCA(commonEntryBB, false, doms);
+}
+
 // Figure 5 in "A Simple, Fast Dominance Algorithm" by Keith Cooper et al.
 void Dominance::ComputeDomFrontiers() {
+  std::vector<std::pair<BBId, BBId>> frontierPairs;
   for (const BB *bb : bbVec) {
     if (bb == nullptr || bb == &commonExitBB) {
       continue;
@@ -117,14 +279,16 @@ void Dominance::ComputeDomFrontiers() {
     for (BB *pre : bb->GetPred()) {
       BB *runner = pre;
       while (runner != doms[bb->GetBBId()] && runner != &commonEntryBB) {
-        domFrontier[runner->GetBBId()].insert(bb->GetBBId());
+        frontierPairs.emplace_back(runner->GetBBId(), bb->GetBBId());
         runner = doms[runner->GetBBId()];
       }
     }
   }
+  domFrontier.Build(frontierPairs);
 }
 
 void Dominance::ComputeDomChildren() {
+  std::vector<std::pair<BBId, BBId>> childPairs;
   for (const BB *bb : bbVec) {
     if (bb == nullptr) {
       continue;
@@ -136,16 +300,13 @@ void Dominance::ComputeDomChildren() {
     if (parent == bb) {
       continue;
     }
-    domChildren[parent->GetBBId()].insert(bb->GetBBId());
+    childPairs.emplace_back(parent->GetBBId(), bb->GetBBId());
   }
+  domChildren.Build(childPairs);
 }
 
 void Dominance::ComputeDtPreorder(const BB &bb, size_t &num) {
-  CHECK_FATAL(num < dtPreOrder.size(), "index out of range in Dominance::ComputeDtPreorder");
-  dtPreOrder[num++] = bb.GetBBId();
-  for (BBId k : domChildren[bb.GetBBId()]) {
-    ComputeDtPreorder(*bbVec[k], num);
-  }
+  ComputeTreePreorder(domChildren, bb.GetBBId(), num, dtPreOrder, dtSubtreeEnd);
 }
 
 void Dominance::ComputeDtDfn() {
@@ -160,23 +321,17 @@ bool Dominance::Dominate(const BB &bb1, BB &bb2) {
     return true;
   }
   CHECK_FATAL(bb2.GetBBId() < doms.size(), "index out of range in Dominance::Dominate ");
-  if (doms[bb2.GetBBId()] == nullptr) {
+  if (doms[bb2.GetBBId()] == nullptr || bb1.GetBBId() >= dtDfn.size()) {
     return false;
   }
-  BB *immediateDom = &bb2;
-  do {
-    if (immediateDom == nullptr) {
-      return false;
-    }
-    immediateDom = doms[immediateDom->GetBBId()];
-    if (immediateDom == &bb1) {
-      return true;
-    }
-  } while (immediateDom != &commonEntryBB);
-  return false;
+  // bb2 must lie in the preorder interval of bb1's subtree; a BB not in the tree has dfn -1
+  uint32 dfn1 = dtDfn[bb1.GetBBId()];
+  uint32 dfn2 = dtDfn[bb2.GetBBId()];
+  return dfn1 <= dfn2 && dfn2 < dtSubtreeEnd[bb1.GetBBId()];
 }
 
 /* ================= for PostDominance ================= */
+// iterative depth-first walk over the predecessors, skipping BBs that have been deleted from bbVec
 void Dominance::PdomPostOrderWalk(BB &bb, int32 &pid, std::vector<bool> &visitedMap) {
   ASSERT(bb.GetBBId() < visitedMap.size(), "index out of range in  Dominance::PdomPostOrderWalk");
   if (bbVec[bb.GetBBId()] == nullptr) {
@@ -186,12 +341,25 @@ void Dominance::PdomPostOrderWalk(BB &bb, int32 &pid, std::vector<bool> &visited
     return;
   }
   visitedMap[bb.GetBBId()] = true;
-  for (BB *pre : bb.GetPred()) {
-    PdomPostOrderWalk(*pre, pid, visitedMap);
+  std::vector<std::pair<const BB*, size_t>> workStack;
+  workStack.emplace_back(&bb, 0);
+  while (!workStack.empty()) {
+    const BB *cur = workStack.back().first;
+    size_t next = workStack.back().second;
+    if (next < cur->GetPred().size()) {
+      ++workStack.back().second;
+      const BB *pre = cur->GetPred(next);
+      ASSERT(pre->GetBBId() < visitedMap.size(), "index out of range in  Dominance::PdomPostOrderWalk");
+      if (bbVec[pre->GetBBId()] != nullptr && !visitedMap[pre->GetBBId()]) {
+        visitedMap[pre->GetBBId()] = true;
+        workStack.emplace_back(pre, 0);
+      }
+      continue;
+    }
+    CHECK_FATAL(cur->GetBBId() < pdomPostOrderIDVec.size(), "index out of range in  Dominance::PdomPostOrderWalk");
+    pdomPostOrderIDVec[cur->GetBBId()] = pid++;
+    workStack.pop_back();
   }
-  CHECK_FATAL(bb.GetBBId() < pdomPostOrderIDVec.size(), "index out of range in  Dominance::PdomPostOrderWalk");
-  pdomPostOrderIDVec[bb.GetBBId()] = pid++;
-  return;
 }
 
 void Dominance::PdomGenPostOrderID() {
@@ -263,8 +431,13 @@ void Dominance::ComputePostDominance() {
   } while (changed);
 }
 
+void Dominance::ComputePostDominanceSemiNCA() {
+  SemiNCA(commonExitBB, true, pdoms);
+}
+
 // Figure 5 in "A Simple, Fast Dominance Algorithm" by Keith Cooper et al.
 void Dominance::ComputePdomFrontiers() {
+  std::vector<std::pair<BBId, BBId>> frontierPairs;
   for (const BB *bb : bbVec) {
     if (bb == nullptr || bb == &commonEntryBB) {
       continue;
@@ -275,15 +448,17 @@ void Dominance::ComputePdomFrontiers() {
     for (BB *suc : bb->GetSucc()) {
       BB *runner = suc;
       while (runner != pdoms[bb->GetBBId()] && runner != &commonEntryBB) {
-        pdomFrontier[runner->GetBBId()].insert(bb->GetBBId());
+        frontierPairs.emplace_back(runner->GetBBId(), bb->GetBBId());
         ASSERT(pdoms[runner->GetBBId()] != nullptr, "ComputePdomFrontiers: pdoms[] is nullptr");
         runner = pdoms[runner->GetBBId()];
       }
     }
   }
+  pdomFrontier.Build(frontierPairs);
 }
 
 void Dominance::ComputePdomChildren() {
+  std::vector<std::pair<BBId, BBId>> childPairs;
   for (const BB *bb : bbVec) {
     if (bb == nullptr || pdoms[bb->GetBBId()] == nullptr) {
       continue;
@@ -292,16 +467,13 @@ void Dominance::ComputePdomChildren() {
     if (parent == bb) {
       continue;
     }
-    pdomChildren[parent->GetBBId()].insert(bb->GetBBId());
+    childPairs.emplace_back(parent->GetBBId(), bb->GetBBId());
   }
+  pdomChildren.Build(childPairs);
 }
 
 void Dominance::ComputePdtPreorder(const BB &bb, size_t &num) {
-  ASSERT(num < pdtPreOrder.size(), "index out of range in Dominance::ComputePdtPreOrder");
-  pdtPreOrder[num++] = bb.GetBBId();
-  for (BBId k : pdomChildren[bb.GetBBId()]) {
-    ComputePdtPreorder(*bbVec[k], num);
-  }
+  ComputeTreePreorder(pdomChildren, bb.GetBBId(), num, pdtPreOrder, pdtSubtreeEnd);
 }
 
 void Dominance::ComputePdtDfn() {
@@ -316,20 +488,12 @@ bool Dominance::PostDominate(const BB &bb1, BB &bb2) {
     return true;
   }
   CHECK_FATAL(bb2.GetBBId() < pdoms.size(), "index out of range in Dominance::PostDominate");
-  if (pdoms[bb2.GetBBId()] == nullptr) {
+  if (pdoms[bb2.GetBBId()] == nullptr || bb1.GetBBId() >= pdtDfn.size()) {
     return false;
   }
-  BB *impdom = &bb2;
-  do {
-    if (impdom == nullptr) {
-      return false;
-    }
-    impdom = pdoms[impdom->GetBBId()];
-    if (impdom == &bb1) {
-      return true;
-    }
-  } while (impdom != &commonExitBB);
-  return false;
+  uint32 dfn1 = pdtDfn[bb1.GetBBId()];
+  uint32 dfn2 = pdtDfn[bb2.GetBBId()];
+  return dfn1 <= dfn2 && dfn2 < pdtSubtreeEnd[bb1.GetBBId()];
 }
 
 void Dominance::DumpDoms() {
@@ -42,7 +42,7 @@ void IRMap::BuildBB(BB &bb, std::vector<bool> &bbIRMapProcessed) {
   }
   // travesal bb's dominated tree
   ASSERT(bbid < dom.GetDomChildrenSize(), " index out of range in IRMap::BuildBB");
-  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bbid);
+  BBIdRange domChildren = dom.GetDomChildren(bbid);
   for (auto bbit = domChildren.begin(); bbit != domChildren.end(); ++bbit) {
     BBId childbbid = *bbit;
     BuildBB(*GetBB(childbbid), bbIRMapProcessed);
@@ -318,7 +318,7 @@ IvarMeExpr *IRMap::BuildLHSIvar(MeExpr &baseAddr, IassignMeStmt &iassignMeStmt,
   medef->SetDefStmt(&iassignMeStmt);
   medef->SetOp(OP_iread);
   medef->SetPtyp(iassignMeStmt.GetRHS()->GetPrimType());
-  PutToBucket(medef->GetHashIndex() % mapHashLength, *medef);
+  PutToBucket(medef->GetHashIndex(), *medef);
   return medef;
 }
 
@@ -609,18 +609,65 @@ void IRMap::SetMeExprOpnds(MeExpr &meExpr, BaseNode &mirNode) {
   }
 }
 
-void IRMap::PutToBucket(uint32 hashidx, MeExpr &meExpr) {
-  MeExpr *headexpr = hashTable[hashidx];
-  if (headexpr != nullptr) {
-    meExpr.SetNext(headexpr);
+uint32 IRMap::HashTableSizeLog2(uint32 minSize) {
+  constexpr uint32 kMinHashTableSizeLog2 = 6;
+  uint32 log2 = kMinHashTableSizeLog2;
+  while (log2 < kHashIndexBits - 1 && (1u << log2) < minSize) {
+    ++log2;
   }
-  hashTable[hashidx] = &meExpr;
+  return log2;
+}
+
+// Find the slot holding hashIdx, or the empty slot where it belongs. The hash indexes of MeExprs are mostly
+// small ids shifted left, so they are scattered by Fibonacci hashing before taking the top bits.
+IRMap::HashSlot &IRMap::FindHashSlot(uint32 hashIdx) {
+  constexpr uint32 kFibonacciHashMultiplier = 0x9E3779B9;
+  size_t mask = hashTable.size() - 1;
+  size_t pos = static_cast<uint32>(hashIdx * kFibonacciHashMultiplier) >> hashTableShift;
+  uint32 probes = 1;
+  while (hashTable[pos].head != nullptr && hashTable[pos].hashIdx != hashIdx) {
+    pos = (pos + 1) & mask;
+    ++probes;
+  }
+  ++hashLookups;
+  hashProbes += probes;
+  maxHashProbes = std::max(maxHashProbes, probes);
+  return hashTable[pos];
+}
+
+// double the table; the chains move along with their heads
+void IRMap::GrowHashTable() {
+  CHECK_FATAL(hashTableShift > 1, "value number hash table too large");
+  MapleVector<HashSlot> oldTable(irMapAlloc.Adapter());
+  oldTable.swap(hashTable);
+  hashTable.assign(oldTable.size() * 2, HashSlot());
+  --hashTableShift;
+  for (const HashSlot &slot : oldTable) {
+    if (slot.head != nullptr) {
+      FindHashSlot(slot.hashIdx) = slot;
+    }
+  }
+}
+
+void IRMap::PutToBucket(uint32 hashIdx, MeExpr &meExpr) {
+  HashSlot *slot = &FindHashSlot(hashIdx);
+  if (slot->head == nullptr) {
+    if ((hashTableUsed + 1) * 4 > hashTable.size() * 3) {
+      GrowHashTable();
+      slot = &FindHashSlot(hashIdx);
+    }
+    ++hashTableUsed;
+    slot->hashIdx = hashIdx;
+  } else {
+    meExpr.SetNext(slot->head);
+  }
+  slot->head = &meExpr;
 }
 
 MeExpr *IRMap::HashMeExpr(MeExpr &meExpr) {
   MeExpr *resultExpr = nullptr;
-  uint32 hidx = meExpr.GetHashIndex() % mapHashLength;
-  MeExpr *hashedExpr = hashTable[hidx];
+  uint32 hashIdx = meExpr.GetHashIndex();
+  MeExpr *hashedExpr = FindHashSlot(hashIdx).head;
 
   if (hashedExpr != nullptr && meExpr.GetMeOp() != kMeOpGcmalloc) {
     resultExpr = meExpr.GetIdenticalExpr(*hashedExpr);
@@ -629,13 +676,31 @@ MeExpr *IRMap::HashMeExpr(MeExpr &meExpr) {
   if (resultExpr == nullptr) {
     resultExpr = meBuilder.CreateMeExpr(exprID++, meExpr);
     if (resultExpr != nullptr) {
-      PutToBucket(hidx, *resultExpr);
+      PutToBucket(hashIdx, *resultExpr);
     }
   }
 
   return resultExpr;
 }
 
+// return the hashed expr identical to meExpr without entering meExpr into the table
+MeExpr *IRMap::FindHashedMeExpr(MeExpr &meExpr) {
+  if (meExpr.GetMeOp() == kMeOpGcmalloc) {
+    return nullptr;
+  }
+  MeExpr *hashedExpr = FindHashSlot(meExpr.GetHashIndex()).head;
+  return hashedExpr == nullptr ? nullptr : meExpr.GetIdenticalExpr(*hashedExpr);
+}
+
+void IRMap::DumpHashTableStats() const {
+  LogInfo::MapleLogger() << "value number table: " << hashTableUsed << " of " << hashTable.size()
+                         << " slots used, " << hashLookups << " lookups, ";
+  if (hashLookups != 0) {
+    LogInfo::MapleLogger() << "average probe length " << (static_cast<double>(hashProbes) / hashLookups) << ", ";
+  }
+  LogInfo::MapleLogger() << "max probe length " << maxHashProbes << '\n';
+}
+
 MeExpr *IRMap::ReplaceMeExprExpr(MeExpr &origExpr, MeExpr &newExpr, size_t opndsSize, MeExpr &meExpr, MeExpr &repExpr) {
   bool needRehash = false;
 
@@ -698,6 +763,60 @@ MeExpr *IRMap::ReplaceMeExprExpr(MeExpr &origExpr, MeExpr &meExpr, MeExpr &repEx
   }
 }
 
+MeExpr *IRMap::RewriteOpnds(MeExpr &meExpr, const std::function<MeExpr*(MeExpr&, size_t)> &rewriteOpnd) {
+  switch (meExpr.GetMeOp()) {
+    case kMeOpOp: {
+      auto &opExpr = static_cast<OpMeExpr&>(meExpr);
+      OpMeExpr newExpr(opExpr, kInvalidExprID);
+      bool changed = false;
+      for (size_t i = 0; i < kOperandNumTernary; ++i) {
+        MeExpr *opnd = opExpr.GetOpnd(i);
+        if (opnd == nullptr) {
+          continue;
+        }
+        MeExpr *newOpnd = rewriteOpnd(*opnd, i);
+        if (newOpnd != opnd) {
+          newExpr.SetOpnd(i, newOpnd);
+          changed = true;
+        }
+      }
+      return changed ? HashMeExpr(newExpr) : &meExpr;
+    }
+    case kMeOpIvar: {
+      auto &ivarExpr = static_cast<IvarMeExpr&>(meExpr);
+      MeExpr *newBase = rewriteOpnd(*ivarExpr.GetBase(), 0);
+      if (newBase == ivarExpr.GetBase()) {
+        return &meExpr;
+      }
+      IvarMeExpr newExpr(kInvalidExprID, ivarExpr);
+      newExpr.SetBase(newBase);
+      return HashMeExpr(newExpr);
+    }
+    case kMeOpNary: {
+      auto &naryExpr = static_cast<NaryMeExpr&>(meExpr);
+      // the copy of a nary allocates its operand vector, so it is only made once an operand changes
+      std::vector<MeExpr*> newOpnds;
+      bool changed = false;
+      for (size_t i = 0; i < naryExpr.GetOpnds().size(); ++i) {
+        MeExpr *opnd = naryExpr.GetOpnd(i);
+        MeExpr *newOpnd = rewriteOpnd(*opnd, i);
+        changed = changed || newOpnd != opnd;
+        newOpnds.push_back(newOpnd);
+      }
+      if (!changed) {
+        return &meExpr;
+      }
+      NaryMeExpr newExpr(&irMapAlloc, kInvalidExprID, naryExpr);
+      for (size_t i = 0; i < newOpnds.size(); ++i) {
+        newExpr.SetOpnd(i, newOpnds[i]);
+      }
+      return HashMeExpr(newExpr);
+    }
+    default:
+      return &meExpr;
+  }
+}
+
 bool IRMap::ReplaceMeExprStmtOpnd(uint32 opndID, MeStmt &meStmt, MeExpr &meExpr, MeExpr &repExpr) {
   MeExpr *opnd = meStmt.GetOpnd(opndID);
 
@@ -801,8 +920,8 @@ MeExpr *IRMap::CreateConstMeExpr(PrimType ptyp, MIRConst &mirConst) {
 }
 
 MeExpr *IRMap::CreateIntConstMeExpr(int64 value, PrimType ptyp) {
-  MIRIntConst *intConst =
-      mirModule.GetMemPool()->New<MIRIntConst>(value, *GlobalTables::GetTypeTable().GetPrimType(ptyp));
+  MIRIntConst *intConst = mirModule.CurFunction()->GetDataMemPool()->New<MIRIntConst>(
+      value, *GlobalTables::GetTypeTable().GetPrimType(ptyp));
   return CreateConstMeExpr(ptyp, *intConst);
 }
 
@@ -0,0 +1,390 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_bce.h"
+#include "me_option.h"
+
+// The bound of an index incremented by one is what keeps the increment from overflowing.
+namespace maple {
+namespace {
+// bounds the search through phis and assignments for the proof that an index is not negative
+constexpr uint32 kMaxNonNegativeDepth = 8;
+
+bool GetIntConst(MeExpr &expr, int64 &val) {
+  if (expr.GetMeOp() != kMeOpConst) {
+    return false;
+  }
+  MIRConst *mirConst = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  if (mirConst->GetKind() != kConstInt) {
+    return false;
+  }
+  val = static_cast<MIRIntConst*>(mirConst)->GetValue();
+  return true;
+}
+
+// true if the array expression indexes a java array with a single i32 index
+bool IsJavaArrayAccess(const NaryMeExpr &arrayExpr) {
+  if (arrayExpr.GetOpnds().size() != 2 || arrayExpr.GetOpnds()[1]->GetPrimType() != PTY_i32) {
+    return false;
+  }
+  MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(arrayExpr.GetTyIdx());
+  if (type == nullptr || type->GetKind() != kTypePointer) {
+    return false;
+  }
+  MIRType *pointedType = static_cast<MIRPtrType*>(type)->GetPointedType();
+  return pointedType != nullptr && pointedType->GetKind() == kTypeJArray;
+}
+}  // namespace
+
+// the length of an array allocated with a constant length
+bool MeBCE::GetConstLength(MeExpr &array, int64 &length) const {
+  MeExpr *rhs = GetDefRHS(*ResolveCopies(array));
+  if (rhs == nullptr || (rhs->GetOp() != OP_gcmallocjarray && rhs->GetOp() != OP_gcpermallocjarray)) {
+    return false;
+  }
+  return GetIntConst(*static_cast<OpMeExpr*>(rhs)->GetOpnd(0), length) && length >= 0;
+}
+
+bool MeBCE::IsLengthOf(MeExpr &expr, MeExpr &array) const {
+  MeExpr *length = ResolveCopies(expr);
+  MeExpr *rhs = GetDefRHS(*length);
+  if (rhs != nullptr) {
+    length = rhs;
+  }
+  if (length->GetMeOp() != kMeOpNary || length->GetOp() != OP_intrinsicop) {
+    return false;
+  }
+  auto *lengthExpr = static_cast<NaryMeExpr*>(length);
+  return lengthExpr->GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH && lengthExpr->GetOpnds().size() == 1 &&
+         ResolveCopies(*lengthExpr->GetOpnds()[0]) == ResolveCopies(array);
+}
+
+// the relation between the operands of cond, a signed compare known to evaluate to holds
+void MeBCE::AddRelation(MeExpr &cond, bool holds, std::vector<Relation> &relations) const {
+  Opcode op = cond.GetOp();
+  if (cond.GetMeOp() != kMeOpOp || (op != OP_lt && op != OP_le && op != OP_gt && op != OP_ge) ||
+      static_cast<OpMeExpr&>(cond).GetOpndType() != PTY_i32) {
+    return;
+  }
+  auto &cmpExpr = static_cast<OpMeExpr&>(cond);
+  bool swapped = op == OP_gt || op == OP_ge;
+  bool strict = op == OP_lt || op == OP_gt;
+  MeExpr *smaller = swapped ? cmpExpr.GetOpnd(1) : cmpExpr.GetOpnd(0);
+  MeExpr *larger = swapped ? cmpExpr.GetOpnd(0) : cmpExpr.GetOpnd(1);
+  if (holds) {
+    relations.push_back(Relation{ smaller, larger, strict });
+  } else {
+    relations.push_back(Relation{ larger, smaller, !strict });
+  }
+}
+
+// the relations established by the branches whose edges dominate bb
+void MeBCE::CollectRelations(const BB &bb, std::vector<Relation> &relations) const {
+  std::vector<BranchCond> conds;
+  CollectBranchConds(bb, conds);
+  for (const BranchCond &branchCond : conds) {
+    AddRelation(*branchCond.cond, branchCond.holds, relations);
+  }
+}
+
+// true if expr is known to be below some other value at bb, so adding 1 to it does not overflow
+bool MeBCE::IsBelowSome(MeExpr &expr, const BB &bb) const {
+  std::vector<Relation> relations;
+  CollectRelations(bb, relations);
+  MeExpr *resolved = ResolveCopies(expr);
+  for (const Relation &relation : relations) {
+    if (relation.strict && ResolveCopies(*relation.smaller) == resolved) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if the value of expr, used or computed at bb, is known to be at least 0
+bool MeBCE::IsNonNegative(MeExpr &expr, const BB &bb, uint32 depth) {
+  int64 val = 0;
+  if (GetIntConst(expr, val)) {
+    return val >= 0;
+  }
+  if (depth > kMaxNonNegativeDepth) {
+    return false;
+  }
+  MeExpr *resolved = ResolveCopies(expr);
+  std::vector<Relation> relations;
+  CollectRelations(bb, relations);
+  for (const Relation &relation : relations) {
+    if (ResolveCopies(*relation.larger) == resolved && GetIntConst(*relation.smaller, val) &&
+        (relation.strict ? val >= -1 : val >= 0)) {
+      return true;
+    }
+  }
+  switch (resolved->GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg: {
+      bool isVar = resolved->GetMeOp() == kMeOpVar;
+      MeDefBy defBy = isVar ? static_cast<VarMeExpr*>(resolved)->GetDefBy()
+                            : static_cast<RegMeExpr*>(resolved)->GetDefBy();
+      if (defBy == kDefByPhi) {
+        // an induction variable: assume the phi is not negative, and check it stays so
+        if (phisInProgress.find(resolved) != phisInProgress.end()) {
+          return true;
+        }
+        std::vector<MeExpr*> opnds;
+        BB *phiBB = nullptr;
+        if (isVar) {
+          MeVarPhiNode &phi = static_cast<VarMeExpr*>(resolved)->GetDefPhi();
+          opnds.assign(phi.GetOpnds().begin(), phi.GetOpnds().end());
+          phiBB = phi.GetDefBB();
+        } else {
+          MeRegPhiNode &phi = static_cast<RegMeExpr*>(resolved)->GetDefPhi();
+          opnds.assign(phi.GetOpnds().begin(), phi.GetOpnds().end());
+          phiBB = phi.GetDefBB();
+        }
+        phisInProgress.insert(resolved);
+        bool result = phiBB != nullptr && phiBB->GetPred().size() == opnds.size();
+        for (size_t i = 0; result && i < opnds.size(); ++i) {
+          result = IsNonNegative(*opnds[i], *phiBB->GetPred(i), depth + 1);
+        }
+        phisInProgress.erase(resolved);
+        return result;
+      }
+      MeExpr *rhs = GetDefRHS(*resolved);
+      if (rhs == nullptr) {
+        return false;
+      }
+      MeStmt *defStmt = isVar ? static_cast<VarMeExpr*>(resolved)->GetDefStmt()
+                              : static_cast<RegMeExpr*>(resolved)->GetDefStmt();
+      return IsNonNegative(*rhs, *defStmt->GetBB(), depth + 1);
+    }
+    case kMeOpOp: {
+      auto *opExpr = static_cast<OpMeExpr*>(resolved);
+      if (opExpr->GetPrimType() != PTY_i32) {
+        return false;
+      }
+      if (opExpr->GetOp() == OP_band) {
+        return IsNonNegative(*opExpr->GetOpnd(0), bb, depth + 1) || IsNonNegative(*opExpr->GetOpnd(1), bb, depth + 1);
+      }
+      if (opExpr->GetOp() != OP_add) {
+        return false;
+      }
+      MeExpr *base = opExpr->GetOpnd(0);
+      if (!GetIntConst(*opExpr->GetOpnd(1), val)) {
+        base = opExpr->GetOpnd(1);
+        if (!GetIntConst(*opExpr->GetOpnd(0), val)) {
+          return false;
+        }
+      }
+      return (val == 0 || (val == 1 && IsBelowSome(*base, bb))) && IsNonNegative(*base, bb, depth + 1);
+    }
+    case kMeOpNary:
+      return resolved->GetOp() == OP_intrinsicop &&
+             static_cast<NaryMeExpr*>(resolved)->GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH;
+    default:
+      return false;
+  }
+}
+
+// true if a dominating branch compares index below the length of array
+bool MeBCE::IsBelowLength(MeExpr &index, MeExpr &array, const BB &bb) const {
+  std::vector<Relation> relations;
+  CollectRelations(bb, relations);
+  MeExpr *resolved = ResolveCopies(index);
+  int64 length = 0;
+  bool isConstLength = GetConstLength(array, length);
+  for (const Relation &relation : relations) {
+    if (!relation.strict || ResolveCopies(*relation.smaller) != resolved) {
+      continue;
+    }
+    int64 bound = 0;
+    if (IsLengthOf(*relation.larger, array) ||
+        (isConstLength && GetIntConst(*relation.larger, bound) && bound <= length)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if a dominating access of array, or of any array if it is nullptr, has checked index or a
+// larger constant index
+bool MeBCE::IsCheckedBefore(MeExpr *array, MeExpr &index, const BB &bb) const {
+  MeExpr *resolvedArray = array == nullptr ? nullptr : ResolveCopies(*array);
+  MeExpr *resolvedIndex = ResolveCopies(index);
+  int64 indexVal = 0;
+  bool isConstIndex = GetIntConst(index, indexVal) && indexVal >= 0;
+  for (const CheckedAccess &checked : checkedAccesses) {
+    if (!HoldsAt(checked.bb, checked.inTry, bb)) {
+      continue;
+    }
+    if (resolvedArray != nullptr && checked.array != resolvedArray) {
+      continue;
+    }
+    int64 checkedVal = 0;
+    if (checked.index == resolvedIndex ||
+        (isConstIndex && GetIntConst(*checked.index, checkedVal) && checkedVal >= indexVal)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MeBCE::IsInBounds(MeExpr &array, MeExpr &index, const BB &bb) {
+  int64 indexVal = 0;
+  if (GetIntConst(index, indexVal)) {
+    int64 length = 0;
+    if (indexVal < 0) {
+      return false;
+    }
+    if (GetConstLength(array, length) && indexVal < length) {
+      return true;
+    }
+  }
+  if (IsCheckedBefore(&array, index, bb)) {
+    return true;
+  }
+  return (IsCheckedBefore(nullptr, index, bb) || IsNonNegative(index, bb, 0)) && IsBelowLength(index, array, bb);
+}
+
+// return what replaces expr in a stmt of bb; the accesses checked by expr are added to newChecks
+// unless expr is not always evaluated
+MeExpr *MeBCE::VisitExpr(MeExpr &expr, const BB &bb, std::vector<CheckedAccess> &newChecks, bool conditional) {
+  Opcode op = expr.GetOp();
+  MeExpr *result = irMap.RewriteOpnds(expr, [this, &bb, &newChecks, conditional, op](MeExpr &opnd, size_t opndIdx) {
+    // the second operand of cand/cior and the choices of select are not always evaluated
+    bool condOpnd =
+        conditional || ((op == OP_cand || op == OP_cior) && opndIdx == 1) || (op == OP_select && opndIdx > 0);
+    return VisitExpr(opnd, bb, newChecks, condOpnd);
+  });
+  if (result->GetMeOp() != kMeOpNary) {
+    return result;
+  }
+  auto &naryExpr = static_cast<NaryMeExpr&>(*result);
+  if (naryExpr.GetOp() != OP_array || !naryExpr.GetBoundCheck() || !IsJavaArrayAccess(naryExpr)) {
+    return result;
+  }
+  if (!IsInBounds(*naryExpr.GetOpnd(0), *naryExpr.GetOpnd(1), bb)) {
+    ++numChecksKept;
+    if (!conditional) {
+      newChecks.push_back(CheckedAccess{ naryExpr.GetOpnd(0), naryExpr.GetOpnd(1), nullptr, false });
+    }
+    return result;
+  }
+  ++numChecksRemoved;
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "bce: remove bounds check of mx" << expr.GetExprID() << " in BB " << bb.GetBBId()
+                           << '\n';
+  }
+  NaryMeExpr newExpr(&irMap.GetIRMapAlloc(), kInvalidExprID, naryExpr);
+  newExpr.SetBoundCheck(false);
+  return irMap.HashMeExpr(newExpr);
+}
+
+// Handle the MPL_BOUNDARY_CHECK intrinsic call that throws if (ge u1 u32 (index, length of
+// array)) holds, as inserted when array accesses are expanded; return false if stmt is not one.
+bool MeBCE::VisitBoundaryCheck(MeStmt &stmt) {
+  if (stmt.GetOp() != OP_intrinsiccall ||
+      static_cast<IntrinsiccallMeStmt&>(stmt).GetIntrinsic() != INTRN_MPL_BOUNDARY_CHECK ||
+      stmt.NumMeStmtOpnds() != 1) {
+    return false;
+  }
+  MeExpr *cond = stmt.GetOpnd(0);
+  if (cond->GetMeOp() != kMeOpOp || cond->GetOp() != OP_ge ||
+      static_cast<OpMeExpr*>(cond)->GetOpndType() != PTY_u32) {
+    return false;
+  }
+  MeExpr *index = static_cast<OpMeExpr*>(cond)->GetOpnd(0);
+  MeExpr *length = static_cast<OpMeExpr*>(cond)->GetOpnd(1);
+  if (index->GetPrimType() != PTY_i32 || length->GetMeOp() != kMeOpNary || length->GetOp() != OP_intrinsicop ||
+      static_cast<NaryMeExpr*>(length)->GetIntrinsic() != INTRN_JAVA_ARRAY_LENGTH ||
+      static_cast<NaryMeExpr*>(length)->GetOpnds().size() != 1) {
+    return false;
+  }
+  MeExpr *array = static_cast<NaryMeExpr*>(length)->GetOpnds()[0];
+  BB &bb = *stmt.GetBB();
+  if (IsInBounds(*array, *index, bb)) {
+    ++numChecksRemoved;
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "bce: remove boundary check in BB " << bb.GetBBId() << '\n';
+    }
+    bb.RemoveMeStmt(&stmt);
+    return true;
+  }
+  ++numChecksKept;
+  checkedAccesses.push_back(
+      CheckedAccess{ ResolveCopies(*array), ResolveCopies(*index), &bb, bb.GetAttributes(kBBAttrIsTry) });
+  return true;
+}
+
+void MeBCE::VisitStmt(MeStmt &stmt) {
+  if (VisitBoundaryCheck(stmt)) {
+    return;
+  }
+  BB &bb = *stmt.GetBB();
+  std::vector<CheckedAccess> newChecks;
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd == nullptr) {
+      continue;
+    }
+    MeExpr *newOpnd = VisitExpr(*opnd, bb, newChecks, false);
+    if (newOpnd == opnd) {
+      continue;
+    }
+    stmt.SetOpnd(i, newOpnd);
+    if (i == 0 && stmt.GetOp() == OP_iassign) {
+      auto &iassign = static_cast<IassignMeStmt&>(stmt);
+      iassign.SetLHSVal(irMap.BuildLHSIvarFromIassMeStmt(iassign));
+    }
+  }
+  // the accesses of stmt are checked for the stmts it dominates
+  for (const CheckedAccess &checked : newChecks) {
+    checkedAccesses.push_back(CheckedAccess{ ResolveCopies(*checked.array), ResolveCopies(*checked.index), &bb,
+                                             bb.GetAttributes(kBBAttrIsTry) });
+  }
+}
+
+void MeBCE::VisitBB(BB &bb) {
+  auto &meStmts = bb.GetMeStmts();
+  for (auto it = meStmts.begin(); it != meStmts.end();) {
+    MeStmt &stmt = *it;
+    ++it;
+    VisitStmt(stmt);
+  }
+}
+
+void MeBCE::Run() {
+  MarkReachableFromHandlers();
+  WalkDomTree();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "bce of " << func.GetName() << ": " << numChecksRemoved << " bounds checks removed, "
+                           << numChecksKept << " kept\n";
+  }
+}
+
+AnalysisResult *MeDoBCE::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeBCE bce(*func, *dom, DEBUGFUNC(func));
+  bce.Run();
+  if (DEBUGFUNC(func)) {
+    func->GetIRMap()->Dump();
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_clinit_opt.h"
+#include "me_option.h"
+
+// Checks are not hoisted out of loops: the initializer of a class runs at the first check of
+// the class, and running it before the statements that precede the check in the loop, or when
+// the loop is not entered at all, is visible to the program.
+namespace maple {
+// true if a check of the class tyIdx is known to succeed at the stmt of bb being visited
+bool MeClinitOpt::IsInitialized(TyIdx tyIdx, const BB &bb) const {
+  Klass *klass = klassHierarchy.GetKlassFromTyIdx(tyIdx);
+  for (const CheckedClass &checked : checkedClasses) {
+    if (!HoldsAt(checked.bb, checked.inTry, bb)) {
+      continue;
+    }
+    if (checked.tyIdx == tyIdx || (klass != nullptr && klassHierarchy.IsSuperKlass(klass, checked.klass))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MeClinitOpt::VisitBB(BB &bb) {
+  bool inTry = bb.GetAttributes(kBBAttrIsTry);
+  auto &meStmts = bb.GetMeStmts();
+  for (auto it = meStmts.begin(); it != meStmts.end();) {
+    MeStmt &stmt = *it;
+    ++it;
+    if (stmt.GetOp() != OP_intrinsiccallwithtype ||
+        static_cast<IntrinsiccallMeStmt&>(stmt).GetIntrinsic() != INTRN_JAVA_CLINIT_CHECK) {
+      continue;
+    }
+    TyIdx tyIdx = static_cast<IntrinsiccallMeStmt&>(stmt).GetTyIdx();
+    if (IsInitialized(tyIdx, bb)) {
+      if (enabledDebug) {
+        LogInfo::MapleLogger() << "clinitopt: remove check of "
+                               << GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyIdx)->GetName() << " in BB "
+                               << bb.GetBBId() << '\n';
+      }
+      bb.RemoveMeStmt(&stmt);
+      ++numChecksRemoved;
+      continue;
+    }
+    checkedClasses.push_back(CheckedClass{ tyIdx, klassHierarchy.GetKlassFromTyIdx(tyIdx), &bb, inTry });
+  }
+}
+
+void MeClinitOpt::Run() {
+  MIRFunction *mirFunc = func.GetMirFunc();
+  Klass *selfKlass = klassHierarchy.GetKlassFromTyIdx(mirFunc->GetClassTyIdx());
+  if (selfKlass != nullptr && (!mirFunc->IsStatic() || mirFunc == selfKlass->GetClinit())) {
+    checkedClasses.push_back(CheckedClass{ mirFunc->GetClassTyIdx(), selfKlass, nullptr, false });
+  }
+  MarkReachableFromHandlers();
+  WalkDomTree();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "clinitopt of " << func.GetName() << ": " << numChecksRemoved
+                           << " class init checks removed\n";
+  }
+}
+
+AnalysisResult *MeDoClinitOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *kh = static_cast<KlassHierarchy*>(moduleResMgr->GetAnalysisResult(MoPhase_CHA, &func->GetMIRModule()));
+  ASSERT(kh != nullptr, "KlassHierarchy has problem");
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeClinitOpt clinitOpt(*func, *dom, *kh, DEBUGFUNC(func));
+  clinitOpt.Run();
+  return nullptr;
+}
+}  // namespace maple
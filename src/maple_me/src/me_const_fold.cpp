@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_const_fold.h"
+#include <cmath>
+
+// Integer constants are computed in uint64 and then cut down to the width of the result type,
+// so that overflow wraps around as it does in Java and no signed overflow happens in the
+// compiler itself. Float constants are computed in the precision of their type.
+namespace maple {
+namespace {
+constexpr uint32 kMaxIntBitSize = 64;
+
+int64 SignExtend(uint64 val, uint32 bitSize) {
+  if (bitSize == 0 || bitSize >= kMaxIntBitSize) {
+    return static_cast<int64>(val);
+  }
+  uint64 mask = (1ULL << bitSize) - 1;
+  val &= mask;
+  if (((val >> (bitSize - 1)) & 1) != 0) {
+    val |= ~mask;
+  }
+  return static_cast<int64>(val);
+}
+
+uint64 ZeroExtend(uint64 val, uint32 bitSize) {
+  if (bitSize == 0 || bitSize >= kMaxIntBitSize) {
+    return val;
+  }
+  return val & ((1ULL << bitSize) - 1);
+}
+
+// the value of the low bits of val that fit primType, extended according to its signedness
+int64 NormalizeInt(uint64 val, PrimType primType) {
+  uint32 bitSize = GetPrimTypeBitSize(primType);
+  if (IsSignedInteger(primType)) {
+    return SignExtend(val, bitSize);
+  }
+  return static_cast<int64>(ZeroExtend(val, bitSize));
+}
+
+bool IsFoldableInt(PrimType primType) {
+  return IsPrimitivePureScalar(primType) && GetPrimTypeSize(primType) != 0;
+}
+
+bool IsFoldableFloat(PrimType primType) {
+  return primType == PTY_f32 || primType == PTY_f64;
+}
+
+bool GetIntConstValue(MeExpr &expr, int64 &val) {
+  MIRConst *mirConst = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  if (mirConst->GetKind() != kConstInt) {
+    return false;
+  }
+  val = static_cast<MIRIntConst*>(mirConst)->GetValue();
+  return true;
+}
+
+bool GetFloatConstValue(MeExpr &expr, double &val) {
+  MIRConst *mirConst = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  if (mirConst->GetKind() == kConstFloatConst) {
+    val = static_cast<MIRFloatConst*>(mirConst)->GetValue();
+    return true;
+  }
+  if (mirConst->GetKind() == kConstDoubleConst) {
+    val = static_cast<MIRDoubleConst*>(mirConst)->GetValue();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+bool EvalFloatUnary(Opcode op, T val, T &res) {
+  switch (op) {
+    case OP_neg:
+      res = -val;
+      return true;
+    case OP_abs:
+      res = std::fabs(val);
+      return true;
+    case OP_sqrt:
+      res = std::sqrt(val);
+      return true;
+    case OP_recip:
+      res = static_cast<T>(1) / val;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// max and min are not folded: which operand wins for NaN and signed zeros is up to the target
+template <typename T>
+bool EvalFloatBinary(Opcode op, T val0, T val1, T &res) {
+  switch (op) {
+    case OP_add:
+      res = val0 + val1;
+      return true;
+    case OP_sub:
+      res = val0 - val1;
+      return true;
+    case OP_mul:
+      res = val0 * val1;
+      return true;
+    case OP_div:
+      res = val0 / val1;
+      return true;
+    case OP_rem:
+      res = std::fmod(val0, val1);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// -1, 0 or 1 as val0 is less than, equal to or greater than val1
+template <typename T>
+int64 ThreeWayCompare(T val0, T val1) {
+  if (val0 < val1) {
+    return -1;
+  }
+  return val0 == val1 ? 0 : 1;
+}
+
+bool CompareResultToBool(Opcode op, int64 cmpRes, bool &res) {
+  switch (op) {
+    case OP_eq:
+      res = cmpRes == 0;
+      return true;
+    case OP_ne:
+      res = cmpRes != 0;
+      return true;
+    case OP_lt:
+      res = cmpRes < 0;
+      return true;
+    case OP_le:
+      res = cmpRes <= 0;
+      return true;
+    case OP_gt:
+      res = cmpRes > 0;
+      return true;
+    case OP_ge:
+      res = cmpRes >= 0;
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+MeExpr *MeConstFold::CreateFloatConst(double val, PrimType primType) {
+  if (std::isnan(val)) {
+    return nullptr;  // the bits of a computed NaN depend on the machine doing the computation
+  }
+  MIRType &type = *GlobalTables::GetTypeTable().GetPrimType(primType);
+  MemPool *memPool = irMap.GetMIRModule().CurFunction()->GetDataMemPool();
+  MIRConst *mirConst = nullptr;
+  if (primType == PTY_f32) {
+    mirConst = memPool->New<MIRFloatConst>(static_cast<float>(val), type);
+  } else {
+    mirConst = memPool->New<MIRDoubleConst>(val, type);
+  }
+  auto *constExpr = static_cast<ConstMeExpr*>(irMap.CreateConstMeExpr(primType, *mirConst));
+  // float constants compare equal within a tolerance when hashed, so the hashed node may hold
+  // a different value; give up instead of changing the result
+  MIRConst *hashedConst = constExpr->GetConstVal();
+  if (hashedConst == mirConst) {
+    return constExpr;
+  }
+  if (primType == PTY_f32) {
+    return static_cast<MIRFloatConst*>(hashedConst)->GetIntValue() ==
+           static_cast<MIRFloatConst*>(mirConst)->GetIntValue() ? constExpr : nullptr;
+  }
+  return static_cast<MIRDoubleConst*>(hashedConst)->GetIntValue() ==
+         static_cast<MIRDoubleConst*>(mirConst)->GetIntValue() ? constExpr : nullptr;
+}
+
+MeExpr *MeConstFold::FoldIntUnary(OpMeExpr &expr, int64 val) {
+  PrimType primType = expr.GetPrimType();
+  auto uval = static_cast<uint64>(NormalizeInt(static_cast<uint64>(val), primType));
+  uint64 res = 0;
+  switch (expr.GetOp()) {
+    case OP_neg:
+      res = 0 - uval;
+      break;
+    case OP_abs:
+      res = (IsSignedInteger(primType) && static_cast<int64>(uval) < 0) ? 0 - uval : uval;
+      break;
+    case OP_bnot:
+      res = ~uval;
+      break;
+    case OP_lnot:
+      res = (val == 0) ? 1 : 0;
+      break;
+    case OP_sext:
+      res = static_cast<uint64>(SignExtend(static_cast<uint64>(val), expr.GetBitsSize()));
+      break;
+    case OP_zext:
+      res = ZeroExtend(static_cast<uint64>(val), expr.GetBitsSize());
+      break;
+    case OP_extractbits: {
+      uint32 bitsOffset = expr.GetBitsOffSet();
+      uint32 bitsSize = expr.GetBitsSize();
+      if (bitsSize == 0 || bitsOffset + bitsSize > kMaxIntBitSize) {
+        return nullptr;
+      }
+      uint64 bits = static_cast<uint64>(val) >> bitsOffset;
+      res = IsSignedInteger(primType) ? static_cast<uint64>(SignExtend(bits, bitsSize)) : ZeroExtend(bits, bitsSize);
+      break;
+    }
+    default:
+      return nullptr;
+  }
+  return irMap.CreateIntConstMeExpr(NormalizeInt(res, primType), primType);
+}
+
+MeExpr *MeConstFold::FoldFloatUnary(const OpMeExpr &expr, double val) {
+  PrimType primType = expr.GetPrimType();
+  if (primType == PTY_f32) {
+    float res = 0;
+    return EvalFloatUnary(expr.GetOp(), static_cast<float>(val), res) ? CreateFloatConst(res, primType) : nullptr;
+  }
+  double res = 0;
+  return EvalFloatUnary(expr.GetOp(), val, res) ? CreateFloatConst(res, primType) : nullptr;
+}
+
+MeExpr *MeConstFold::FoldIntBinary(const OpMeExpr &expr, int64 val0, int64 val1) {
+  PrimType primType = expr.GetPrimType();
+  uint32 bitSize = GetPrimTypeBitSize(primType);
+  bool isSigned = IsSignedInteger(primType);
+  int64 sval0 = NormalizeInt(static_cast<uint64>(val0), primType);
+  int64 sval1 = NormalizeInt(static_cast<uint64>(val1), primType);
+  auto uval0 = static_cast<uint64>(sval0);
+  auto uval1 = static_cast<uint64>(sval1);
+  uint32 shiftCount = static_cast<uint32>(static_cast<uint64>(val1) & (bitSize - 1));
+  uint64 res = 0;
+  switch (expr.GetOp()) {
+    case OP_add:
+      res = uval0 + uval1;
+      break;
+    case OP_sub:
+      res = uval0 - uval1;
+      break;
+    case OP_mul:
+      res = uval0 * uval1;
+      break;
+    case OP_div:
+    case OP_rem: {
+      if (uval1 == 0) {
+        return nullptr;  // throws ArithmeticException
+      }
+      bool isDiv = expr.GetOp() == OP_div;
+      if (!isSigned) {
+        res = isDiv ? uval0 / uval1 : uval0 % uval1;
+      } else if (sval1 == -1) {
+        // the minimum value divided by -1 overflows to itself, and the remainder is 0
+        res = isDiv ? 0 - uval0 : 0;
+      } else {
+        res = static_cast<uint64>(isDiv ? sval0 / sval1 : sval0 % sval1);
+      }
+      break;
+    }
+    case OP_shl:
+      res = uval0 << shiftCount;
+      break;
+    case OP_ashr:
+      res = static_cast<uint64>(SignExtend(uval0, bitSize) >> shiftCount);
+      break;
+    case OP_lshr:
+      res = ZeroExtend(uval0, bitSize) >> shiftCount;
+      break;
+    case OP_band:
+      res = uval0 & uval1;
+      break;
+    case OP_bior:
+      res = uval0 | uval1;
+      break;
+    case OP_bxor:
+      res = uval0 ^ uval1;
+      break;
+    case OP_land:
+    case OP_cand:
+      res = (val0 != 0 && val1 != 0) ? 1 : 0;
+      break;
+    case OP_lior:
+    case OP_cior:
+      res = (val0 != 0 || val1 != 0) ? 1 : 0;
+      break;
+    case OP_max:
+      res = (isSigned ? sval0 >= sval1 : uval0 >= uval1) ? uval0 : uval1;
+      break;
+    case OP_min:
+      res = (isSigned ? sval0 <= sval1 : uval0 <= uval1) ? uval0 : uval1;
+      break;
+    default:
+      return nullptr;
+  }
+  return irMap.CreateIntConstMeExpr(NormalizeInt(res, primType), primType);
+}
+
+MeExpr *MeConstFold::FoldFloatBinary(const OpMeExpr &expr, double val0, double val1) {
+  PrimType primType = expr.GetPrimType();
+  if (primType == PTY_f32) {
+    float res = 0;
+    return EvalFloatBinary(expr.GetOp(), static_cast<float>(val0), static_cast<float>(val1), res)
+           ? CreateFloatConst(res, primType) : nullptr;
+  }
+  double res = 0;
+  return EvalFloatBinary(expr.GetOp(), val0, val1, res) ? CreateFloatConst(res, primType) : nullptr;
+}
+
+MeExpr *MeConstFold::FoldCompare(OpMeExpr &expr, ConstMeExpr &opnd0, ConstMeExpr &opnd1) {
+  PrimType primType = expr.GetPrimType();
+  PrimType opndType = expr.GetOpndType();
+  Opcode op = expr.GetOp();
+  if (!IsPrimitiveInteger(primType)) {
+    return nullptr;
+  }
+  int64 cmpRes = 0;
+  int64 ival0 = 0;
+  int64 ival1 = 0;
+  double fval0 = 0;
+  double fval1 = 0;
+  if (IsPrimitiveInteger(opndType) && GetIntConstValue(opnd0, ival0) && GetIntConstValue(opnd1, ival1)) {
+    ival0 = NormalizeInt(static_cast<uint64>(ival0), opndType);
+    ival1 = NormalizeInt(static_cast<uint64>(ival1), opndType);
+    cmpRes = IsSignedInteger(opndType) ? ThreeWayCompare(ival0, ival1)
+                                       : ThreeWayCompare(static_cast<uint64>(ival0), static_cast<uint64>(ival1));
+  } else if (IsFoldableFloat(opndType) && GetFloatConstValue(opnd0, fval0) && GetFloatConstValue(opnd1, fval1)) {
+    if (std::isnan(fval0) || std::isnan(fval1)) {
+      // unordered: every comparison is false except ne; cmpl and cmpg say -1 and 1
+      if (op == OP_cmp) {
+        return nullptr;
+      }
+      int64 res = (op == OP_ne || op == OP_cmpg) ? 1 : (op == OP_cmpl ? -1 : 0);
+      return irMap.CreateIntConstMeExpr(res, primType);
+    }
+    cmpRes = ThreeWayCompare(fval0, fval1);
+  } else {
+    return nullptr;
+  }
+  if (op == OP_cmp || op == OP_cmpl || op == OP_cmpg) {
+    return irMap.CreateIntConstMeExpr(cmpRes, primType);
+  }
+  bool res = false;
+  if (!CompareResultToBool(op, cmpRes, res)) {
+    return nullptr;
+  }
+  return irMap.CreateIntConstMeExpr(res ? 1 : 0, primType);
+}
+
+MeExpr *MeConstFold::FoldCvt(OpMeExpr &expr, ConstMeExpr &opnd) {
+  PrimType toType = expr.GetPrimType();
+  PrimType fromType = expr.GetOpndType();
+  Opcode op = expr.GetOp();
+  int64 ival = 0;
+  double fval = 0;
+  if (IsFoldableInt(fromType) && GetIntConstValue(opnd, ival)) {
+    if (op != OP_cvt) {
+      return nullptr;
+    }
+    int64 val = NormalizeInt(static_cast<uint64>(ival), fromType);
+    if (IsFoldableInt(toType) && toType != PTY_u1) {
+      return irMap.CreateIntConstMeExpr(NormalizeInt(static_cast<uint64>(val), toType), toType);
+    }
+    bool isUnsigned64 = IsUnsignedInteger(fromType) && GetPrimTypeBitSize(fromType) == kMaxIntBitSize;
+    if (toType == PTY_f32) {
+      float res = isUnsigned64 ? static_cast<float>(static_cast<uint64>(val)) : static_cast<float>(val);
+      return CreateFloatConst(res, toType);
+    }
+    if (toType == PTY_f64) {
+      double res = isUnsigned64 ? static_cast<double>(static_cast<uint64>(val)) : static_cast<double>(val);
+      return CreateFloatConst(res, toType);
+    }
+    return nullptr;
+  }
+  if (!IsFoldableFloat(fromType) || !GetFloatConstValue(opnd, fval)) {
+    return nullptr;
+  }
+  if (IsFoldableFloat(toType)) {
+    return op == OP_cvt ? CreateFloatConst(fval, toType) : nullptr;
+  }
+  if (!IsFoldableInt(toType) || toType == PTY_u1 || std::isnan(fval)) {
+    return nullptr;
+  }
+  double res = 0;
+  switch (op) {
+    case OP_cvt:
+    case OP_trunc:
+      res = std::trunc(fval);
+      break;
+    case OP_floor:
+      res = std::floor(fval);
+      break;
+    case OP_ceil:
+      res = std::ceil(fval);
+      break;
+    default:
+      return nullptr;  // round differs between targets for halfway values
+  }
+  // NaN and values out of range of the result are converted differently by different targets
+  uint32 bitSize = GetPrimTypeBitSize(toType);
+  if (IsSignedInteger(toType)) {
+    double bound = std::ldexp(1.0, static_cast<int>(bitSize - 1));
+    if (res < -bound || res >= bound) {
+      return nullptr;
+    }
+    return irMap.CreateIntConstMeExpr(static_cast<int64>(res), toType);
+  }
+  if (res < 0 || res >= std::ldexp(1.0, static_cast<int>(bitSize))) {
+    return nullptr;
+  }
+  return irMap.CreateIntConstMeExpr(static_cast<int64>(static_cast<uint64>(res)), toType);
+}
+
+MeExpr *MeConstFold::Fold(OpMeExpr &expr) {
+  Opcode op = expr.GetOp();
+  if (op == OP_select) {
+    // only the condition has to be constant
+    MeExpr *cond = expr.GetOpnd(0);
+    int64 condVal = 0;
+    if (cond->GetMeOp() != kMeOpConst || !GetIntConstValue(*cond, condVal)) {
+      return nullptr;
+    }
+    MeExpr *chosen = expr.GetOpnd(condVal != 0 ? 1 : 2);
+    return chosen->GetPrimType() == expr.GetPrimType() ? chosen : nullptr;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    if (expr.GetOpnd(i) == nullptr || expr.GetOpnd(i)->GetMeOp() != kMeOpConst) {
+      return nullptr;
+    }
+  }
+  PrimType primType = expr.GetPrimType();
+  int64 ival0 = 0;
+  int64 ival1 = 0;
+  double fval0 = 0;
+  double fval1 = 0;
+  switch (op) {
+    case OP_abs:
+    case OP_bnot:
+    case OP_lnot:
+    case OP_neg:
+    case OP_recip:
+    case OP_sqrt:
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits: {
+      MeExpr &opnd = *expr.GetOpnd(0);
+      if (IsFoldableInt(primType) && GetIntConstValue(opnd, ival0)) {
+        return FoldIntUnary(expr, ival0);
+      }
+      if (IsFoldableFloat(primType) && GetFloatConstValue(opnd, fval0)) {
+        return FoldFloatUnary(expr, fval0);
+      }
+      return nullptr;
+    }
+    case OP_cvt:
+    case OP_trunc:
+    case OP_floor:
+    case OP_ceil:
+    case OP_round:
+      return FoldCvt(expr, static_cast<ConstMeExpr&>(*expr.GetOpnd(0)));
+    case OP_eq:
+    case OP_ne:
+    case OP_lt:
+    case OP_le:
+    case OP_gt:
+    case OP_ge:
+    case OP_cmp:
+    case OP_cmpl:
+    case OP_cmpg:
+      return FoldCompare(expr, static_cast<ConstMeExpr&>(*expr.GetOpnd(0)),
+                         static_cast<ConstMeExpr&>(*expr.GetOpnd(1)));
+    case OP_add:
+    case OP_sub:
+    case OP_mul:
+    case OP_div:
+    case OP_rem:
+    case OP_shl:
+    case OP_ashr:
+    case OP_lshr:
+    case OP_band:
+    case OP_bior:
+    case OP_bxor:
+    case OP_land:
+    case OP_lior:
+    case OP_cand:
+    case OP_cior:
+    case OP_max:
+    case OP_min: {
+      MeExpr &opnd0 = *expr.GetOpnd(0);
+      MeExpr &opnd1 = *expr.GetOpnd(1);
+      if (IsFoldableInt(primType) && GetIntConstValue(opnd0, ival0) && GetIntConstValue(opnd1, ival1)) {
+        return FoldIntBinary(expr, ival0, ival1);
+      }
+      if (IsFoldableFloat(primType) && GetFloatConstValue(opnd0, fval0) && GetFloatConstValue(opnd1, fval1)) {
+        return FoldFloatBinary(expr, fval0, fval1);
+      }
+      return nullptr;
+    }
+    default:
+      // CG_array_elem_add, alloca and the allocations are not values known at compile time
+      return nullptr;
+  }
+}
+}  // namespace maple
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_copy_prop.h"
+#include "me_option.h"
+
+// A copy is only propagated when the symbol it assigns is read with its declared type, so a
+// store that truncates is never skipped, and neither the symbol nor its right hand side is
+// volatile. Copies of ref type are left to the RC phases, which pair each of them with its
+// increment. A handler can be entered from the middle of a try block, where the versions
+// assigned later in the block are not stored yet, so an assignment in a try block is only
+// propagated within its own BB.
+namespace maple {
+namespace {
+size_t OstIdxOf(MeExpr &expr) {
+  if (expr.GetMeOp() == kMeOpVar) {
+    return static_cast<VarMeExpr&>(expr).GetOStIdx().idx;
+  }
+  return static_cast<RegMeExpr&>(expr).GetOstIdx().idx;
+}
+
+MeDefBy DefByOf(MeExpr &expr) {
+  if (expr.GetMeOp() == kMeOpVar) {
+    return static_cast<VarMeExpr&>(expr).GetDefBy();
+  }
+  return static_cast<RegMeExpr&>(expr).GetDefBy();
+}
+
+// the bb of the stmt or phi defining a var or reg, nullptr for the other defs
+const BB *DefBBOf(MeExpr &expr) {
+  bool isVar = expr.GetMeOp() == kMeOpVar;
+  switch (DefByOf(expr)) {
+    case kDefByStmt:
+      return isVar ? static_cast<VarMeExpr&>(expr).GetDefStmt()->GetBB()
+                   : static_cast<RegMeExpr&>(expr).GetDefStmt()->GetBB();
+    case kDefByPhi:
+      return isVar ? static_cast<VarMeExpr&>(expr).GetDefPhi().GetDefBB()
+                   : static_cast<RegMeExpr&>(expr).GetDefPhi().GetDefBB();
+    default:
+      return nullptr;
+  }
+}
+}  // namespace
+
+// true if expr is the version of its symbol that holds at the stmt being visited
+bool MeCopyProp::IsCurrentVersion(MeExpr &expr) const {
+  MeExpr *cur = curVersion[OstIdxOf(expr)];
+  return cur == nullptr ? DefByOf(expr) == kDefByNo : cur == &expr;
+}
+
+// true if reading var or reg gives back exactly the value assigned to it
+bool MeCopyProp::IsPropagatableLHS(const MeExpr &lhs) const {
+  if (lhs.GetPrimType() == PTY_ref || lhs.GetPrimType() == PTY_agg) {
+    return false;
+  }
+  if (lhs.GetMeOp() == kMeOpReg) {
+    return static_cast<const RegMeExpr&>(lhs).GetRegIdx() >= 0;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const VarMeExpr&>(lhs).GetOStIdx());
+  if (ost->IsVolatile()) {
+    return false;
+  }
+  MIRType *declType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ost->GetTyIdx());
+  return declType != nullptr && declType->GetPrimType() == lhs.GetPrimType();
+}
+
+// True if the var or reg rhs, copied by a dominating stmt, still holds the copied value at a use
+// in useBB. The current versions are only exact at a join where the symbol has a phi, and
+// MeSSA places none where the symbol is dead, so a symbol with another def may have been
+// assigned on a path to useBB that the walk has not seen.
+bool MeCopyProp::IsForwardable(MeExpr &rhs, const BB &useBB) const {
+  if (!IsPropagatableLHS(rhs) || !IsCurrentVersion(rhs)) {
+    return false;
+  }
+  uint32 numOwnDefs = DefByOf(rhs) == kDefByNo ? 0 : 1;
+  return numDefs[OstIdxOf(rhs)] <= numOwnDefs || DefBBOf(rhs) == &useBB;
+}
+
+// what the use of a var or reg in useBB can be replaced with
+MeExpr *MeCopyProp::PropagatedValue(MeExpr &use, const BB &useBB) {
+  if (DefByOf(use) != kDefByStmt || !IsPropagatableLHS(use)) {
+    return &use;
+  }
+  MeStmt *defStmt = use.GetMeOp() == kMeOpVar ? static_cast<VarMeExpr&>(use).GetDefStmt()
+                                              : static_cast<RegMeExpr&>(use).GetDefStmt();
+  if (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign) {
+    return &use;
+  }
+  if (defStmt->GetBB() != &useBB && defStmt->GetBB()->GetAttributes(kBBAttrIsTry)) {
+    return &use;
+  }
+  MeExpr *rhs = defStmt->GetRHS();
+  if (rhs->GetPrimType() != use.GetPrimType()) {
+    return &use;
+  }
+  switch (rhs->GetMeOp()) {
+    case kMeOpConst:
+      ++numConstsPropagated;
+      return rhs;
+    case kMeOpVar:
+    case kMeOpReg:
+      if (!IsForwardable(*rhs, useBB)) {
+        return &use;
+      }
+      ++numCopiesPropagated;
+      return rhs;
+    default:
+      return &use;
+  }
+}
+
+// return what replaces expr in a stmt of useBB
+MeExpr *MeCopyProp::VisitExpr(MeExpr &expr, const BB &useBB) {
+  if (expr.GetMeOp() == kMeOpVar || expr.GetMeOp() == kMeOpReg) {
+    return PropagatedValue(expr, useBB);
+  }
+  MeExpr *result =
+      irMap.RewriteOpnds(expr, [this, &useBB](MeExpr &opnd, size_t) { return VisitExpr(opnd, useBB); });
+  if (result->GetMeOp() != kMeOpOp) {
+    return result;
+  }
+  MeExpr *folded = constFold.Fold(static_cast<OpMeExpr&>(*result));
+  if (folded == nullptr) {
+    return result;
+  }
+  ++numFolded;
+  return folded;
+}
+
+void MeCopyProp::VisitStmt(MeStmt &stmt) {
+  Opcode op = stmt.GetOp();
+  // the vars passed to intrinsic calls such as MPL_CLEANUP_LOCALREFVARS name the symbols themselves
+  bool isIntrinsicCall = op == OP_intrinsiccall || op == OP_xintrinsiccall || op == OP_intrinsiccallwithtype ||
+                         op == OP_intrinsiccallassigned || op == OP_xintrinsiccallassigned ||
+                         op == OP_intrinsiccallwithtypeassigned;
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd == nullptr || (isIntrinsicCall && opnd->GetMeOp() == kMeOpVar)) {
+      continue;
+    }
+    MeExpr *newOpnd = VisitExpr(*opnd, *stmt.GetBB());
+    if (newOpnd == opnd) {
+      continue;
+    }
+    stmt.SetOpnd(i, newOpnd);
+    if (i == 0 && op == OP_iassign) {
+      auto &iassign = static_cast<IassignMeStmt&>(stmt);
+      iassign.SetLHSVal(irMap.BuildLHSIvarFromIassMeStmt(iassign));
+    }
+  }
+  // the versions defined by stmt become current after it
+  if (stmt.GetVarLHS() != nullptr) {
+    SetCurrentVersion(*stmt.GetVarLHS());
+  }
+  if (stmt.GetRegLHS() != nullptr) {
+    SetCurrentVersion(*stmt.GetRegLHS());
+  }
+  MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+  if (chiList != nullptr) {
+    for (auto &chiPair : *chiList) {
+      SetCurrentVersion(*chiPair.second->GetLHS());
+    }
+  }
+  MapleVector<MustDefMeNode> *mustDefList = stmt.GetMustDefList();
+  if (mustDefList != nullptr) {
+    for (MustDefMeNode &mustDef : *mustDefList) {
+      SetCurrentVersion(*mustDef.GetLHS());
+    }
+  }
+}
+
+void MeCopyProp::SetCurrentVersion(MeExpr &expr) {
+  size_t ostIdx = OstIdxOf(expr);
+  undoLog.emplace_back(ostIdx, curVersion[ostIdx]);
+  curVersion[ostIdx] = &expr;
+}
+
+void MeCopyProp::CountDefs() {
+  numDefs.assign(ssaTab.GetOriginalStTableSize(), 0);
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    for (auto &phiPair : bb->GetMevarPhiList()) {
+      ++numDefs[OstIdxOf(*phiPair.second->GetLHS())];
+    }
+    for (auto &phiPair : bb->GetMeregphiList()) {
+      ++numDefs[OstIdxOf(*phiPair.second->GetLHS())];
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      if (stmt.GetVarLHS() != nullptr) {
+        ++numDefs[OstIdxOf(*stmt.GetVarLHS())];
+      }
+      if (stmt.GetRegLHS() != nullptr) {
+        ++numDefs[OstIdxOf(*stmt.GetRegLHS())];
+      }
+      MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+      if (chiList != nullptr) {
+        for (auto &chiPair : *chiList) {
+          ++numDefs[OstIdxOf(*chiPair.second->GetLHS())];
+        }
+      }
+      MapleVector<MustDefMeNode> *mustDefList = stmt.GetMustDefList();
+      if (mustDefList != nullptr) {
+        for (MustDefMeNode &mustDef : *mustDefList) {
+          ++numDefs[OstIdxOf(*mustDef.GetLHS())];
+        }
+      }
+    }
+  }
+}
+
+void MeCopyProp::VisitBB(BB &bb) {
+  for (auto &phiPair : bb.GetMevarPhiList()) {
+    SetCurrentVersion(*phiPair.second->GetLHS());
+  }
+  for (auto &phiPair : bb.GetMeregphiList()) {
+    SetCurrentVersion(*phiPair.second->GetLHS());
+  }
+  for (auto &stmt : bb.GetMeStmts()) {
+    VisitStmt(stmt);
+  }
+}
+
+// restore the current versions on leaving a dominator subtree
+void MeCopyProp::DropFacts(size_t numFacts) {
+  while (undoLog.size() > numFacts) {
+    curVersion[undoLog.back().first] = undoLog.back().second;
+    undoLog.pop_back();
+  }
+}
+
+void MeCopyProp::Run() {
+  curVersion.assign(ssaTab.GetOriginalStTableSize(), nullptr);
+  CountDefs();
+  WalkDomTree();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "copyprop of " << func.GetName() << ": " << numCopiesPropagated << " copies and "
+                           << numConstsPropagated << " constants propagated, " << numFolded
+                           << " expressions folded\n";
+  }
+}
+
+AnalysisResult *MeDoCopyProp::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeCopyProp copyProp(*func, *dom, DEBUGFUNC(func));
+  copyProp.Run();
+  if (DEBUGFUNC(func)) {
+    func->GetIRMap()->Dump();
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_dom_walker.h"
+
+namespace maple {
+// the value assigned to a var or reg by a dassign or regassign, if it is read back unchanged
+MeExpr *MeDomWalker::GetDefRHS(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    if (var.GetDefBy() != kDefByStmt || var.GetFieldID() != 0) {
+      return nullptr;
+    }
+    const OriginalSt *ost = ssaTab.GetOriginalStFromID(var.GetOStIdx());
+    MIRType *declType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ost->GetTyIdx());
+    if (ost->IsVolatile() || declType == nullptr ||
+        (declType->GetPrimType() != var.GetPrimType() && var.GetPrimType() != PTY_ref)) {
+      return nullptr;
+    }
+    defStmt = var.GetDefStmt();
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    if (reg.GetDefBy() != kDefByStmt || reg.GetRegIdx() < 0) {
+      return nullptr;
+    }
+    defStmt = reg.GetDefStmt();
+  } else {
+    return nullptr;
+  }
+  if (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign) {
+    return nullptr;
+  }
+  MeExpr *rhs = defStmt->GetRHS();
+  return rhs->GetPrimType() == expr.GetPrimType() ? rhs : nullptr;
+}
+
+// the var or reg a chain of copies starts from, so that copies of a value compare equal
+MeExpr *MeDomWalker::ResolveCopies(MeExpr &expr) const {
+  MeExpr *cur = &expr;
+  MeExpr *rhs = GetDefRHS(*cur);
+  while (rhs != nullptr && (rhs->GetMeOp() == kMeOpVar || rhs->GetMeOp() == kMeOpReg)) {
+    cur = rhs;
+    rhs = GetDefRHS(*cur);
+  }
+  return cur;
+}
+
+// The conditions of the branches whose edges dominate bb. An edge dominates the bbs dominated by
+// its successor when that successor has no other predecessor, and the versions compared by the
+// branch cannot change on the way down.
+void MeDomWalker::CollectBranchConds(const BB &bb, std::vector<BranchCond> &conds) const {
+  for (const BB *cur = &bb; cur != nullptr && cur != func.GetCommonEntryBB(); cur = dom.GetDom(cur->GetBBId())) {
+    if (cur->GetPred().size() != 1) {
+      continue;
+    }
+    const BB *pred = cur->GetPred(0);
+    if (pred->GetKind() != kBBCondGoto || pred->GetSucc().size() < 2 || pred->GetSucc(0) == pred->GetSucc(1) ||
+        pred->GetMeStmts().empty()) {
+      continue;
+    }
+    // the target of the branch is the second successor, the other ones are the handlers of a try
+    bool isTarget = pred->GetSucc(1) == cur;
+    if (!isTarget && pred->GetSucc(0) != cur) {
+      continue;
+    }
+    const MeStmt &lastStmt = pred->GetMeStmts().back();
+    if (lastStmt.GetOp() != OP_brtrue && lastStmt.GetOp() != OP_brfalse) {
+      continue;
+    }
+    bool holds = (lastStmt.GetOp() == OP_brtrue) == isTarget;
+    conds.push_back(BranchCond{ static_cast<const CondGotoMeStmt&>(lastStmt).GetOpnd(), holds });
+  }
+}
+
+void MeDomWalker::MarkReachableFromHandlers() {
+  reachableFromHandler.assign(func.GetAllBBs().size(), false);
+  std::vector<BB*> workList;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    if ((*bIt)->GetAttributes(kBBAttrIsCatch)) {
+      reachableFromHandler[(*bIt)->GetBBId()] = true;
+      workList.push_back(*bIt);
+    }
+  }
+  while (!workList.empty()) {
+    BB *bb = workList.back();
+    workList.pop_back();
+    for (BB *succ : bb->GetSucc()) {
+      if (!reachableFromHandler[succ->GetBBId()]) {
+        reachableFromHandler[succ->GetBBId()] = true;
+        workList.push_back(succ);
+      }
+    }
+  }
+}
+
+// True if a fact established by a stmt of factBB, in a try block if inTry, holds at the stmt of bb
+// being visited. A handler is entered when a stmt of its try block throws, before the stmt has
+// established anything, so in the bbs reachable from a handler only the facts of the bb itself
+// and of the stmts outside try blocks hold.
+bool MeDomWalker::HoldsAt(const BB *factBB, bool inTry, const BB &bb) const {
+  return !inTry || factBB == &bb || !reachableFromHandler[bb.GetBBId()];
+}
+
+bool MeDomWalker::GetDomChild(BBId bbID, size_t childIdx, BBId &childID) const {
+  if (bbID >= dom.GetDomChildrenSize() || childIdx >= dom.GetDomChildren(bbID).size()) {
+    return false;
+  }
+  childID = *(dom.GetDomChildren(bbID).begin() + childIdx);
+  return true;
+}
+
+void MeDomWalker::WalkDomTree() {
+  MapleVector<BB*> &bbVec = func.GetAllBBs();
+  // the bb, the next child to visit, and the number of facts established before the bb
+  struct WalkState {
+    BB *bb;
+    size_t childIdx;
+    size_t numFacts;
+  };
+  std::vector<WalkState> workStack;
+  BB *entry = func.GetCommonEntryBB();
+  workStack.push_back(WalkState{ entry, 0, GetNumFacts() });
+  VisitBB(*entry);
+  while (!workStack.empty()) {
+    WalkState &top = workStack.back();
+    BBId childID;
+    if (GetDomChild(top.bb->GetBBId(), top.childIdx, childID)) {
+      BB *child = bbVec[childID];
+      ++top.childIdx;
+      workStack.push_back(WalkState{ child, 0, GetNumFacts() });
+      VisitBB(*child);
+      continue;
+    }
+    DropFacts(top.numFacts);
+    workStack.pop_back();
+  }
+}
+}  // namespace maple
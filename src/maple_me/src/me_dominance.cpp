@@ -26,8 +26,14 @@ AnalysisResult *MeDoDominance::Run(MeFunction *func, MeFuncResultMgr *funcResMgr
   MemPool *memPool = NewMemPool();
   Dominance *dom = memPool->New<Dominance>(*memPool, *NewMemPool(), func->GetAllBBs(),
                                            *func->GetCommonEntryBB(), *func->GetCommonExitBB());
+  // the iterative algorithm may need many rounds on large irreducible CFGs, Semi-NCA never does
+  bool useSemiNCA = func->GetAllBBs().size() >= MeOption::semiNCAThreshold;
   dom->GenPostOrderID();
-  dom->ComputeDominance();
+  if (useSemiNCA) {
+    dom->ComputeDominanceSemiNCA();
+  } else {
+    dom->ComputeDominance();
+  }
   dom->ComputeDomFrontiers();
   dom->ComputeDomChildren();
   size_t num = 0;
@@ -35,7 +41,11 @@ AnalysisResult *MeDoDominance::Run(MeFunction *func, MeFuncResultMgr *funcResMgr
   dom->GetDtPreOrder().resize(num);
   dom->ComputeDtDfn();
   dom->PdomGenPostOrderID();
-  dom->ComputePostDominance();
+  if (useSemiNCA) {
+    dom->ComputePostDominanceSemiNCA();
+  } else {
+    dom->ComputePostDominance();
+  }
   dom->ComputePdomFrontiers();
   dom->ComputePdomChildren();
   num = 0;
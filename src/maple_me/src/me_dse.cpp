@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_dse.h"
+#include "me_cfg.h"
+#include "me_option.h"
+
+// This phase deletes the assignments, phis and conditional branches whose results can not
+// affect the behavior of the function. Stores to globals, to memory reached through pointers,
+// to volatile or address-taken variables, and any statement that may throw or has other side
+// effects are the roots of the marking; everything else has to be reached from them through
+// the SSA use-def chains or through control dependence.
+// Statements in try blocks are roots as well, as calls do not end a try BB and the phis of a
+// handler only see the versions live at the end of each of its predecessors.
+// A dead conditional branch is only retargeted when the code between it and its immediate
+// post-dominator is acyclic and outside any try or handler block, so that removing it can
+// neither make a loop terminate nor change how exceptions are caught; otherwise the branch is
+// kept and marked required. The BBs that become unreachable are deleted afterwards.
+// In java, a load through a reference that may be null throws, so it is only dropped when the
+// reference is known to point to an object.
+namespace maple {
+namespace {
+// true if base is an address or a new object, or a var or reg assigned one
+bool IsNonNullBase(MeExpr &base) {
+  MeExpr *value = &base;
+  if (base.GetMeOp() == kMeOpVar && static_cast<VarMeExpr&>(base).GetDefBy() == kDefByStmt) {
+    MeStmt *defStmt = static_cast<VarMeExpr&>(base).GetDefStmt();
+    value = defStmt->GetOp() == OP_dassign ? defStmt->GetRHS() : value;
+  } else if (base.GetMeOp() == kMeOpReg && static_cast<RegMeExpr&>(base).GetDefBy() == kDefByStmt) {
+    MeStmt *defStmt = static_cast<RegMeExpr&>(base).GetDefStmt();
+    value = defStmt->GetOp() == OP_regassign ? defStmt->GetRHS() : value;
+  }
+  switch (value->GetMeOp()) {
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+    case kMeOpGcmalloc:
+      return true;
+    case kMeOpOp:
+      return value->GetOp() == OP_gcmallocjarray || value->GetOp() == OP_gcpermallocjarray;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+bool MeDSE::IsOstEscaping(const OriginalSt &ost) const {
+  return !ost.IsLocal() || ost.IsVolatile() || ost.IsAddressTaken() || ost.GetIndirectLev() > 0;
+}
+
+bool MeDSE::ChiListEscapes(const MapleMap<OStIdx, ChiMeNode*> &chiList) const {
+  for (auto &chiPair : chiList) {
+    if (IsOstEscaping(*ssaTab.GetOriginalStFromID(chiPair.first))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if evaluating expr may have an effect besides its value, so it can not be dropped
+bool MeDSE::ExprNonDeletable(MeExpr &expr) {
+  constexpr uint8 kDeletable = 1;
+  constexpr uint8 kNonDeletable = 2;
+  size_t exprID = static_cast<size_t>(expr.GetExprID());
+  if (exprID < nonDeletableCache.size() && nonDeletableCache[exprID] != 0) {
+    return nonDeletableCache[exprID] == kNonDeletable;
+  }
+  bool nonDeletable = false;
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+      nonDeletable = static_cast<VarMeExpr&>(expr).IsVolatile(ssaTab);
+      break;
+    case kMeOpReg:
+      // reads of %%thrownval, %%retval etc. are tied to the statement before them
+      nonDeletable = static_cast<RegMeExpr&>(expr).GetRegIdx() < 0;
+      break;
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      nonDeletable = ivar.IsVolatile() || ExprNonDeletable(*ivar.GetBase()) ||
+                     (func.GetMIRModule().IsJavaModule() && !IsNonNullBase(*ivar.GetBase()));
+      break;
+    }
+    case kMeOpGcmalloc:
+      nonDeletable = true;
+      break;
+    case kMeOpOp:
+    case kMeOpNary: {
+      if (kOpcodeInfo.NotPure(expr.GetOp()) || kOpcodeInfo.MayThrowException(expr.GetOp())) {
+        nonDeletable = expr.GetOp() != OP_array || static_cast<NaryMeExpr&>(expr).GetBoundCheck();
+      } else if (expr.GetOp() == OP_intrinsicop) {
+        auto &nary = static_cast<NaryMeExpr&>(expr);
+        const IntrinDesc &desc = IntrinDesc::intrinTable[nary.GetIntrinsic()];
+        nonDeletable = nary.GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH || (!desc.IsPure() && !desc.HasNoSideEffect());
+      }
+      for (size_t i = 0; !nonDeletable && i < expr.GetNumOpnds(); ++i) {
+        nonDeletable = ExprNonDeletable(*expr.GetOpnd(i));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  if (exprID < nonDeletableCache.size()) {
+    nonDeletableCache[exprID] = nonDeletable ? kNonDeletable : kDeletable;
+  }
+  return nonDeletable;
+}
+
+// the stmts that are never deleted but do not make anything required either
+bool MeDSE::IsStructuralStmt(const MeStmt &stmt) const {
+  switch (stmt.GetOp()) {
+    case OP_goto:
+    case OP_comment:
+    case OP_try:
+    case OP_catch:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool MeDSE::StmtMustRequired(MeStmt &stmt) {
+  // a handler sees the variables as they are at the throwing stmt, not at the end of the
+  // try bb where its phis take their operands, so nothing defined in a try bb is dropped
+  if (stmt.GetBB()->GetAttributes(kBBAttrIsTry) && !stmt.IsCondBr()) {
+    return !IsStructuralStmt(stmt);
+  }
+  switch (stmt.GetOp()) {
+    case OP_dassign: {
+      auto &dass = static_cast<DassignMeStmt&>(stmt);
+      const OriginalSt *ost = ssaTab.GetOriginalStFromID(dass.GetVarLHS()->GetOStIdx());
+      return IsOstEscaping(*ost) || ChiListEscapes(*dass.GetChiList()) || ExprNonDeletable(*dass.GetRHS());
+    }
+    case OP_regassign: {
+      auto &rass = static_cast<RegassignMeStmt&>(stmt);
+      return rass.GetRegLHS()->GetRegIdx() < 0 || ExprNonDeletable(*rass.GetRHS());
+    }
+    case OP_iassign: {
+      auto &iass = static_cast<IassignMeStmt&>(stmt);
+      return iass.GetLHSVal()->IsVolatile() || ChiListEscapes(*iass.GetChiList()) ||
+             ExprNonDeletable(*iass.GetLHSVal()->GetBase()) || ExprNonDeletable(*iass.GetRHS());
+    }
+    case OP_intrinsiccall:
+    case OP_xintrinsiccall:
+    case OP_intrinsiccallassigned:
+    case OP_xintrinsiccallassigned:
+    case OP_intrinsiccallwithtype:
+    case OP_intrinsiccallwithtypeassigned: {
+      // the java intrinsics may throw even when they have no other side effect
+      auto &intrn = static_cast<IntrinsiccallMeStmt&>(stmt);
+      const IntrinDesc &desc = IntrinDesc::intrinTable[intrn.GetIntrinsic()];
+      if (!desc.IsPure() || desc.IsJava() || ChiListEscapes(*intrn.GetChiList())) {
+        return true;
+      }
+      for (MustDefMeNode &mustDef : *intrn.GetMustDefList()) {
+        MeExpr *lhs = mustDef.GetLHS();
+        if (lhs->GetMeOp() == kMeOpVar &&
+            IsOstEscaping(*ssaTab.GetOriginalStFromID(static_cast<VarMeExpr*>(lhs)->GetOStIdx()))) {
+          return true;
+        }
+      }
+      for (size_t i = 0; i < intrn.NumMeStmtOpnds(); ++i) {
+        if (ExprNonDeletable(*intrn.GetOpnd(i))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case OP_brtrue:
+    case OP_brfalse:
+      return keepAllBranches || ExprNonDeletable(*stmt.GetOpnd(0));
+    default:
+      return !IsStructuralStmt(stmt);
+  }
+}
+
+void MeDSE::MarkStmtRequired(MeStmt &stmt) {
+  if (stmt.GetIsLive()) {
+    return;
+  }
+  stmt.SetIsLive(true);
+  stmtWorkList.push_back(&stmt);
+  MarkBBRequired(*stmt.GetBB());
+}
+
+// a bb with required code makes the branches it is control dependent on required
+void MeDSE::MarkBBRequired(const BB &bb) {
+  BBId bbID = bb.GetBBId();
+  if (bbRequired[bbID]) {
+    return;
+  }
+  bbRequired[bbID] = true;
+  if (keepAllBranches || bbID >= dom.GetPdomFrontierSize()) {
+    return;
+  }
+  for (BBId cdBBID : dom.GetPdomFrontierItem(bbID)) {
+    BB *cdBB = func.GetBBFromID(cdBBID);
+    if (cdBB == nullptr || cdBB->IsMeStmtEmpty()) {
+      continue;
+    }
+    MeStmt *lastStmt = to_ptr(cdBB->GetMeStmts().rbegin());
+    if (lastStmt->IsCondBr()) {
+      MarkStmtRequired(*lastStmt);
+    }
+  }
+}
+
+// a required phi needs the value from each of its preds, so the paths through the preds
+// must be kept apart
+void MeDSE::MarkPhiBBRequired(BB &bb) {
+  MarkBBRequired(bb);
+  for (BB *pred : bb.GetPred()) {
+    MarkBBRequired(*pred);
+  }
+}
+
+void MeDSE::MarkExprUsed(MeExpr &expr) {
+  size_t exprID = static_cast<size_t>(expr.GetExprID());
+  CHECK_FATAL(exprID < exprUsed.size(), "expr id out of range in MeDSE::MarkExprUsed");
+  if (exprUsed[exprID]) {
+    return;
+  }
+  exprUsed[exprID] = true;
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+      defWorkList.push_back(&expr);
+      break;
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      MarkExprUsed(*ivar.GetBase());
+      if (ivar.GetMu() != nullptr) {
+        MarkExprUsed(*ivar.GetMu());
+      }
+      break;
+    }
+    default:
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        MarkExprUsed(*expr.GetOpnd(i));
+      }
+      break;
+  }
+}
+
+void MeDSE::MarkVarDefRequired(VarMeExpr &var) {
+  switch (var.GetDefBy()) {
+    case kDefByStmt:
+      MarkStmtRequired(*var.GetDefStmt());
+      break;
+    case kDefByPhi: {
+      MeVarPhiNode &phi = var.GetDefPhi();
+      if (phi.GetIsLive()) {
+        break;
+      }
+      phi.SetIsLive(true);
+      MarkPhiBBRequired(*phi.GetDefBB());
+      for (VarMeExpr *opnd : phi.GetOpnds()) {
+        MarkExprUsed(*opnd);
+      }
+      break;
+    }
+    case kDefByChi: {
+      // a may-def keeps the value it may not overwrite
+      ChiMeNode &chi = var.GetDefChi();
+      MarkStmtRequired(*chi.GetBase());
+      MarkExprUsed(*chi.GetRHS());
+      break;
+    }
+    case kDefByMustDef:
+      MarkStmtRequired(*var.GetDefMustDef().GetBase());
+      break;
+    default:
+      break;
+  }
+}
+
+void MeDSE::MarkRegDefRequired(RegMeExpr &reg) {
+  switch (reg.GetDefBy()) {
+    case kDefByStmt:
+      MarkStmtRequired(*reg.GetDefStmt());
+      break;
+    case kDefByPhi: {
+      MeRegPhiNode &phi = reg.GetDefPhi();
+      if (phi.GetIsLive()) {
+        break;
+      }
+      phi.SetIsLive(true);
+      MarkPhiBBRequired(*phi.GetDefBB());
+      for (RegMeExpr *opnd : phi.GetOpnds()) {
+        MarkExprUsed(*opnd);
+      }
+      break;
+    }
+    case kDefByMustDef:
+      MarkStmtRequired(*reg.GetDefMustDef().GetBase());
+      break;
+    default:
+      break;
+  }
+}
+
+void MeDSE::PropagateLiveness() {
+  while (!stmtWorkList.empty() || !defWorkList.empty()) {
+    if (!defWorkList.empty()) {
+      MeExpr *expr = defWorkList.back();
+      defWorkList.pop_back();
+      if (expr->GetMeOp() == kMeOpVar) {
+        MarkVarDefRequired(static_cast<VarMeExpr&>(*expr));
+      } else {
+        MarkRegDefRequired(static_cast<RegMeExpr&>(*expr));
+      }
+      continue;
+    }
+    MeStmt *stmt = stmtWorkList.back();
+    stmtWorkList.pop_back();
+    for (size_t i = 0; i < stmt->NumMeStmtOpnds(); ++i) {
+      MarkExprUsed(*stmt->GetOpnd(i));
+    }
+    MapleMap<OStIdx, VarMeExpr*> *muList = stmt->GetMuList();
+    if (muList != nullptr) {
+      for (auto &muPair : *muList) {
+        MarkExprUsed(*muPair.second);
+      }
+    }
+  }
+}
+
+// the dead branch at the end of bb can be replaced by a goto to its immediate post-dominator
+// if no required code and no cycle lies in between
+bool MeDSE::CanRemoveBranch(BB &bb) {
+  BB *pdom = dom.GetPdom(bb.GetBBId());
+  if (bb.GetKind() != kBBCondGoto || bb.GetSucc().size() != 2 || bb.GetSucc(0) == bb.GetSucc(1) ||
+      pdom == nullptr || pdom == &bb || pdom == func.GetCommonExitBB()) {
+    return false;
+  }
+  for (auto &phiPair : pdom->GetMevarPhiList()) {
+    if (phiPair.second->GetIsLive()) {
+      return false;
+    }
+  }
+  for (auto &phiPair : pdom->GetMeregphiList()) {
+    if (phiPair.second->GetIsLive()) {
+      return false;
+    }
+  }
+  constexpr uint32 kRegionAttrs = kBBAttrIsEntry | kBBAttrIsExit | kBBAttrIsTry | kBBAttrIsTryEnd |
+                                  kBBAttrIsCatch | kBBAttrIsJavaFinally | kBBAttrIsJSCatch | kBBAttrIsJSFinally;
+  // depth-first walk from bb up to pdom; a bb seen again while still on the stack closes a cycle
+  regionStamp += 2;
+  const uint32 onStack = regionStamp - 1;
+  const uint32 done = regionStamp;
+  std::vector<std::pair<BB*, size_t>> workStack;
+  regionMark[bb.GetBBId()] = onStack;
+  workStack.emplace_back(&bb, 0);
+  while (!workStack.empty()) {
+    BB *cur = workStack.back().first;
+    size_t succIdx = workStack.back().second;
+    if (succIdx == cur->GetSucc().size()) {
+      regionMark[cur->GetBBId()] = done;
+      workStack.pop_back();
+      continue;
+    }
+    ++workStack.back().second;
+    BB *succ = cur->GetSucc(succIdx);
+    if (succ == pdom || regionMark[succ->GetBBId()] == done) {
+      continue;
+    }
+    if (regionMark[succ->GetBBId()] == onStack || succ == func.GetCommonExitBB() ||
+        succ->GetAttributes(kRegionAttrs) || bbRequired[succ->GetBBId()]) {
+      return false;
+    }
+    regionMark[succ->GetBBId()] = onStack;
+    workStack.emplace_back(succ, 0);
+  }
+  return true;
+}
+
+void MeDSE::RemoveBranch(BB &bb) {
+  BB *pdom = dom.GetPdom(bb.GetBBId());
+  // bblayout lays out pdom next or adds the goto to it
+  bb.RemoveMeStmt(to_ptr(bb.GetMeStmts().rbegin()));
+  bb.SetKind(kBBFallthru);
+  bool pdomIsSucc = false;
+  for (BB *succ : bb.GetSucc()) {
+    if (succ == pdom) {
+      pdomIsSucc = true;
+    } else {
+      succ->RemoveBBFromPred(&bb);
+    }
+  }
+  bb.GetSucc().clear();
+  bb.GetSucc().push_back(pdom);
+  if (!pdomIsSucc) {
+    pdom->GetPred().push_back(&bb);
+  }
+  cfgChanged = true;
+  ++numBranchesRemoved;
+}
+
+void MeDSE::RemoveDeadPhis(BB &bb) {
+  MapleMap<OStIdx, MeVarPhiNode*> &varPhis = bb.GetMevarPhiList();
+  for (auto it = varPhis.begin(); it != varPhis.end();) {
+    if (it->second->GetIsLive()) {
+      ++it;
+    } else {
+      it = varPhis.erase(it);
+      ++numPhisRemoved;
+    }
+  }
+  MapleMap<OStIdx, MeRegPhiNode*> &regPhis = bb.GetMeregphiList();
+  for (auto it = regPhis.begin(); it != regPhis.end();) {
+    if (it->second->GetIsLive()) {
+      ++it;
+    } else {
+      it = regPhis.erase(it);
+      ++numPhisRemoved;
+    }
+  }
+}
+
+void MeDSE::RemoveDeadStmts(BB &bb) {
+  std::vector<MeStmt*> deadStmts;
+  for (auto &stmt : bb.GetMeStmts()) {
+    if (!stmt.GetIsLive() && !IsStructuralStmt(stmt) && !stmt.IsCondBr()) {
+      deadStmts.push_back(&stmt);
+    }
+  }
+  for (MeStmt *stmt : deadStmts) {
+    bb.RemoveMeStmt(stmt);
+    ++numStmtsRemoved;
+  }
+}
+
+void MeDSE::Run() {
+  MapleVector<BB*> &bbVec = func.GetAllBBs();
+  exprUsed.assign(static_cast<size_t>(irMap.GetExprID()), false);
+  nonDeletableCache.assign(static_cast<size_t>(irMap.GetExprID()), 0);
+  bbRequired.assign(bbVec.size(), false);
+  regionMark.assign(bbVec.size(), 0);
+  // control dependence is only known for the bbs that reach the exit in the post-dominator tree
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bb != func.GetCommonEntryBB() && dom.GetPdom(bb->GetBBId()) == nullptr) {
+      keepAllBranches = true;
+    }
+    for (auto &phiPair : bb->GetMevarPhiList()) {
+      phiPair.second->SetIsLive(false);
+    }
+    for (auto &phiPair : bb->GetMeregphiList()) {
+      phiPair.second->SetIsLive(false);
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      stmt.SetIsLive(false);
+    }
+  }
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (StmtMustRequired(stmt)) {
+        MarkStmtRequired(stmt);
+      }
+    }
+  }
+  // a dead branch that can not be removed is required after all, which may require more
+  std::vector<BB*> deadBranchBBs;
+  bool changed = true;
+  while (changed) {
+    PropagateLiveness();
+    changed = false;
+    deadBranchBBs.clear();
+    for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+      BB *bb = *bIt;
+      if (bb->IsMeStmtEmpty()) {
+        continue;
+      }
+      MeStmt *lastStmt = to_ptr(bb->GetMeStmts().rbegin());
+      if (!lastStmt->IsCondBr() || lastStmt->GetIsLive()) {
+        continue;
+      }
+      if (CanRemoveBranch(*bb)) {
+        deadBranchBBs.push_back(bb);
+      } else {
+        MarkStmtRequired(*lastStmt);
+        changed = true;
+      }
+    }
+  }
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    RemoveDeadPhis(**bIt);
+  }
+  for (BB *bb : deadBranchBBs) {
+    RemoveBranch(*bb);
+  }
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    RemoveDeadStmts(**bIt);
+  }
+  if (cfgChanged) {
+    func.GetTheCfg()->UnreachCodeAnalysis(true);
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "dse of " << func.GetName() << ": " << numStmtsRemoved << " stmts, " << numPhisRemoved
+                           << " phis and " << numBranchesRemoved << " branches removed\n";
+  }
+}
+
+AnalysisResult *MeDoDSE::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeDSE dse(*func, *dom, DEBUGFUNC(func));
+  dse.Run();
+  if (dse.IsCfgChanged()) {
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+  }
+  if (DEBUGFUNC(func)) {
+    LogInfo::MapleLogger() << "\n============== After DSE =============" << '\n';
+    func->GetIRMap()->Dump();
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_func_opt.h"
+#include <malloc.h>
+#include <unistd.h>
+#include <fstream>
+#include "me_function.h"
+#include "me_option.h"
+
+namespace maple {
+namespace {
+// resident set size of the process in MB, 0 if it cannot be read
+size_t ResidentMegaBytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  if (!(statm >> totalPages >> residentPages)) {
+    return 0;
+  }
+  constexpr uint32 kMegaByteShift = 20;
+  return (residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE))) >> kMegaByteShift;
+}
+}  // namespace
+
+int MeFuncOptExecutor::Run(MplTaskParam*) {
+  MIRModule &mirModule = scheduler.GetMIRModule();
+  ctrler = scheduler.AcquireCtrler();
+  ThreadMemPoolCtrler() = ctrler.get();
+  mirModule.SetCurFunction(&mirFunc);
+  managerMp = ctrler->NewMemPool("maple_me function optimizer mempool");
+  phaseManager = scheduler.GetPhaseManager().Clone(*managerMp);
+  funcMp = ctrler->NewMemPool("maple_me per-function mempool");
+  for (size_t i = 0; i < phaseManager->GetPhaseSequence()->size(); ++i) {
+    if (!phaseManager->GetPhaseAt(i)->IsFunctionLocal()) {
+      lastNonLocalPhase = i;
+      hasNonLocalPhase = true;
+    }
+  }
+  if (!MeOption::quiet) {
+    scheduler.LockModule();
+    LogInfo::MapleLogger() << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>> Optimizing Function  < " << mirFunc.GetName()
+                           << " id=" << mirFunc.GetPuidxOrigin() << " >---\n";
+    scheduler.UnlockModule();
+  }
+  PrepareFunction(*ctrler->NewMemPool("first verst mempool"), false);
+  MeFuncPhase *changeCFGPhase = RunPhases(nullptr);
+  if (changeCFGPhase != nullptr) {
+    // do all the phases start over, as MeFuncPhaseManager::Run does
+    changeCFGPhase->ClearChangeCFG();
+    phaseManager->GetAnalysisResultManager()->InvalidAllResults();
+    meFunc->~MeFunction();
+    PrepareFunction(*ctrler->NewMemPool("second verst mempool"), true);
+    (void)RunPhases(changeCFGPhase);
+  }
+  // a turn this function never got to, or kept because the cfg changed, still has to be passed on
+  if (hasNonLocalPhase && !turnTaken) {
+    scheduler.WaitTurn(GetTaskId());
+    turnTaken = true;
+    turnHeld = true;
+  }
+  if (turnHeld) {
+    turnHeld = false;
+    scheduler.PassTurn();
+  }
+  scheduler.LockModule();
+  scheduler.GetPhaseManager().AccumulateTimers(*phaseManager);
+  scheduler.UnlockModule();
+  Release();
+  ThreadMemPoolCtrler() = nullptr;
+  return 0;
+}
+
+void MeFuncOptExecutor::PrepareFunction(MemPool &versMemPool, bool isSecondTime) {
+  MIRModule &mirModule = scheduler.GetMIRModule();
+  // lowering and cfg construction look up and create global table entries outside the locking
+  // those tables do, so they are serialized with the other workers
+  scheduler.LockModule();
+  meFunc = funcMp->New<MeFunction>(&mirModule, &mirFunc, funcMp, &versMemPool, scheduler.GetMeInput());
+  meFunc->PartialInit(isSecondTime);
+  meFunc->Prepare(rangeNum);
+  scheduler.UnlockModule();
+}
+
+// run the phase sequence but skipPhase, returning the phase that changed the cfg if any
+MeFuncPhase *MeFuncOptExecutor::RunPhases(const MeFuncPhase *skipPhase) {
+  bool isSecondTime = (skipPhase != nullptr);
+  size_t numPhases = phaseManager->GetPhaseSequence()->size();
+  for (size_t i = 0; i < numPhases; ++i) {
+    MeFuncPhase *phase = phaseManager->GetPhaseAt(i);
+    if (phase == skipPhase) {
+      continue;
+    }
+    if (phase->IsFunctionLocal()) {
+      // a local phase that writes the log is kept from interleaving its lines with other workers
+      bool writesLog = phaseManager->PhaseWritesLog(*meFunc, i);
+      if (writesLog) {
+        scheduler.LockModule();
+      }
+      phaseManager->RunPhaseAt(*meFunc, i, prevPhaseName, isSecondTime);
+      if (writesLog) {
+        scheduler.UnlockModule();
+      }
+    } else {
+      // the turn is held from the first non-local phase to the last one; phases run again after a
+      // cfg change that come after the turn was passed on are only serialized, not ordered
+      if (!turnTaken) {
+        scheduler.WaitTurn(GetTaskId());
+        turnTaken = true;
+        turnHeld = true;
+      }
+      scheduler.LockModule();
+      phaseManager->RunPhaseAt(*meFunc, i, prevPhaseName, isSecondTime);
+      scheduler.UnlockModule();
+      if (turnHeld && i == lastNonLocalPhase) {
+        turnHeld = false;
+        scheduler.PassTurn();
+      }
+    }
+    prevPhaseName = phase->PhaseName();
+    if (!isSecondTime && phase->IsChangedCFG()) {
+      return phase;
+    }
+  }
+  return nullptr;
+}
+
+void MeFuncOptExecutor::Release() {
+  phaseManager->GetAnalysisResultManager()->InvalidAllResults();
+  meFunc->~MeFunction();
+  meFunc = nullptr;
+  ctrler->DeleteMemPool(funcMp);
+  funcMp = nullptr;
+  phaseManager->~MeFuncPhaseManager();
+  phaseManager = nullptr;
+  ctrler->DeleteMemPool(managerMp);
+  managerMp = nullptr;
+  // mempools left behind by phases, such as the version table ones, go away with the controller
+  scheduler.RecycleCtrler(std::move(ctrler));
+}
+
+void MeFuncOptScheduler::AddFunction(MIRFunction &func, uint64 rangeNum) {
+  std::unique_ptr<MeFuncOptExecutor> executor(new MeFuncOptExecutor(*this, func, rangeNum));
+  AddTask(executor.get());
+  executors.push_back(std::move(executor));
+}
+
+std::unique_ptr<MemPoolCtrler> MeFuncOptScheduler::AcquireCtrler() {
+  std::lock_guard<std::mutex> guard(idleCtrlersMutex);
+  if (idleCtrlers.empty()) {
+    return std::unique_ptr<MemPoolCtrler>(new MemPoolCtrler());
+  }
+  std::unique_ptr<MemPoolCtrler> ctrler = std::move(idleCtrlers.back());
+  idleCtrlers.pop_back();
+  return ctrler;
+}
+
+void MeFuncOptScheduler::RecycleCtrler(std::unique_ptr<MemPoolCtrler> ctrler) {
+  // controllers are destroyed and memory is trimmed after the lock is released
+  std::vector<std::unique_ptr<MemPoolCtrler>> dropped;
+  bool checkResident = false;
+  {
+    std::lock_guard<std::mutex> guard(idleCtrlersMutex);
+    // a controller that still owns mempools left behind by a phase is not reused, it would keep them forever
+    if (ctrler->IsEmpty() && idleCtrlers.size() < maxIdleCtrlers) {
+      idleCtrlers.push_back(std::move(ctrler));
+    } else {
+      dropped.push_back(std::move(ctrler));
+    }
+    checkResident = MeOption::memPoolHighWater != 0 && ++numRecycled % kResidentCheckInterval == 0;
+  }
+  if (!checkResident) {
+    return;
+  }
+  size_t residentMegaBytes = ResidentMegaBytes();
+  bool trim = false;
+  {
+    std::lock_guard<std::mutex> guard(idleCtrlersMutex);
+    if (!trimArmed) {
+      // trim again only once the process has shrunk well below the mark, or every check above it would
+      trimArmed = residentMegaBytes < MeOption::memPoolHighWater / kRearmDivisor * (kRearmDivisor - 1);
+    } else if (residentMegaBytes > MeOption::memPoolHighWater) {
+      // give the cached blocks back to the system
+      trimArmed = false;
+      trim = true;
+      for (auto &idleCtrler : idleCtrlers) {
+        dropped.push_back(std::move(idleCtrler));
+      }
+      idleCtrlers.clear();
+    }
+  }
+  dropped.clear();
+  if (trim) {
+    (void)malloc_trim(0);
+  }
+}
+
+void MeFuncOptScheduler::WaitTurn(uint32 taskId) {
+  std::unique_lock<std::mutex> lock(turnMutex);
+  turnPassed.wait(lock, [this, taskId]() { return turn == taskId; });
+}
+
+void MeFuncOptScheduler::PassTurn() {
+  {
+    std::lock_guard<std::mutex> guard(turnMutex);
+    ++turn;
+  }
+  turnPassed.notify_all();
+}
+
+void MeFuncOptScheduler::Run(uint32 nthreads) {
+  // module results are only looked up by the workers, so the ones they use have to exist beforehand
+  if (phaseManager.GetModResultMgr() != nullptr) {
+    (void)phaseManager.GetModResultMgr()->GetAnalysisResult(MoPhase_CHA, &mirModule);
+  }
+  turn = 0;
+  numRecycled = 0;
+  trimArmed = true;
+  mirModule.SetMultiThreaded(true);
+  TableConcurrency::SetEnabled(true);
+  // one controller per worker
+  maxIdleCtrlers = nthreads;
+  (void)RunTask(nthreads, true);
+  TableConcurrency::SetEnabled(false);
+  mirModule.SetMultiThreaded(false);
+  executors.clear();
+  idleCtrlers.clear();
+  Reset();
+}
+}  // namespace maple
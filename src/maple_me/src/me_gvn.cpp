@@ -0,0 +1,569 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_gvn.h"
+#include <algorithm>
+#include "me_option.h"
+
+// This phase removes the redundant computations of expressions and indirect loads
+// in the HSSA form. The values are numbered by the hashing of IRMap; this phase only
+// decides where a value is already available and saves it in a preg there.
+// A value computed in a try block is only reused outside that block when no handler
+// of the block can be entered from the middle of it, i.e. when the block dominates none
+// of its handlers. Values of ref type are left to the RC phases.
+namespace maple {
+void MeGVN::ComputeWalkOrder() {
+  MapleVector<BB*> &bbVec = func.GetAllBBs();
+  size_t bbNum = bbVec.size();
+  // number the bbs in reverse postorder of the cfg
+  std::vector<uint32> rpoIndex(bbNum, 0);
+  std::vector<bool> seen(bbNum, false);
+  std::vector<std::pair<BB*, size_t>> workStack;
+  uint32 postNum = 0;
+  BB *entry = func.GetCommonEntryBB();
+  seen[entry->GetBBId()] = true;
+  workStack.emplace_back(entry, 0);
+  while (!workStack.empty()) {
+    BB *bb = workStack.back().first;
+    size_t succIdx = workStack.back().second;
+    if (succIdx < bb->GetSucc().size()) {
+      ++workStack.back().second;
+      BB *succ = bb->GetSucc(succIdx);
+      if (!seen[succ->GetBBId()]) {
+        seen[succ->GetBBId()] = true;
+        workStack.emplace_back(succ, 0);
+      }
+      continue;
+    }
+    rpoIndex[bb->GetBBId()] = static_cast<uint32>(bbNum) - postNum;
+    ++postNum;
+    workStack.pop_back();
+  }
+  // visiting the dominator tree children in reverse postorder visits the source of every
+  // forward edge before its target
+  domChildren.assign(bbNum, std::vector<BBId>());
+  exportsOccs.assign(bbNum, true);
+  for (size_t i = 0; i < bbNum && i < dom.GetDomChildrenSize(); ++i) {
+    BB *bb = bbVec[i];
+    if (bb == nullptr) {
+      continue;
+    }
+    BBIdRange children = dom.GetDomChildren(i);
+    domChildren[i].assign(children.begin(), children.end());
+    std::sort(domChildren[i].begin(), domChildren[i].end(),
+              [&rpoIndex](BBId a, BBId b) { return rpoIndex[a] < rpoIndex[b]; });
+    if (!bb->GetAttributes(kBBAttrIsTry)) {
+      continue;
+    }
+    for (BB *succ : bb->GetSucc()) {
+      if ((succ->GetAttributes(kBBAttrIsCatch) || succ->GetAttributes(kBBAttrIsJavaFinally)) &&
+          dom.Dominate(*bb, *succ)) {
+        exportsOccs[i] = false;
+        break;
+      }
+    }
+  }
+}
+
+bool MeGVN::HasVolatileLeaf(MeExpr &expr) {
+  auto it = volatileCache.find(&expr);
+  if (it != volatileCache.end()) {
+    return it->second;
+  }
+  bool result = false;
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+      result = static_cast<VarMeExpr&>(expr).IsVolatile(ssaTab);
+      break;
+    case kMeOpIvar:
+      result = static_cast<IvarMeExpr&>(expr).IsVolatile() ||
+               HasVolatileLeaf(*static_cast<IvarMeExpr&>(expr).GetBase());
+      break;
+    case kMeOpOp:
+    case kMeOpNary:
+      for (size_t i = 0; i < expr.GetNumOpnds() && !result; ++i) {
+        MeExpr *opnd = expr.GetOpnd(i);
+        result = opnd != nullptr && HasVolatileLeaf(*opnd);
+      }
+      break;
+    default:
+      break;
+  }
+  volatileCache[&expr] = result;
+  return result;
+}
+
+// candidates are the non-leaf values that can be kept in a preg and computed again at will
+bool MeGVN::IsCandidate(MeExpr &expr) {
+  auto it = candidateCache.find(&expr);
+  if (it != candidateCache.end()) {
+    return it->second;
+  }
+  bool result = false;
+  PrimType primType = expr.GetPrimType();
+  if (primType != PTY_ref && primType != PTY_agg && primType != PTY_void && !IsPrimitiveDynType(primType)) {
+    switch (expr.GetMeOp()) {
+      case kMeOpOp: {
+        Opcode op = expr.GetOp();
+        // compares mostly feed branches, and constant operands are left to folding
+        if (kOpcodeInfo.NotPure(op) || kOpcodeInfo.IsCompare(op)) {
+          break;
+        }
+        for (size_t i = 0; i < kOperandNumTernary; ++i) {
+          MeExpr *opnd = expr.GetOpnd(i);
+          if (opnd != nullptr && opnd->GetMeOp() != kMeOpConst) {
+            result = true;
+            break;
+          }
+        }
+        break;
+      }
+      case kMeOpIvar:
+        result = true;
+        break;
+      case kMeOpNary: {
+        auto &naryExpr = static_cast<NaryMeExpr&>(expr);
+        result = naryExpr.GetOp() == OP_array ||
+                 (naryExpr.GetOp() == OP_intrinsicop && IntrinDesc::intrinTable[naryExpr.GetIntrinsic()].IsPure());
+        break;
+      }
+      default:
+        break;
+    }
+    result = result && !HasVolatileLeaf(expr);
+  }
+  candidateCache[&expr] = result;
+  return result;
+}
+
+// true if expr can be computed on a path that did not compute it: it neither throws nor traps
+bool MeGVN::IsSafeToSpeculate(const MeExpr &expr) const {
+  if (expr.IsLeaf()) {
+    return true;
+  }
+  if (expr.GetMeOp() != kMeOpOp) {
+    return false;
+  }
+  Opcode op = expr.GetOp();
+  if ((op == OP_div || op == OP_rem) && !IsPrimitiveFloat(expr.GetPrimType())) {
+    return false;
+  }
+  for (size_t i = 0; i < kOperandNumTernary; ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr && !IsSafeToSpeculate(*opnd)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// true if every leaf of expr is defined by a phi of join or above join
+bool MeGVN::IsDefinedAbove(MeExpr &expr, BB &join) {
+  BB *defBB = nullptr;
+  switch (expr.GetMeOp()) {
+    case kMeOpVar: {
+      auto &var = static_cast<VarMeExpr&>(expr);
+      if (var.GetDefBy() == kDefByPhi) {
+        return var.GetDefPhi().GetDefBB() == &join || dom.Dominate(*var.GetDefPhi().GetDefBB(), join);
+      }
+      defBB = var.DefByBB();
+      break;
+    }
+    case kMeOpReg: {
+      auto &reg = static_cast<RegMeExpr&>(expr);
+      if (reg.GetDefBy() == kDefByPhi) {
+        return reg.GetDefPhi().GetDefBB() == &join || dom.Dominate(*reg.GetDefPhi().GetDefBB(), join);
+      }
+      defBB = reg.DefByBB();
+      break;
+    }
+    case kMeOpOp:
+    case kMeOpNary:
+    case kMeOpIvar:
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        MeExpr *opnd = expr.GetOpnd(i);
+        if (opnd != nullptr && !IsDefinedAbove(*opnd, join)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return true;
+  }
+  return defBB == nullptr || (defBB != &join && dom.Dominate(*defBB, join));
+}
+
+bool MeGVN::IsOccAvailableIn(const Occ &occ, const BB &bb) const {
+  return occ.bb == &bb || occ.isMerge || exportsOccs[occ.bb->GetBBId()];
+}
+
+MeGVN::Occ *MeGVN::FindAvailOcc(MeExpr &expr) {
+  auto it = availTable.find(&expr);
+  if (it == availTable.end() || !IsOccAvailableIn(*it->second, *curBB)) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+// find an occ of expr whose value is available at the end of bb, which has been visited
+MeGVN::Occ *MeGVN::FindOccAtEnd(MeExpr &expr, BB &bb) {
+  auto it = occsOfExpr.find(&expr);
+  if (it == occsOfExpr.end()) {
+    return nullptr;
+  }
+  for (auto occIt = it->second.rbegin(); occIt != it->second.rend(); ++occIt) {
+    Occ *occ = *occIt;
+    if (dom.Dominate(*occ->bb, bb) && IsOccAvailableIn(*occ, bb)) {
+      return occ;
+    }
+  }
+  return nullptr;
+}
+
+void MeGVN::MakeAvail(Occ &occ) {
+  auto it = availTable.find(occ.expr);
+  if (it == availTable.end()) {
+    availUndoLog.emplace_back(occ.expr, nullptr);
+    availTable.emplace(occ.expr, &occ);
+  } else {
+    availUndoLog.emplace_back(occ.expr, it->second);
+    it->second = &occ;
+  }
+}
+
+// the rewrite pass takes the occs in the order the analysis created them
+MeGVN::Occ *MeGVN::NextOcc(const MeExpr &expr, bool isMerge) {
+  if (isMerge) {
+    if (nextOcc < occs.size() && occs[nextOcc].isMerge && occs[nextOcc].expr == &expr) {
+      return &occs[nextOcc++];
+    }
+    return nullptr;
+  }
+  CHECK_FATAL(nextOcc < occs.size() && !occs[nextOcc].isMerge && occs[nextOcc].expr == &expr,
+              "MeGVN: rewrite diverges from the analysis");
+  return &occs[nextOcc++];
+}
+
+// the value of expr on the edge from the predIdx-th pred of join; nullptr if it is not hashed
+// and create is false
+MeExpr *MeGVN::PhiTranslate(MeExpr &expr, const BB &join, size_t predIdx, bool create) {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar: {
+      auto &var = static_cast<VarMeExpr&>(expr);
+      if (var.GetDefBy() == kDefByPhi && var.GetDefPhi().GetDefBB() == &join) {
+        return var.GetDefPhi().GetOpnd(predIdx);
+      }
+      return &expr;
+    }
+    case kMeOpReg: {
+      auto &reg = static_cast<RegMeExpr&>(expr);
+      if (reg.GetDefBy() == kDefByPhi && reg.GetDefPhi().GetDefBB() == &join) {
+        return reg.GetDefPhi().GetOpnd(predIdx);
+      }
+      return &expr;
+    }
+    case kMeOpOp: {
+      auto &opExpr = static_cast<OpMeExpr&>(expr);
+      OpMeExpr newExpr(opExpr, kInvalidExprID);
+      bool changed = false;
+      for (size_t i = 0; i < kOperandNumTernary; ++i) {
+        MeExpr *opnd = opExpr.GetOpnd(i);
+        if (opnd == nullptr) {
+          continue;
+        }
+        MeExpr *newOpnd = PhiTranslate(*opnd, join, predIdx, create);
+        if (newOpnd == nullptr) {
+          return nullptr;
+        }
+        changed = changed || newOpnd != opnd;
+        newExpr.SetOpnd(i, newOpnd);
+      }
+      if (!changed) {
+        return &expr;
+      }
+      return create ? irMap.HashMeExpr(newExpr) : irMap.FindHashedMeExpr(newExpr);
+    }
+    case kMeOpIvar: {
+      auto &ivarExpr = static_cast<IvarMeExpr&>(expr);
+      MeExpr *newBase = PhiTranslate(*ivarExpr.GetBase(), join, predIdx, create);
+      if (newBase == nullptr) {
+        return nullptr;
+      }
+      VarMeExpr *mu = ivarExpr.GetMu();
+      VarMeExpr *newMu = mu;
+      if (mu != nullptr && mu->GetDefBy() == kDefByPhi && mu->GetDefPhi().GetDefBB() == &join) {
+        newMu = mu->GetDefPhi().GetOpnd(predIdx);
+      }
+      if (newBase == ivarExpr.GetBase() && newMu == mu) {
+        return &expr;
+      }
+      IvarMeExpr newExpr(kInvalidExprID, ivarExpr);
+      newExpr.SetBase(newBase);
+      newExpr.SetMuVal(newMu);
+      return create ? irMap.HashMeExpr(newExpr) : irMap.FindHashedMeExpr(newExpr);
+    }
+    case kMeOpNary: {
+      auto &naryExpr = static_cast<NaryMeExpr&>(expr);
+      std::vector<MeExpr*> newOpnds;
+      bool changed = false;
+      for (MeExpr *opnd : naryExpr.GetOpnds()) {
+        MeExpr *newOpnd = PhiTranslate(*opnd, join, predIdx, create);
+        if (newOpnd == nullptr) {
+          return nullptr;
+        }
+        changed = changed || newOpnd != opnd;
+        newOpnds.push_back(newOpnd);
+      }
+      if (!changed) {
+        return &expr;
+      }
+      NaryMeExpr newExpr(&irMap.GetIRMapAlloc(), kInvalidExprID, naryExpr);
+      for (size_t i = 0; i < newOpnds.size(); ++i) {
+        newExpr.SetOpnd(i, newOpnds[i]);
+      }
+      return create ? irMap.HashMeExpr(newExpr) : irMap.FindHashedMeExpr(newExpr);
+    }
+    default:
+      return &expr;
+  }
+}
+
+// expr is not available in join, see whether the preds of join make it so
+MeGVN::Occ *MeGVN::TryMerge(MeExpr &expr, BB &join) {
+  if (join.GetAttributes(kBBAttrIsCatch) || join.GetAttributes(kBBAttrIsJavaFinally)) {
+    return nullptr;
+  }
+  MapleVector<BB*> &preds = join.GetPred();
+  std::vector<Occ*> predOccs(preds.size(), nullptr);
+  BB *missingPred = nullptr;
+  for (size_t i = 0; i < preds.size(); ++i) {
+    BB *pred = preds[i];
+    // the value flowing in on a back edge is not known yet
+    if (!visited[pred->GetBBId()]) {
+      return nullptr;
+    }
+    MeExpr *predExpr = PhiTranslate(expr, join, i, false);
+    predOccs[i] = predExpr == nullptr ? nullptr : FindOccAtEnd(*predExpr, *pred);
+    if (predOccs[i] != nullptr) {
+      continue;
+    }
+    if (missingPred != nullptr && missingPred != pred) {
+      return nullptr;
+    }
+    missingPred = pred;
+  }
+  if (std::find(predOccs.begin(), predOccs.end(), nullptr) == predOccs.end()) {
+    missingPred = nullptr;
+  }
+  std::vector<MeExpr*> insertExprs(preds.size(), nullptr);
+  if (missingPred != nullptr) {
+    // computing the value on the missing edge must neither add a path through it nor trap
+    if (missingPred->GetSucc().size() != 1 ||
+        static_cast<size_t>(std::count(predOccs.begin(), predOccs.end(), nullptr)) == preds.size() ||
+        !IsSafeToSpeculate(expr) || !IsDefinedAbove(expr, join)) {
+      return nullptr;
+    }
+    for (size_t i = 0; i < preds.size(); ++i) {
+      if (predOccs[i] == nullptr) {
+        insertExprs[i] = PhiTranslate(expr, join, i, true);
+      }
+    }
+  }
+  for (Occ *predOcc : predOccs) {
+    if (predOcc != nullptr) {
+      predOcc->needSave = true;
+    }
+  }
+  occs.emplace_back(expr, join, true);
+  Occ *occ = &occs.back();
+  occ->predOccs.swap(predOccs);
+  occ->insertExprs.swap(insertExprs);
+  occsOfExpr[&expr].push_back(occ);
+  return occ;
+}
+
+RegMeExpr *MeGVN::SaveOcc(Occ &occ, MeExpr &value, MeStmt &stmt) {
+  RegMeExpr *reg = irMap.CreateRegMeExpr(occ.expr->GetPrimType());
+  RegassignMeStmt *save = irMap.CreateRegassignMeStmt(*reg, value, *curBB);
+  save->SetSrcPos(stmt.GetSrcPosition());
+  curBB->InsertMeStmtBefore(&stmt, save);
+  occ.reg = reg;
+  ++numSaved;
+  return reg;
+}
+
+// create the reg phi of a merge occ and the copies into its operands at the end of the preds
+RegMeExpr *MeGVN::MaterializeMerge(Occ &occ) {
+  BB &join = *occ.bb;
+  RegMeExpr *phiReg = irMap.CreateRegMeExpr(occ.expr->GetPrimType());
+  MeRegPhiNode *phi = irMap.CreateMeRegPhi(*phiReg);
+  phi->SetDefBB(&join);
+  std::vector<std::pair<BB*, RegMeExpr*>> predVersions;
+  for (size_t i = 0; i < join.GetPred().size(); ++i) {
+    BB *pred = join.GetPred(i);
+    auto it = std::find_if(predVersions.begin(), predVersions.end(),
+                           [pred](const std::pair<BB*, RegMeExpr*> &entry) { return entry.first == pred; });
+    if (it != predVersions.end()) {
+      phi->GetOpnds().push_back(it->second);
+      continue;
+    }
+    MeExpr *value = occ.insertExprs[i];
+    if (occ.predOccs[i] != nullptr) {
+      value = occ.predOccs[i]->reg;
+      CHECK_FATAL(value != nullptr, "MeGVN: merged value is not saved");
+    } else {
+      ++numInserted;
+    }
+    RegMeExpr *version = irMap.CreateRegMeExprVersion(*phiReg);
+    pred->InsertMeStmtLastBr(irMap.CreateRegassignMeStmt(*version, *value, *pred));
+    predVersions.emplace_back(pred, version);
+    phi->GetOpnds().push_back(version);
+  }
+  join.GetMeregphiList().insert(std::make_pair(phiReg->GetOstIdx(), phi));
+  occ.reg = phiReg;
+  ++numMerged;
+  return phiReg;
+}
+
+MeExpr *MeGVN::VisitOpnds(MeExpr &expr, MeStmt &stmt, bool conditional) {
+  Opcode op = expr.GetOp();
+  return irMap.RewriteOpnds(expr, [this, &stmt, conditional, op](MeExpr &opnd, size_t opndIdx) {
+    // the second operand of cand/cior and the choices of select are not always evaluated
+    bool condOpnd =
+        conditional || ((op == OP_cand || op == OP_cior) && opndIdx == 1) || (op == OP_select && opndIdx > 0);
+    return VisitExpr(opnd, stmt, condOpnd);
+  });
+}
+
+// return what replaces expr in stmt; the analysis pass never replaces anything
+MeExpr *MeGVN::VisitExpr(MeExpr &expr, MeStmt &stmt, bool conditional) {
+  if (expr.IsLeaf()) {
+    return &expr;
+  }
+  if (!IsCandidate(expr)) {
+    return VisitOpnds(expr, stmt, conditional);
+  }
+  Occ *availOcc = FindAvailOcc(expr);
+  if (availOcc != nullptr) {
+    if (!rewriting) {
+      availOcc->needSave = true;
+      return &expr;
+    }
+    CHECK_FATAL(availOcc->reg != nullptr, "MeGVN: available value is not saved");
+    ++numReplaced;
+    return availOcc->reg;
+  }
+  if (!conditional && curBB->GetPred().size() > 1) {
+    Occ *mergeOcc = rewriting ? NextOcc(expr, true) : TryMerge(expr, *curBB);
+    if (mergeOcc != nullptr) {
+      MakeAvail(*mergeOcc);
+      return rewriting ? MaterializeMerge(*mergeOcc) : &expr;
+    }
+  }
+  MeExpr *value = VisitOpnds(expr, stmt, conditional);
+  if (conditional) {
+    return value;
+  }
+  Occ *occ = nullptr;
+  if (rewriting) {
+    occ = NextOcc(expr, false);
+  } else {
+    occs.emplace_back(expr, *curBB, false);
+    occ = &occs.back();
+    occsOfExpr[&expr].push_back(occ);
+  }
+  MakeAvail(*occ);
+  return (rewriting && occ->needSave) ? SaveOcc(*occ, *value, stmt) : value;
+}
+
+void MeGVN::VisitBB(BB &bb) {
+  curBB = &bb;
+  for (auto &stmt : bb.GetMeStmts()) {
+    for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+      MeExpr *opnd = stmt.GetOpnd(i);
+      if (opnd == nullptr) {
+        continue;
+      }
+      MeExpr *newOpnd = VisitExpr(*opnd, stmt, false);
+      if (newOpnd == opnd) {
+        continue;
+      }
+      stmt.SetOpnd(i, newOpnd);
+      if (i == 0 && stmt.GetOp() == OP_iassign) {
+        auto &iassign = static_cast<IassignMeStmt&>(stmt);
+        iassign.SetLHSVal(irMap.BuildLHSIvarFromIassMeStmt(iassign));
+      }
+    }
+  }
+  visited[bb.GetBBId()] = true;
+}
+
+bool MeGVN::GetDomChild(BBId bbID, size_t childIdx, BBId &childID) const {
+  if (childIdx >= domChildren[bbID].size()) {
+    return false;
+  }
+  childID = domChildren[bbID][childIdx];
+  return true;
+}
+
+// undo the availability added in the subtree being left
+void MeGVN::DropFacts(size_t numFacts) {
+  while (availUndoLog.size() > numFacts) {
+    std::pair<MeExpr*, Occ*> &entry = availUndoLog.back();
+    if (entry.second == nullptr) {
+      (void)availTable.erase(entry.first);
+    } else {
+      availTable[entry.first] = entry.second;
+    }
+    availUndoLog.pop_back();
+  }
+}
+
+void MeGVN::DumpStats() const {
+  LogInfo::MapleLogger() << "gvn of " << func.GetName() << ": " << numSaved << " values saved, " << numReplaced
+                         << " occurrences replaced, " << numMerged << " merged at joins with " << numInserted
+                         << " inserted on edges\n";
+}
+
+void MeGVN::Run() {
+  ComputeWalkOrder();
+  visited.assign(func.GetAllBBs().size(), false);
+  WalkDomTree();
+  bool changed = std::any_of(occs.begin(), occs.end(), [](const Occ &occ) { return occ.needSave || occ.isMerge; });
+  if (!changed) {
+    return;
+  }
+  rewriting = true;
+  nextOcc = 0;
+  WalkDomTree();
+  CHECK_FATAL(nextOcc == occs.size(), "MeGVN: rewrite diverges from the analysis");
+  if (enabledDebug) {
+    DumpStats();
+  }
+}
+
+AnalysisResult *MeDoGVN::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeGVN gvn(*func, *dom, DEBUGFUNC(func));
+  gvn.Run();
+  return nullptr;
+}
+}  // namespace maple
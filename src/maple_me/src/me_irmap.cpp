@@ -17,6 +17,20 @@
 #include "mir_builder.h"
 
 namespace maple {
+// size the value number table from the statement count; it grows on demand if that was too small
+uint32 MeIRMap::EstimateHashTableSize(const MeFunction &f) {
+  constexpr uint32 kHashSlotsPerStmt = 2;
+  uint32 numStmts = 0;
+  auto eIt = f.valid_end();
+  for (auto bIt = f.valid_begin(); bIt != eIt; ++bIt) {
+    const StmtNodes &stmts = (*bIt)->GetStmtNodes();
+    for (auto it = stmts.cbegin(); it != stmts.cend(); ++it) {
+      ++numStmts;
+    }
+  }
+  return numStmts * kHashSlotsPerStmt;
+}
+
 void MeIRMap::DumpBB(const BB &bb) {
   int i = 0;
   for (const auto &meStmt : bb.GetMeStmts()) {
@@ -32,7 +46,7 @@ void MeIRMap::Dump() {
   // we dump IRMap, restore the mempool afterwards
   MIRFunction *mirFunction = func.GetMirFunc();
   MemPool *backup = mirFunction->GetCodeMempool();
-  mirFunction->SetMemPool(memPoolCtrler.NewMemPool("IR Dump"));
+  mirFunction->SetMemPool(CurMemPoolCtrler().NewMemPool("IR Dump"));
   LogInfo::MapleLogger() << "===================Me IR dump==================\n";
   auto eIt = func.valid_end();
   for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
@@ -53,7 +67,7 @@ void MeIRMap::Dump() {
       meStmt.Dump(this);
     }
   }
-  memPoolCtrler.DeleteMemPool(mirFunction->GetCodeMempool());
+  CurMemPoolCtrler().DeleteMemPool(mirFunction->GetCodeMempool());
   mirFunction->SetMemPool(backup);
 }
 
@@ -103,11 +117,12 @@ AnalysisResult *MeDoIRMap::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, Mo
   irMap->BuildBB(*func->GetCommonEntryBB(), bbIRMapProcessed);
   if (DEBUGFUNC(func)) {
     irMap->Dump();
+    irMap->DumpHashTableStats();
   }
   irMap->GetTempAlloc().SetMemPool(nullptr);
   // delete input IR code for current function
   MIRFunction *mirFunc = func->GetMirFunc();
-  memPoolCtrler.DeleteMemPool(mirFunc->GetCodeMempool());
+  mirFunc->GetMemPoolCtrler().DeleteMemPool(mirFunc->GetCodeMempool());
   mirFunc->SetCodeMemPool(nullptr);
   // delete versionst_table
 #if MIR_FEATURE_FULL
@@ -124,7 +139,7 @@ AnalysisResult *MeDoIRMap::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, Mo
     bb->SetLast(nullptr);
   }
 #endif
-  memPoolCtrler.DeleteMemPool(func->GetMeSSATab()->GetVersionStTable().GetVSTAlloc().GetMemPool());
+  CurMemPoolCtrler().DeleteMemPool(func->GetMeSSATab()->GetVersionStTable().GetVSTAlloc().GetMemPool());
   return irMap;
 }
 }  // namespace maple
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_null_check_opt.h"
+#include "me_option.h"
+
+// Field accesses, array lengths and virtual calls check their reference implicitly, by the
+// fault of the load from it, so they are not removed; they only teach that the reference is not
+// null in the statements they dominate.
+namespace maple {
+namespace {
+// bounds the search through phis for the proof that a reference is not null
+constexpr uint32 kMaxNonNullDepth = 8;
+
+bool IsNullConst(MeExpr &expr) {
+  if (expr.GetMeOp() != kMeOpConst) {
+    return false;
+  }
+  MIRConst *mirConst = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  return mirConst->GetKind() == kConstInt && static_cast<MIRIntConst*>(mirConst)->GetValue() == 0;
+}
+
+bool IsAllocation(Opcode op) {
+  return op == OP_gcmalloc || op == OP_gcmallocjarray || op == OP_gcpermalloc || op == OP_gcpermallocjarray ||
+         op == OP_addrof;
+}
+}  // namespace
+
+// true if expr is the value this has on entry to an instance method
+bool MeNullCheckOpt::IsThis(const MeExpr &expr) const {
+  const MIRFunction *mirFunc = func.GetMirFunc();
+  if (expr.GetMeOp() != kMeOpVar || !func.GetMIRModule().IsJavaModule() || mirFunc->IsStatic() ||
+      mirFunc->GetFormalCount() == 0) {
+    return false;
+  }
+  const auto &var = static_cast<const VarMeExpr&>(expr);
+  if (var.GetDefBy() != kDefByNo || var.GetFieldID() != 0) {
+    return false;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(var.GetOStIdx());
+  return ost->IsSymbolOst() && ost->GetMIRSymbol() == mirFunc->GetFormal(0);
+}
+
+// true if the value of expr is not null whatever the path it is computed on
+bool MeNullCheckOpt::IsNonNullByDef(MeExpr &expr, uint32 depth) {
+  MeExpr *resolved = ResolveCopies(expr);
+  if (IsAllocation(resolved->GetOp()) || IsThis(*resolved)) {
+    return true;
+  }
+  MeExpr *rhs = GetDefRHS(*resolved);
+  if (rhs != nullptr) {
+    return IsAllocation(rhs->GetOp());
+  }
+  if (depth > kMaxNonNullDepth) {
+    return false;
+  }
+  std::vector<MeExpr*> opnds;
+  if (resolved->GetMeOp() == kMeOpVar && static_cast<VarMeExpr*>(resolved)->GetDefBy() == kDefByPhi) {
+    MeVarPhiNode &phi = static_cast<VarMeExpr*>(resolved)->GetDefPhi();
+    opnds.assign(phi.GetOpnds().begin(), phi.GetOpnds().end());
+  } else if (resolved->GetMeOp() == kMeOpReg && static_cast<RegMeExpr*>(resolved)->GetDefBy() == kDefByPhi) {
+    MeRegPhiNode &phi = static_cast<RegMeExpr*>(resolved)->GetDefPhi();
+    opnds.assign(phi.GetOpnds().begin(), phi.GetOpnds().end());
+  } else {
+    return false;
+  }
+  // a reference kept across a loop: assume the phi is not null, and check it stays so
+  if (phisInProgress.find(resolved) != phisInProgress.end()) {
+    return true;
+  }
+  phisInProgress.insert(resolved);
+  bool result = true;
+  for (size_t i = 0; result && i < opnds.size(); ++i) {
+    result = IsNonNullByDef(*opnds[i], depth + 1);
+  }
+  phisInProgress.erase(resolved);
+  return result;
+}
+
+// true if a branch whose edge dominates bb has found expr not to be null
+bool MeNullCheckOpt::IsNonNullByBranch(MeExpr &expr, const BB &bb) const {
+  MeExpr *resolved = ResolveCopies(expr);
+  std::vector<BranchCond> conds;
+  CollectBranchConds(bb, conds);
+  for (const BranchCond &branchCond : conds) {
+    MeExpr *tested = GetNullTestOpnd(*branchCond.cond);
+    if (tested != nullptr && ResolveCopies(*tested) == resolved &&
+        branchCond.holds == (branchCond.cond->GetOp() == OP_ne)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MeNullCheckOpt::IsDereferencedBefore(MeExpr &expr, const BB &bb) const {
+  MeExpr *resolved = ResolveCopies(expr);
+  for (const Dereference &deref : dereferences) {
+    if (!HoldsAt(deref.bb, deref.inTry, bb)) {
+      continue;
+    }
+    if (deref.ref == resolved) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if the value of expr, used at the stmt of bb being visited, is known not to be null
+bool MeNullCheckOpt::IsNonNull(MeExpr &expr, const BB &bb) {
+  return IsNonNullByDef(expr, 0) || IsDereferencedBefore(expr, bb) || IsNonNullByBranch(expr, bb);
+}
+
+// the reference cond compares with null by eq or ne, nullptr if cond is no such comparison
+MeExpr *MeNullCheckOpt::GetNullTestOpnd(MeExpr &cond) const {
+  if (cond.GetMeOp() != kMeOpOp || (cond.GetOp() != OP_eq && cond.GetOp() != OP_ne)) {
+    return nullptr;
+  }
+  auto &cmpExpr = static_cast<OpMeExpr&>(cond);
+  if (cmpExpr.GetOpndType() != PTY_ref && cmpExpr.GetOpndType() != PTY_ptr) {
+    return nullptr;
+  }
+  if (IsNullConst(*cmpExpr.GetOpnd(1))) {
+    return cmpExpr.GetOpnd(0);
+  }
+  return IsNullConst(*cmpExpr.GetOpnd(0)) ? cmpExpr.GetOpnd(1) : nullptr;
+}
+
+// the references expr throws on if they are null
+void MeNullCheckOpt::CollectDereferences(MeExpr &expr, std::vector<MeExpr*> &refs) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpOp: {
+      auto &opExpr = static_cast<OpMeExpr&>(expr);
+      // the second operand of cand/cior and the choices of select are not always evaluated
+      size_t numOpnds = (opExpr.GetOp() == OP_cand || opExpr.GetOp() == OP_cior || opExpr.GetOp() == OP_select)
+                            ? 1
+                            : kOperandNumTernary;
+      for (size_t i = 0; i < numOpnds; ++i) {
+        if (opExpr.GetOpnd(i) != nullptr) {
+          CollectDereferences(*opExpr.GetOpnd(i), refs);
+        }
+      }
+      break;
+    }
+    case kMeOpIvar: {
+      MeExpr *base = static_cast<IvarMeExpr&>(expr).GetBase();
+      CollectDereferences(*base, refs);
+      // the address of a field is close enough to its object for the load to fault on null
+      if (base->GetMeOp() == kMeOpVar || base->GetMeOp() == kMeOpReg) {
+        refs.push_back(base);
+      }
+      break;
+    }
+    case kMeOpNary: {
+      auto &naryExpr = static_cast<NaryMeExpr&>(expr);
+      for (MeExpr *opnd : naryExpr.GetOpnds()) {
+        CollectDereferences(*opnd, refs);
+      }
+      bool isCheckedArray = naryExpr.GetOp() == OP_array && naryExpr.GetBoundCheck();
+      bool isArrayLength = naryExpr.GetOp() == OP_intrinsicop && naryExpr.GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH;
+      if ((isCheckedArray || isArrayLength) && !naryExpr.GetOpnds().empty()) {
+        refs.push_back(naryExpr.GetOpnds()[0]);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void MeNullCheckOpt::CollectDereferences(const MeStmt &stmt, std::vector<MeExpr*> &refs) const {
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectDereferences(*opnd, refs);
+    }
+  }
+  switch (stmt.GetOp()) {
+    case OP_iassign: {
+      MeExpr *base = stmt.GetOpnd(0);
+      if (base->GetMeOp() == kMeOpVar || base->GetMeOp() == kMeOpReg) {
+        refs.push_back(base);
+      }
+      break;
+    }
+    case OP_assertnonnull:
+    case OP_virtualcall:
+    case OP_virtualcallassigned:
+    case OP_interfacecall:
+    case OP_interfacecallassigned:
+      // the receiver of a call is its first operand
+      if (stmt.NumMeStmtOpnds() > 0) {
+        refs.push_back(stmt.GetOpnd(0));
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// Remove stmt if it is an assertnonnull of a reference known not to be null; return true if it
+// has been removed.
+bool MeNullCheckOpt::VisitNullCheck(MeStmt &stmt) {
+  if (stmt.GetOp() != OP_assertnonnull) {
+    return false;
+  }
+  BB &bb = *stmt.GetBB();
+  if (!IsNonNull(*stmt.GetOpnd(0), bb)) {
+    return false;
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "nullcheckopt: remove null check of mx" << stmt.GetOpnd(0)->GetExprID() << " in BB "
+                           << bb.GetBBId() << '\n';
+  }
+  bb.RemoveMeStmt(&stmt);
+  ++numChecksRemoved;
+  return true;
+}
+
+// fold the condition of a branch comparing a reference known not to be null with null
+void MeNullCheckOpt::VisitCondGoto(MeStmt &stmt) {
+  if (stmt.GetOp() != OP_brtrue && stmt.GetOp() != OP_brfalse) {
+    return;
+  }
+  auto &condGoto = static_cast<CondGotoMeStmt&>(stmt);
+  MeExpr *cond = condGoto.GetOpnd();
+  MeExpr *tested = GetNullTestOpnd(*cond);
+  if (tested == nullptr || !IsNonNull(*tested, *stmt.GetBB())) {
+    return;
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "nullcheckopt: fold null test of mx" << tested->GetExprID() << " in BB "
+                           << stmt.GetBB()->GetBBId() << '\n';
+  }
+  condGoto.SetOpnd(0, irMap.CreateIntConstMeExpr(cond->GetOp() == OP_ne ? 1 : 0, cond->GetPrimType()));
+  ++numTestsFolded;
+}
+
+void MeNullCheckOpt::VisitBB(BB &bb) {
+  bool inTry = bb.GetAttributes(kBBAttrIsTry);
+  auto &meStmts = bb.GetMeStmts();
+  std::vector<MeExpr*> refs;
+  for (auto it = meStmts.begin(); it != meStmts.end();) {
+    MeStmt &stmt = *it;
+    ++it;
+    if (VisitNullCheck(stmt)) {
+      continue;
+    }
+    VisitCondGoto(stmt);
+    // the references stmt dereferences are not null in the stmts it dominates
+    refs.clear();
+    CollectDereferences(stmt, refs);
+    for (MeExpr *ref : refs) {
+      dereferences.push_back(Dereference{ ResolveCopies(*ref), &bb, inTry });
+    }
+  }
+}
+
+void MeNullCheckOpt::Run() {
+  MarkReachableFromHandlers();
+  WalkDomTree();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "nullcheckopt of " << func.GetName() << ": " << numChecksRemoved
+                           << " null checks removed, " << numTestsFolded << " null tests folded\n";
+  }
+}
+
+AnalysisResult *MeDoNullCheckOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeNullCheckOpt nullCheckOpt(*func, *dom, DEBUGFUNC(func));
+  nullCheckOpt.Run();
+  if (DEBUGFUNC(func)) {
+    func->GetIRMap()->Dump();
+  }
+  return nullptr;
+}
+}  // namespace maple
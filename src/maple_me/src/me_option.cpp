@@ -39,6 +39,9 @@ bool MeOption::ignoreIPA = true;
 bool MeOption::lessThrowAlias = true;
 bool MeOption::finalFieldAlias = false;
 bool MeOption::regreadAtReturn = true;
+uint32 MeOption::jobs = 1;
+uint32 MeOption::memPoolHighWater = 0;
+uint32 MeOption::semiNCAThreshold = 1000;
 
 void MeOption::SplitPhases(const std::string &str, std::unordered_set<std::string> &set) const {
   std::string s{str};
@@ -25,6 +25,13 @@
 #include "me_bb_layout.h"
 #include "me_emit.h"
 #include "me_rc_lowering.h"
+#include "me_rc_opt.h"
+#include "me_copy_prop.h"
+#include "me_gvn.h"
+#include "me_bce.h"
+#include "me_null_check_opt.h"
+#include "me_dse.h"
+#include "me_clinit_opt.h"
 #include "gen_check_cast.h"
 #include "me_ssa_tab.h"
 #include "mpl_timer.h"
@@ -91,7 +98,14 @@ void MeFuncPhaseManager::AddPhases(const std::unordered_set<std::string> &skipPh
     addPhase("ssaTab");
     addPhase("aliasclass");
     addPhase("ssa");
+    addPhase("copyprop");
+    addPhase("gvn");
+    addPhase("bce");
+    addPhase("nullcheckopt");
+    addPhase("dse");
+    addPhase("clinitopt");
     addPhase("rclowering");
+    addPhase("rcopt");
     addPhase("emit");
   }
 }
@@ -106,15 +120,69 @@ bool MeFuncPhaseManager::FuncFilter(const std::string &filter, const std::string
 
 void MeFuncPhaseManager::IPACleanUp(MeFunction *func) {
   GetAnalysisResultManager()->InvalidAllResults();
-  memPoolCtrler.DeleteMemPool(func->GetMemPool());
+  CurMemPoolCtrler().DeleteMemPool(func->GetMemPool());
+}
+
+MeFuncPhaseManager *MeFuncPhaseManager::Clone(MemPool &memPool) const {
+  MeFuncPhaseManager *fpm = memPool.New<MeFuncPhaseManager>(&memPool, mirModule, modResMgr);
+  fpm->RegisterFuncPhases();
+  fpm->SetMePhase(mePhaseType);
+  fpm->SetGenMeMpl(genMeMpl);
+  fpm->SetTimePhases(timePhases);
+  for (PhaseID id : phaseSequences) {
+    fpm->phaseSequences.push_back(id);
+    fpm->phaseTimers.push_back(0);
+  }
+  return fpm;
+}
+
+// one step of the phase loops in Run; like there, phases run again after a cfg change are not timed
+void MeFuncPhaseManager::RunPhaseAt(MeFunction &func, size_t phaseIndex, const std::string &prevPhaseName,
+                                    bool secondTime) {
+  ASSERT(phaseIndex < phaseSequences.size(), "phase index out of range");
+  MeFuncPhase *p = GetPhaseAt(phaseIndex);
+  p->SetPreviousPhaseName(prevPhaseName);
+  std::string phaseName = p->PhaseName();
+  bool dumpPhase = MeOption::DumpPhase(phaseName);
+  MPLTimer timer;
+  timer.Start();
+  RunFuncPhase(&func, p);
+  if (timePhases && !secondTime) {
+    timer.Stop();
+    phaseTimers[phaseIndex] += timer.ElapsedMicroseconds();
+  }
+  if ((MeOption::dumpAfter || dumpPhase) && FuncFilter(MeOption::dumpFunc, func.GetName())) {
+    const std::string prefix = secondTime ? ">>>>> Second time" : ">>>>>";
+    LogInfo::MapleLogger() << prefix << " Dump after " << phaseName << " <<<<<\n";
+    if (phaseName != "emit") {
+      func.Dump(false);
+    }
+    LogInfo::MapleLogger() << prefix << " Dump after End <<<<<\n\n";
+  }
+}
+
+bool MeFuncPhaseManager::PhaseWritesLog(const MeFunction &func, size_t phaseIndex) {
+  ASSERT(phaseIndex < phaseSequences.size(), "phase index out of range");
+  if (!MeOption::quiet) {
+    return true;
+  }
+  // the dependent phases run from inside this one check their own names against dumpPhases
+  return (MeOption::dumpAfter || !MeOption::dumpPhases.empty()) && FuncFilter(MeOption::dumpFunc, func.GetName());
+}
+
+void MeFuncPhaseManager::AccumulateTimers(const MeFuncPhaseManager &other) {
+  ASSERT(other.phaseTimers.size() == phaseTimers.size(), "phase sequences differ");
+  for (size_t i = 0; i < phaseTimers.size(); ++i) {
+    phaseTimers[i] += other.phaseTimers[i];
+  }
 }
 
 void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::string &meInput) {
   if (!MeOption::quiet)
     LogInfo::MapleLogger() << ">>>>>>>>>>>>>>>>>>>>>>>>>>>>> Optimizing Function  < " << mirFunc->GetName()
                            << " id=" << mirFunc->GetPuidxOrigin() << " >---\n";
-  MemPool *funcMP = memPoolCtrler.NewMemPool("maple_me per-function mempool");
-  MemPool *versMP = memPoolCtrler.NewMemPool("first verst mempool");
+  MemPool *funcMP = CurMemPoolCtrler().NewMemPool("maple_me per-function mempool");
+  MemPool *versMP = CurMemPoolCtrler().NewMemPool("first verst mempool");
   MeFunction func(&mirModule, mirFunc, funcMP, versMP, meInput);
   func.PartialInit(false);
 #if DEBUG
@@ -164,7 +232,7 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
       CHECK_FATAL(false, "phases in ipa will not chang cfg.");
     }
     // do all the phases start over
-    MemPool *versMemPool = memPoolCtrler.NewMemPool("second verst mempool");
+    MemPool *versMemPool = CurMemPoolCtrler().NewMemPool("second verst mempool");
     MeFunction function(&mirModule, mirFunc, funcMP, versMemPool, meInput);
     function.PartialInit(true);
     function.Prepare(rangeNum);
@@ -189,7 +257,7 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
     GetAnalysisResultManager()->InvalidAllResults();
   }
   if (!ipa) {
-    memPoolCtrler.DeleteMemPool(funcMP);
+    CurMemPoolCtrler().DeleteMemPool(funcMP);
   }
 }
 }  // namespace maple
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_rc_opt.h"
+#include <algorithm>
+#include "me_option.h"
+
+// An IncRef followed by a DecRef of the same object may only be removed if nothing in between
+// can release the object: the IncRef is what keeps it alive until the DecRef. Nor may anything
+// in between throw: the handler or the unwinder would then release the references taken on
+// both sides of the pair. A DecRef followed by an IncRef of the same object is removed under the
+// same conditions; the DecRef can not have released the object, or the IncRef would have used it
+// after it was freed. The versions rclowering gives the operands of these calls do not tell the
+// value they read (a DecRef of the value a dassign overwrites names the version the dassign
+// defines), so both the pairing and the null data flow work on symbols: the emitter maps all
+// versions of a symbol back to the symbol.
+namespace maple {
+namespace {
+bool IsRCIntrinsic(const MeStmt &stmt, MIRIntrinsicID intrnID) {
+  return stmt.GetOp() == OP_intrinsiccall && static_cast<const IntrinsiccallMeStmt&>(stmt).GetIntrinsic() == intrnID &&
+         stmt.NumMeStmtOpnds() == 1;
+}
+
+size_t OstIdxOf(MeExpr &expr) {
+  if (expr.GetMeOp() == kMeOpVar) {
+    return static_cast<VarMeExpr&>(expr).GetOStIdx().idx;
+  }
+  return static_cast<RegMeExpr&>(expr).GetOstIdx().idx;
+}
+
+void CollectDefinedOsts(MeStmt &stmt, std::vector<size_t> &defined) {
+  if (stmt.GetVarLHS() != nullptr) {
+    defined.push_back(OstIdxOf(*stmt.GetVarLHS()));
+  }
+  if (stmt.GetRegLHS() != nullptr) {
+    defined.push_back(OstIdxOf(*stmt.GetRegLHS()));
+  }
+  MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+  if (chiList != nullptr) {
+    for (auto &chiPair : *chiList) {
+      defined.push_back(chiPair.first.idx);
+    }
+  }
+  MapleVector<MustDefMeNode> *mustDefList = stmt.GetMustDefList();
+  if (mustDefList != nullptr) {
+    for (MustDefMeNode &mustDef : *mustDefList) {
+      defined.push_back(OstIdxOf(*mustDef.GetLHS()));
+    }
+  }
+}
+
+// conservative: ireads may raise NullPointerException, allocations OutOfMemoryError
+bool MayThrow(MeExpr &expr) {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+    case kMeOpConst:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+    case kMeOpSizeoftype:
+    case kMeOpFieldsDist:
+      return false;
+    case kMeOpOp: {
+      if ((expr.GetOp() == OP_div || expr.GetOp() == OP_rem) && IsPrimitiveInteger(expr.GetPrimType())) {
+        return true;
+      }
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        if (expr.GetOpnd(i) != nullptr && MayThrow(*expr.GetOpnd(i))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return true;
+  }
+}
+}  // namespace
+
+// localrefvars are null on entry; pregs are tracked so that the backups rclowering makes of
+// the values it releases are known to be null when the variable backed up is
+void MeRCOpt::CollectNullableVars() {
+  nullableIdx.assign(ssaTab.GetOriginalStTableSize(), -1);
+  for (size_t i = 0; i < ssaTab.GetOriginalStTableSize(); ++i) {
+    const OriginalSt *ost = ssaTab.GetOriginalStFromID(OStIdx(i));
+    if (ost == nullptr) {
+      continue;
+    }
+    if (ost->IsPregOst()) {
+      if (ost->GetPregIdx() >= 0) {
+        nullableIdx[i] = static_cast<int>(nullOnEntry.size());
+        nullOnEntry.push_back(false);
+      }
+      continue;
+    }
+    if (!ost->IsSymbolOst() || ost->GetFieldID() != 0) {
+      continue;
+    }
+    const MIRSymbol *sym = ost->GetMIRSymbol();
+    if (sym->GetStorageClass() == kScAuto && sym->GetAttr(ATTR_localrefvar)) {
+      nullableIdx[i] = static_cast<int>(nullOnEntry.size());
+      nullOnEntry.push_back(true);
+    }
+  }
+  numNullableVars = nullOnEntry.size();
+}
+
+// update isNull, indexed by nullable idx, for the variables and registers stmt assigns
+void MeRCOpt::TransferNull(MeStmt &stmt, std::vector<bool> &isNull) const {
+  bool assignsNull = (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) && IsNull(*stmt.GetRHS(), isNull);
+  std::vector<size_t> defined;
+  CollectDefinedOsts(stmt, defined);
+  for (size_t ostIdx : defined) {
+    if (nullableIdx[ostIdx] >= 0) {
+      isNull[nullableIdx[ostIdx]] = false;
+    }
+  }
+  if (assignsNull) {
+    MeExpr *lhs = stmt.GetOp() == OP_dassign ? static_cast<MeExpr*>(stmt.GetVarLHS()) : stmt.GetRegLHS();
+    int idx = nullableIdx[OstIdxOf(*lhs)];
+    if (idx >= 0) {
+      isNull[idx] = true;
+    }
+  }
+}
+
+// forward must data flow: a variable is null at the entry of a bb if it is null at the exit of
+// all its predecessors; a handler may be entered from anywhere in a try bb, so for a handler it
+// must also be null at the entry of the predecessor and not be assigned in it
+void MeRCOpt::ComputeNullVars() {
+  size_t bbNum = func.GetAllBBs().size();
+  nullAtEntry.assign(bbNum, std::vector<bool>(numNullableVars, true));
+  nullAtExit.assign(bbNum, std::vector<bool>(numNullableVars, true));
+  std::vector<std::vector<bool>> nullThroughout(bbNum, std::vector<bool>(numNullableVars, true));
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto eIt = func.valid_end();
+    for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+      BB *bb = *bIt;
+      if (bb == func.GetCommonEntryBB() || bb == func.GetCommonExitBB()) {
+        continue;
+      }
+      std::vector<bool> isNull = nullOnEntry;
+      if (bb != func.GetFirstBB() && !bb->GetPred().empty()) {
+        isNull.assign(numNullableVars, true);
+      }
+      for (BB *pred : bb->GetPred()) {
+        if (pred == func.GetCommonEntryBB()) {
+          continue;
+        }
+        const std::vector<bool> &predNull =
+            bb->GetAttributes(kBBAttrIsCatch) ? nullThroughout[pred->GetBBId()] : nullAtExit[pred->GetBBId()];
+        for (size_t i = 0; i < numNullableVars; ++i) {
+          isNull[i] = isNull[i] && predNull[i];
+        }
+      }
+      BBId bbID = bb->GetBBId();
+      if (isNull != nullAtEntry[bbID]) {
+        nullAtEntry[bbID] = isNull;
+        changed = true;
+      }
+      std::vector<bool> throughout = isNull;
+      for (auto &stmt : bb->GetMeStmts()) {
+        TransferNull(stmt, isNull);
+        for (size_t i = 0; i < numNullableVars; ++i) {
+          throughout[i] = throughout[i] && isNull[i];
+        }
+      }
+      if (isNull != nullAtExit[bbID] || throughout != nullThroughout[bbID]) {
+        nullAtExit[bbID] = isNull;
+        nullThroughout[bbID] = throughout;
+        changed = true;
+      }
+    }
+  }
+}
+
+// true if expr is known to be null where it is read
+bool MeRCOpt::IsNull(MeExpr &expr, const std::vector<bool> &isNull) const {
+  if (expr.GetMeOp() == kMeOpConst) {
+    return static_cast<ConstMeExpr&>(expr).IsZero();
+  }
+  if (expr.GetMeOp() != kMeOpVar && expr.GetMeOp() != kMeOpReg) {
+    return false;
+  }
+  int idx = nullableIdx[OstIdxOf(expr)];
+  return idx >= 0 && isNull[idx];
+}
+
+// true if stmt can neither throw nor change a reference count
+bool MeRCOpt::IsTransparent(MeStmt &stmt) const {
+  switch (stmt.GetOp()) {
+    case OP_comment:
+    case OP_goto:
+      return true;
+    case OP_dassign:
+    case OP_regassign:
+      return !MayThrow(*stmt.GetRHS());
+    default:
+      return false;
+  }
+}
+
+// drop the entries of pending whose operand is a symbol stmt assigns
+void MeRCOpt::KillRedefined(MeStmt &stmt, std::vector<IntrinsiccallMeStmt*> &pending) const {
+  if (pending.empty()) {
+    return;
+  }
+  std::vector<size_t> defined;
+  CollectDefinedOsts(stmt, defined);
+  auto isRedefined = [&defined](IntrinsiccallMeStmt *rcStmt) {
+    return std::find(defined.begin(), defined.end(), OstIdxOf(*rcStmt->GetOpnd(0))) != defined.end();
+  };
+  pending.erase(std::remove_if(pending.begin(), pending.end(), isRedefined), pending.end());
+}
+
+// remove stmt together with the entry of pending on the same variable or register, if there is one
+bool MeRCOpt::CancelPending(IntrinsiccallMeStmt &stmt, std::vector<IntrinsiccallMeStmt*> &pending) {
+  size_t ostIdx = OstIdxOf(*stmt.GetOpnd(0));
+  auto it = std::find_if(pending.rbegin(), pending.rend(),
+                         [ostIdx](IntrinsiccallMeStmt *rcStmt) { return OstIdxOf(*rcStmt->GetOpnd(0)) == ostIdx; });
+  if (it == pending.rend()) {
+    return false;
+  }
+  IntrinsiccallMeStmt *other = *it;
+  pending.erase(std::next(it).base());
+  other->GetBB()->RemoveMeStmt(other);
+  stmt.GetBB()->RemoveMeStmt(&stmt);
+  ++numPairsRemoved;
+  return true;
+}
+
+void MeRCOpt::OptimizeChain(BB &head) {
+  pendingIncs.clear();
+  pendingDecs.clear();
+  BB *bb = &head;
+  while (true) {
+    visited[bb->GetBBId()] = true;
+    std::vector<bool> isNull = nullAtEntry[bb->GetBBId()];
+    auto &meStmts = bb->GetMeStmts();
+    for (auto it = meStmts.begin(); it != meStmts.end();) {
+      MeStmt &stmt = *it;
+      ++it;
+      bool isInc = IsRCIntrinsic(stmt, INTRN_MCCIncRef);
+      bool isDec = IsRCIntrinsic(stmt, INTRN_MCCDecRef);
+      if (!isInc && !isDec) {
+        TransferNull(stmt, isNull);
+        if (IsTransparent(stmt)) {
+          KillRedefined(stmt, pendingIncs);
+          KillRedefined(stmt, pendingDecs);
+        } else {
+          pendingIncs.clear();
+          pendingDecs.clear();
+        }
+        continue;
+      }
+      auto &rcStmt = static_cast<IntrinsiccallMeStmt&>(stmt);
+      MeExpr *opnd = rcStmt.GetOpnd(0);
+      if (IsNull(*opnd, isNull)) {
+        bb->RemoveMeStmt(&stmt);
+        ++numNullOpsRemoved;
+        continue;
+      }
+      bool pairable = opnd->GetMeOp() == kMeOpVar || opnd->GetMeOp() == kMeOpReg;
+      if (isInc) {
+        if (pairable && !CancelPending(rcStmt, pendingDecs)) {
+          pendingIncs.push_back(&rcStmt);
+        }
+        continue;
+      }
+      if (pairable && CancelPending(rcStmt, pendingIncs)) {
+        continue;
+      }
+      // the object released may be the one an earlier IncRef keeps alive
+      pendingIncs.clear();
+      if (pairable) {
+        pendingDecs.push_back(&rcStmt);
+      }
+    }
+    if (bb->GetSucc().size() != 1) {
+      break;
+    }
+    BB *succ = bb->GetSucc(0);
+    if (succ == func.GetCommonExitBB() || succ->GetPred().size() != 1 || visited[succ->GetBBId()]) {
+      break;
+    }
+    bb = succ;
+  }
+}
+
+void MeRCOpt::Run() {
+  CollectNullableVars();
+  ComputeNullVars();
+  visited.assign(func.GetAllBBs().size(), false);
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bb == func.GetCommonEntryBB() || bb == func.GetCommonExitBB() || visited[bb->GetBBId()]) {
+      continue;
+    }
+    // start chains at their first bb; the rest of a chain is visited from there
+    if (bb->GetPred().size() == 1 && bb->GetPred(0)->GetSucc().size() == 1 &&
+        bb->GetPred(0) != func.GetCommonEntryBB()) {
+      continue;
+    }
+    OptimizeChain(*bb);
+  }
+  // what remains are cycles of such bbs
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bb != func.GetCommonEntryBB() && bb != func.GetCommonExitBB() && !visited[bb->GetBBId()]) {
+      OptimizeChain(*bb);
+    }
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "rcopt of " << func.GetName() << ": " << numPairsRemoved
+                           << " IncRef/DecRef pairs and " << numNullOpsRemoved << " operations on null removed\n";
+  }
+}
+
+AnalysisResult *MeDoRCOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MeRCOpt rcOpt(*func, DEBUGFUNC(func));
+  rcOpt.Run();
+  if (DEBUGFUNC(func)) {
+    LogInfo::MapleLogger() << "\n============== After RC OPT =============" << '\n';
+    func->Dump(false);
+  }
+  return nullptr;
+}
+}  // namespace maple
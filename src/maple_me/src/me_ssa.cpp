@@ -31,6 +31,8 @@
    A definition of x in block b forces a phi-node at every node in b's
    dominance frontiers. Since that phi-node is a new definition of x,
    it may, in turn, force the insertion of additional phi-node.
+   The phi-node is only inserted if x is live on entry to the block
+   (pruned SSA); otherwise no use could ever see its result.
 
    Step 2: Renaming.
    Renames both definitions and uses of each symbol in
@@ -47,18 +49,117 @@
    the state that existed before the current block was visited.
  */
 namespace maple {
+namespace {
+// Records, for each ost, the BBs where it is used before any must-def in the same BB (an upward exposed
+// use, so the ost is live on entry) and the BBs that must-define it. May-defs read the previous version
+// through their chi operands, so they count as uses and do not kill.
+class UseAndKillCollector {
+ public:
+  UseAndKillCollector(SSATab &ssaTab, size_t ostNum, std::vector<std::vector<BBId>> &useBBs,
+                      std::vector<std::vector<BBId>> &killBBs)
+      : ssaTab(ssaTab), useBBs(useBBs), killBBs(killBBs), killedIn(ostNum, 0), usedIn(ostNum, 0) {}
+  ~UseAndKillCollector() = default;
+
+  void VisitBB(BB &bb) {
+    curBB = bb.GetBBId();
+    curStamp = static_cast<uint32>(curBB) + 1;
+    for (auto &stmt : bb.GetStmtNodes()) {
+      VisitStmt(stmt);
+    }
+  }
+
+ private:
+  void NoteUse(size_t ostIdx) {
+    if (killedIn[ostIdx] == curStamp || usedIn[ostIdx] == curStamp) {
+      return;
+    }
+    usedIn[ostIdx] = curStamp;
+    useBBs[ostIdx].push_back(curBB);
+  }
+
+  void NoteKill(size_t ostIdx) {
+    if (killedIn[ostIdx] == curStamp) {
+      return;
+    }
+    killedIn[ostIdx] = curStamp;
+    killBBs[ostIdx].push_back(curBB);
+  }
+
+  // mirrors the operands SSA::RenameExpr renames
+  void VisitExpr(BaseNode &expr) {
+    Opcode op = expr.GetOpCode();
+    if (op == OP_addrof || op == OP_dread) {
+      NoteUse(static_cast<AddrofSSANode&>(expr).GetSSAVar()->GetOrigIdx().idx);
+      return;
+    }
+    if (op == OP_regread) {
+      NoteUse(static_cast<RegreadSSANode&>(expr).GetSSAVar()->GetOrigIdx().idx);
+      return;
+    }
+    if (op == OP_iread) {
+      NoteUse(static_cast<IreadSSANode&>(expr).GetSSAVar()->GetOrigIdx().idx);
+    }
+    for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+      VisitExpr(*expr.Opnd(i));
+    }
+  }
+
+  void VisitStmt(StmtNode &stmt) {
+    Opcode op = stmt.GetOpCode();
+    if (kOpcodeInfo.HasSSAUse(op)) {
+      for (auto &mayUse : ssaTab.GetStmtsSSAPart().GetMayUseNodesOf(stmt)) {
+        NoteUse(mayUse.first.idx);
+      }
+    }
+    for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+      VisitExpr(*stmt.Opnd(i));
+    }
+    if (op == OP_regassign) {
+      return;
+    }
+    if (kOpcodeInfo.HasSSADef(op)) {
+      for (auto &mayDef : ssaTab.GetStmtsSSAPart().GetMayDefNodesOf(stmt)) {
+        NoteUse(mayDef.first.idx);
+      }
+    }
+    if (op == OP_dassign) {
+      NoteKill(ssaTab.GetStmtsSSAPart().GetAssignedVarOf(stmt)->GetOrigIdx().idx);
+    } else if (kOpcodeInfo.IsCallAssigned(op)) {
+      for (MustDefNode &mustDef : ssaTab.GetStmtsSSAPart().GetMustDefNodesOf(stmt)) {
+        NoteKill(mustDef.GetResult()->GetOrigIdx().idx);
+      }
+    }
+  }
+
+  SSATab &ssaTab;
+  std::vector<std::vector<BBId>> &useBBs;
+  std::vector<std::vector<BBId>> &killBBs;
+  std::vector<uint32> killedIn;  // index is OStIdx; stamp of the BB being visited once killed in it
+  std::vector<uint32> usedIn;    // index is OStIdx; stamp of the BB being visited once recorded as used
+  BBId curBB = BBId(0);
+  uint32 curStamp = 0;
+};
+}  // namespace
+
 void MeSSA::BuildSSA() {
   InsertPhiNode();
   InitRenameStack(func->GetMeSSATab()->GetOriginalStTable(), func->GetAllBBs().size(),
                   func->GetMeSSATab()->GetVersionStTable());
   // recurse down dominator tree in pre-order traversal
-  const MapleSet<BBId> &children = dom->GetDomChildren(func->GetCommonEntryBB()->GetBBId());
+  BBIdRange children = dom->GetDomChildren(func->GetCommonEntryBB()->GetBBId());
   for (const auto &child : children) {
     RenameBB(*func->GetBBFromID(child));
   }
 }
 
-void MeSSA::CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs) {
+// BBs are visited in increasing id order, so each list only has to be checked against its last entry
+void MeSSA::CollectDefBBs(OStBBLists &ostDefBBs) {
+  auto addDefBB = [&ostDefBBs](OStIdx ostIdx, BBId bbId) {
+    std::vector<BBId> &defBBs = ostDefBBs[ostIdx.idx];
+    if (defBBs.empty() || defBBs.back() != bbId) {
+      defBBs.push_back(bbId);
+    }
+  };
   auto eIt = func->valid_end();
   for (auto bIt = func->valid_begin(); bIt != eIt; ++bIt) {
     auto *bb = *bIt;
@@ -69,11 +170,11 @@ void MeSSA::CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs) {
         for (iter = mayDefs.begin(); iter != mayDefs.end(); ++iter) {
           const OriginalSt *ost = func->GetMeSSATab()->GetOriginalStFromID(iter->first);
           if (ost != nullptr && (!ost->IsFinal() || func->GetMirFunc()->IsConstructor())) {
-            ostDefBBs[iter->first].insert(bb->GetBBId());
+            addDefBB(iter->first, bb->GetBBId());
           } else if (stmt.GetOpCode() == OP_intrinsiccallwithtype) {
             auto &inNode = static_cast<IntrinsiccallNode&>(stmt);
             if (inNode.GetIntrinsic() == INTRN_JAVA_CLINIT_CHECK) {
-              ostDefBBs[iter->first].insert(bb->GetBBId());
+              addDefBB(iter->first, bb->GetBBId());
             }
           }
         }
@@ -81,7 +182,7 @@ void MeSSA::CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs) {
           VersionSt *vst = GetSSATab()->GetStmtsSSAPart().GetAssignedVarOf(stmt);
           OriginalSt *ost = vst->GetOrigSt();
           if (ost != nullptr && (!ost->IsFinal() || func->GetMirFunc()->IsConstructor())) {
-            ostDefBBs[vst->GetOrigIdx()].insert(bb->GetBBId());
+            addDefBB(vst->GetOrigIdx(), bb->GetBBId());
           }
         }
       }
@@ -91,7 +192,7 @@ void MeSSA::CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs) {
         for (iter = mustDefs.begin(); iter != mustDefs.end(); ++iter) {
           OriginalSt *ost = iter->GetResult()->GetOrigSt();
           if (ost != nullptr && (!ost->IsFinal() || func->GetMirFunc()->IsConstructor())) {
-            ostDefBBs[ost->GetIndex()].insert(bb->GetBBId());
+            addDefBB(ost->GetIndex(), bb->GetBBId());
           }
         }
       }
@@ -99,47 +200,101 @@ void MeSSA::CollectDefBBs(std::map<OStIdx, std::set<BBId>> &ostDefBBs) {
   }
 }
 
+void MeSSA::CollectUseAndKillBBs(OStBBLists &ostUseBBs, OStBBLists &ostKillBBs) {
+  UseAndKillCollector collector(*GetSSATab(), ostUseBBs.size(), ostUseBBs, ostKillBBs);
+  auto eIt = func->valid_end();
+  for (auto bIt = func->valid_begin(); bIt != eIt; ++bIt) {
+    collector.VisitBB(**bIt);
+  }
+}
+
+// mark the BBs where the ost is live on entry: walk backwards from its upward exposed uses, stopping at
+// BBs that must-define it
+void MeSSA::ComputeLiveInBBs(const std::vector<BBId> &useBBs, const std::vector<BBId> &killBBs, uint32 stamp,
+                             std::vector<uint32> &killStamp, std::vector<uint32> &liveInStamp,
+                             std::vector<BBId> &workList) const {
+  for (BBId bbId : killBBs) {
+    killStamp[bbId] = stamp;
+  }
+  workList.clear();
+  for (BBId bbId : useBBs) {
+    liveInStamp[bbId] = stamp;
+    workList.push_back(bbId);
+  }
+  while (!workList.empty()) {
+    BB *bb = func->GetBBFromID(workList.back());
+    workList.pop_back();
+    for (BB *pred : bb->GetPred()) {
+      BBId predId = pred->GetBBId();
+      if (liveInStamp[predId] != stamp && killStamp[predId] != stamp) {
+        liveInStamp[predId] = stamp;
+        workList.push_back(predId);
+      }
+    }
+  }
+}
+
 void MeSSA::InsertPhiNode() {
-  std::map<OStIdx, std::set<BBId>> ost2DefBBs;
-  CollectDefBBs(ost2DefBBs);
   OriginalStTable *otable = &func->GetMeSSATab()->GetOriginalStTable();
+  OStBBLists ost2DefBBs(otable->Size());
+  CollectDefBBs(ost2DefBBs);
+  OStBBLists ost2UseBBs(otable->Size());
+  OStBBLists ost2KillBBs(otable->Size());
+  CollectUseAndKillBBs(ost2UseBBs, ost2KillBBs);
+  // per-BB marks hold the index of the ost they were set for, so they never need clearing
+  size_t bbNum = func->GetAllBBs().size();
+  std::vector<uint32> killStamp(bbNum, 0);
+  std::vector<uint32> liveInStamp(bbNum, 0);
+  std::vector<uint32> phiStamp(bbNum, 0);
+  std::vector<BBId> liveWorkList;
+  std::vector<BB*> workList;
   for (size_t i = 1; i < otable->Size(); ++i) {
     OriginalSt *ost = otable->GetOriginalStFromID(OStIdx(i));
     VersionSt *vst = func->GetMeSSATab()->GetVersionStTable().GetVersionStFromID(ost->GetZeroVersionIndex(), true);
     CHECK_FATAL(vst != nullptr, "null ptr check");
-    if (ost2DefBBs[ost->GetIndex()].empty()) {
+    const std::vector<BBId> &defBBs = ost2DefBBs[ost->GetIndex().idx];
+    if (defBBs.empty()) {
       continue;
     }
     // volatile variables will not have ssa form.
     if (ost->IsVolatile()) {
       continue;
     }
-    std::deque<BB*> *workList = new std::deque<BB*>();
-    for (auto it = ost2DefBBs[ost->GetIndex()].begin(); it != ost2DefBBs[ost->GetIndex()].end(); ++it) {
-      BB *defBB = func->GetAllBBs()[*it];
+    uint32 stamp = static_cast<uint32>(i);
+    bool liveInComputed = false;
+    workList.clear();
+    for (BBId bbId : defBBs) {
+      BB *defBB = func->GetAllBBs()[bbId];
       if (defBB != nullptr) {
-        workList->push_back(defBB);
+        workList.push_back(defBB);
       }
     }
-    while (!workList->empty()) {
-      BB *defBB = workList->front();
-      workList->pop_front();
-      MapleSet<BBId> &dfs = dom->GetDomFrontier(defBB->GetBBId());
-      for (auto &bbID : dfs) {
+    // the iterated dominance frontier is always followed in full; only the phis are pruned
+    for (size_t head = 0; head < workList.size(); ++head) {
+      BB *defBB = workList[head];
+      for (BBId bbID : dom->GetDomFrontier(defBB->GetBBId())) {
+        if (phiStamp[bbID] == stamp) {
+          continue;
+        }
+        phiStamp[bbID] = stamp;
         BB *dfBB = func->GetBBFromID(bbID);
         CHECK_FATAL(dfBB != nullptr, "null ptr check");
-        if (dfBB->PhiofVerStInserted(*vst) == nullptr) {
-          workList->push_back(dfBB);
-          dfBB->InsertPhi(&func->GetAlloc(), vst);
-          if (enabledDebug) {
-            ost->Dump();
-            LogInfo::MapleLogger() << " Defined In: BB" << defBB->GetBBId() << " Insert Phi Here: BB"
-                                   << dfBB->GetBBId() << '\n';
-          }
+        workList.push_back(dfBB);
+        if (!liveInComputed) {
+          ComputeLiveInBBs(ost2UseBBs[i], ost2KillBBs[i], stamp, killStamp, liveInStamp, liveWorkList);
+          liveInComputed = true;
+        }
+        if (liveInStamp[bbID] != stamp) {
+          continue;
+        }
+        dfBB->InsertPhi(&func->GetAlloc(), vst);
+        if (enabledDebug) {
+          ost->Dump();
+          LogInfo::MapleLogger() << " Defined In: BB" << defBB->GetBBId() << " Insert Phi Here: BB"
+                                 << dfBB->GetBBId() << '\n';
         }
       }
     }
-    delete workList;
   }
 }
 
@@ -153,12 +308,8 @@ void MeSSA::RenameBB(BB &bb) {
 
   SetBBRenamed(bb.GetBBId(), true);
 
-  // record stack size for variable versions before processing rename. It is used for stack pop up.
-  std::vector<uint32> oriStackSize;
-  oriStackSize.resize(GetVstStacks().size());
-  for (size_t i = 1; i < GetVstStacks().size(); ++i) {
-    oriStackSize[i] = GetVstStack(i)->size();
-  }
+  // record the height of the rename stacks before processing rename. It is used for stack pop up.
+  size_t stackMark = GetVstStackMark();
   RenamePhi(bb);
   for (auto &stmt : bb.GetStmtNodes()) {
     RenameUses(stmt);
@@ -168,15 +319,11 @@ void MeSSA::RenameBB(BB &bb) {
   RenamePhiUseInSucc(bb);
   // Rename child in Dominator Tree.
   ASSERT(bb.GetBBId() < dom->GetDomChildrenSize(), "index out of range in MeSSA::RenameBB");
-  const MapleSet<BBId> &children = dom->GetDomChildren(bb.GetBBId());
+  BBIdRange children = dom->GetDomChildren(bb.GetBBId());
   for (const BBId &child : children) {
     RenameBB(*func->GetBBFromID(child));
   }
-  for (size_t i = 1; i < GetVstStacks().size(); ++i) {
-    while (GetVstStack(i)->size() > oriStackSize[i]) {
-      PopVersionSt(i);
-    }
-  }
+  PopVstStacksTo(stackMark);
 }
 
 bool MeSSA::VerifySSAOpnd(const BaseNode &node) const {
@@ -22,29 +22,49 @@
 // phi operands.
 namespace maple {
 // accumulate the BBs that are in the iterated dominance frontiers of bb in
-// the set dfSet, visiting each BB only once
-void MeSSAUpdate::GetIterDomFrontier(const BB &bb, MapleSet<BBId> &dfSet, std::vector<bool> &visitedMap) {
-  CHECK_FATAL(bb.GetBBId() < visitedMap.size(), "index out of range in MeSSAUpdate::GetIterDomFrontier");
-  if (visitedMap[bb.GetBBId()]) {
+// dfBBs, visiting each BB only once; visitStamp marks the BBs visited and
+// dfStamp those already in dfBBs for the candidate numbered stamp
+void MeSSAUpdate::GetIterDomFrontier(const BB &bb, std::vector<BBId> &dfBBs, std::vector<uint32> &visitStamp,
+                                     std::vector<uint32> &dfStamp, uint32 stamp) {
+  CHECK_FATAL(bb.GetBBId() < visitStamp.size(), "index out of range in MeSSAUpdate::GetIterDomFrontier");
+  if (visitStamp[bb.GetBBId()] == stamp) {
     return;
   }
-  visitedMap[bb.GetBBId()] = true;
-  for (auto frontierBBId : dom.GetDomFrontier(bb.GetBBId())) {
-    dfSet.insert(frontierBBId);
-    BB *frontierBB = func.GetBBFromID(frontierBBId);
-    GetIterDomFrontier(*frontierBB, dfSet, visitedMap);
+  visitStamp[bb.GetBBId()] = stamp;
+  std::vector<BBId> workList(1, bb.GetBBId());
+  while (!workList.empty()) {
+    BBId cur = workList.back();
+    workList.pop_back();
+    for (BBId frontierBBId : dom.GetDomFrontier(cur)) {
+      if (dfStamp[frontierBBId] != stamp) {
+        dfStamp[frontierBBId] = stamp;
+        dfBBs.push_back(frontierBBId);
+      }
+      if (visitStamp[frontierBBId] != stamp) {
+        visitStamp[frontierBBId] = stamp;
+        workList.push_back(frontierBBId);
+      }
+    }
   }
 }
 
+void MeSSAUpdate::PushRenameStack(OStIdx ostIdx, VarMeExpr &var) {
+  renameStackLog.emplace_back(ostIdx, renameStackTops[ostIdx.idx]);
+  renameStackTops[ostIdx.idx] = &var;
+}
+
 void MeSSAUpdate::InsertPhis() {
-  MapleSet<BBId> dfSet(std::less<BBId>(), ssaUpdateAlloc.Adapter());
+  std::vector<BBId> dfBBs;
+  std::vector<uint32> visitStamp(func.GetAllBBs().size(), 0);
+  std::vector<uint32> dfStamp(func.GetAllBBs().size(), 0);
+  uint32 stamp = 0;
   for (auto it = updateCands.begin(); it != updateCands.end(); ++it) {
-    std::vector<bool> visitedMap(func.GetAllBBs().size(), false);
-    dfSet.clear();
+    ++stamp;
+    dfBBs.clear();
     for (const auto &bbId : *it->second) {
-      GetIterDomFrontier(*func.GetBBFromID(bbId), dfSet, visitedMap);
+      GetIterDomFrontier(*func.GetBBFromID(bbId), dfBBs, visitStamp, dfStamp, stamp);
     }
-    for (const auto &bbId : dfSet) {
+    for (const auto &bbId : dfBBs) {
       // insert a phi node
       BB *bb = func.GetBBFromID(bbId);
       ASSERT(bb != nullptr, "null ptr check");
@@ -58,26 +78,24 @@ void MeSSAUpdate::InsertPhis() {
       phiMeNode->GetOpnds().resize(bb->GetPred().size());
       bb->GetMevarPhiList().insert(std::make_pair(it->first, phiMeNode));
     }
-    // initialize its rename stack
-    renameStacks[it->first] = ssaUpdateMp.New<MapleStack<VarMeExpr*>>(ssaUpdateAlloc.Adapter());
   }
 }
 
 void MeSSAUpdate::RenamePhi(BB &bb) {
-  for (auto it1 = renameStacks.begin(); it1 != renameStacks.end(); ++it1) {
-    auto it2 = bb.GetMevarPhiList().find(it1->first);
-    if (it2 != bb.GetMevarPhiList().end()) {
-      // if there is existing phi result node
-      MeVarPhiNode *phi = it2->second;
-      phi->SetIsLive(true);  // always make it live, for correctness
-      if (phi->GetLHS() == nullptr) {
-        // create a new VarMeExpr defined by this phi
-        VarMeExpr *newVar = irMap.CreateNewVarMeExpr(it2->first, PTY_ref, 0);
-        phi->UpdateLHS(*newVar);
-        it1->second->push(newVar);  // push the stack
-      } else {
-        it1->second->push(phi->GetLHS());  // push the stack
-      }
+  for (auto it = bb.GetMevarPhiList().begin(); it != bb.GetMevarPhiList().end(); ++it) {
+    if (renameStackTops[it->first.idx] == nullptr) {
+      continue;  // not a candidate
+    }
+    // if there is existing phi result node
+    MeVarPhiNode *phi = it->second;
+    phi->SetIsLive(true);  // always make it live, for correctness
+    if (phi->GetLHS() == nullptr) {
+      // create a new VarMeExpr defined by this phi
+      VarMeExpr *newVar = irMap.CreateNewVarMeExpr(it->first, PTY_ref, 0);
+      phi->UpdateLHS(*newVar);
+      PushRenameStack(it->first, *newVar);
+    } else {
+      PushRenameStack(it->first, *phi->GetLHS());
     }
   }
 }
@@ -88,13 +106,8 @@ MeExpr *MeSSAUpdate::RenameExpr(MeExpr &meExpr, bool &changed) {
   switch (meExpr.GetMeOp()) {
     case kMeOpVar: {
       auto &varExpr = static_cast<VarMeExpr&>(meExpr);
-      auto it1 = renameStacks.find(varExpr.GetOStIdx());
-      if (it1 == renameStacks.end()) {
-        return &meExpr;
-      }
-      MapleStack<VarMeExpr*> *renameStack = it1->second;
-      VarMeExpr *curVar = renameStack->top();
-      if (&varExpr == curVar) {
+      VarMeExpr *curVar = renameStackTops[varExpr.GetOStIdx().idx];
+      if (curVar == nullptr || &varExpr == curVar) {
         return &meExpr;
       }
       changed = true;
@@ -166,9 +179,8 @@ void MeSSAUpdate::RenameStmts(BB &bb) {
     MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
     if (chiList != nullptr) {
       for (const auto &chi : *chiList) {
-        auto it = renameStacks.find(chi.first);
-        if (it != renameStacks.end() && chi.second != nullptr) {
-          it->second->push(chi.second->GetLHS());
+        if (renameStackTops[chi.first.idx] != nullptr && chi.second != nullptr) {
+          PushRenameStack(chi.first, *chi.second->GetLHS());
         }
       }
     }
@@ -186,12 +198,10 @@ void MeSSAUpdate::RenameStmts(BB &bb) {
       continue;
     }
     CHECK_FATAL(lhsVar != nullptr, "stmt doesn't have lhs?");
-    auto it = renameStacks.find(lhsVar->GetOStIdx());
-    if (it == renameStacks.end()) {
+    if (renameStackTops[lhsVar->GetOStIdx().idx] == nullptr) {
       continue;
     }
-    MapleStack<VarMeExpr*> *renameStack = it->second;
-    renameStack->push(lhsVar);
+    PushRenameStack(lhsVar->GetOStIdx(), *lhsVar);
   }
 }
 
@@ -206,14 +216,12 @@ void MeSSAUpdate::RenamePhiOpndsInSucc(BB &bb) {
       ++index;
     }
     CHECK_FATAL(index < succ->GetPred().size(), "RenamePhiOpndsinSucc: cannot find corresponding pred");
-    for (auto it1 = renameStacks.begin(); it1 != renameStacks.end(); ++it1) {
-      auto it2 = succ->GetMevarPhiList().find(it1->first);
-      if (it2 == succ->GetMevarPhiList().end()) {
+    for (auto it = succ->GetMevarPhiList().begin(); it != succ->GetMevarPhiList().end(); ++it) {
+      VarMeExpr *curVar = renameStackTops[it->first.idx];
+      if (curVar == nullptr) {
         continue;
       }
-      MeVarPhiNode *phi = it2->second;
-      MapleStack<VarMeExpr*> *renameStack = it1->second;
-      VarMeExpr *curVar = renameStack->top();
+      MeVarPhiNode *phi = it->second;
       if (phi->GetOpnd(index) != curVar) {
         phi->SetOpnd(index, curVar);
       }
@@ -224,37 +232,31 @@ void MeSSAUpdate::RenamePhiOpndsInSucc(BB &bb) {
 void MeSSAUpdate::RenameBB(BB &bb) {
   // for recording stack height on entering this BB, to pop back to same height
   // when backing up the dominator tree
-  std::map<OStIdx, uint32> origStackSize((std::less<OStIdx>()));
-  for (auto it = renameStacks.begin(); it != renameStacks.end(); ++it) {
-    origStackSize[it->first] = it->second->size();
-  }
+  size_t stackMark = renameStackLog.size();
   RenamePhi(bb);
   RenameStmts(bb);
   RenamePhiOpndsInSucc(bb);
   // recurse down dominator tree in pre-order traversal
-  const MapleSet<BBId> &children = dom.GetDomChildren(bb.GetBBId());
+  BBIdRange children = dom.GetDomChildren(bb.GetBBId());
   for (const auto &child : children) {
     RenameBB(*func.GetBBFromID(child));
   }
   // pop stacks back to where they were at entry to this BB
-  for (auto it = renameStacks.begin(); it != renameStacks.end(); ++it) {
-    while (it->second->size() > origStackSize[it->first]) {
-      it->second->pop();
-    }
+  while (renameStackLog.size() > stackMark) {
+    renameStackTops[renameStackLog.back().first.idx] = renameStackLog.back().second;
+    renameStackLog.pop_back();
   }
 }
 
 void MeSSAUpdate::Run() {
   InsertPhis();
   // push zero-version varmeexpr nodes to rename stacks
-  for (auto it = renameStacks.begin(); it != renameStacks.end(); ++it) {
+  for (auto it = updateCands.begin(); it != updateCands.end(); ++it) {
     const OriginalSt *ost = ssaTab.GetSymbolOriginalStFromID(it->first);
-    VarMeExpr *zeroVersVar = irMap.GetOrCreateZeroVersionVarMeExpr(*ost);
-    MapleStack<VarMeExpr*> *renameStack = it->second;
-    renameStack->push(zeroVersVar);
+    renameStackTops[it->first.idx] = irMap.GetOrCreateZeroVersionVarMeExpr(*ost);
   }
   // recurse down dominator tree in pre-order traversal
-  const MapleSet<BBId> &children = dom.GetDomChildren(func.GetCommonEntryBB()->GetBBId());
+  BBIdRange children = dom.GetDomChildren(func.GetCommonEntryBB()->GetBBId());
   for (const auto &child : children) {
     RenameBB(*func.GetBBFromID(child));
   }
@@ -20,16 +20,15 @@
 
 namespace maple {
 void SSA::InitRenameStack(OriginalStTable &oTable, size_t bbSize, VersionStTable &verStTab) {
-  vstStacks.resize(oTable.Size());
+  vstStackTops.resize(oTable.Size(), nullptr);
+  vstStackLog.clear();
   vstVersions.resize(oTable.Size(), 0);
   bbRenamed.resize(bbSize, false);
   for (size_t i = 1; i < oTable.Size(); i++) {
-    MapleStack<VersionSt*> *vStack = ssaAlloc.GetMemPool()->New<MapleStack<VersionSt*>>(ssaAlloc.Adapter());
     const OriginalSt *ost = oTable.GetOriginalStFromID(OStIdx(i));
     VersionSt *temp = (ost->GetIndirectLev() >= 0) ? verStTab.GetVersionStFromID(ost->GetZeroVersionIndex(), true)
                                                    : &verStTab.GetDummyVersionSt();
-    vStack->push(temp);
-    vstStacks[i] = vStack;
+    vstStackTops[i] = temp;
   }
 }
 
@@ -41,7 +40,8 @@ VersionSt *SSA::CreateNewVersion(VersionSt &vSym, BB &defBB) {
   }
   CHECK_FATAL(vSym.GetOrigIdx().idx < vstVersions.size(), "index out of range in SSA::CreateNewVersion");
   VersionSt *newVersionSym = ssaTab->GetVersionStTable().CreateVSymbol(&vSym, ++vstVersions[vSym.GetOrigIdx().idx]);
-  vstStacks[vSym.GetOrigIdx().idx]->push(newVersionSym);
+  vstStackLog.emplace_back(vSym.GetOrigIdx().idx, vstStackTops[vSym.GetOrigIdx().idx]);
+  vstStackTops[vSym.GetOrigIdx().idx] = newVersionSym;
   newVersionSym->SetDefBB(&defBB);
   return newVersionSym;
 }
@@ -85,8 +85,8 @@ void SSA::RenameDefs(StmtNode &stmt, BB &defBB) {
     for (auto it = mayDefList.begin(); it != mayDefList.end(); it++) {
       MayDefNode &mayDef = it->second;
       VersionSt *vSym = mayDef.GetResult();
-      CHECK_FATAL(vSym->GetOrigIdx().idx < vstStacks.size(), "index out of range in SSA::RenameMayDefs");
-      mayDef.SetOpnd(vstStacks[vSym->GetOrigIdx().idx]->top());
+      CHECK_FATAL(vSym->GetOrigIdx().idx < vstStackTops.size(), "index out of range in SSA::RenameMayDefs");
+      mayDef.SetOpnd(vstStackTops[vSym->GetOrigIdx().idx]);
       VersionSt *newVersionSym = CreateNewVersion(*vSym, defBB);
       mayDef.SetResult(newVersionSym);
       newVersionSym->SetDefType(VersionSt::kMayDef);
@@ -113,8 +113,8 @@ void SSA::RenameMayUses(BaseNode &node) {
     IreadSSANode &iRead = static_cast<IreadSSANode&>(node);
     VersionSt *vSym = iRead.GetSSAVar();
     CHECK_FATAL(vSym != nullptr, "SSA::RenameMayUses: iRead has no mayUse opnd");
-    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStacks.size(), "index out of range in SSA::RenameMayUses");
-    iRead.SetSSAVar(vstStacks[vSym->GetOrigIdx().idx]->top());
+    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStackTops.size(), "index out of range in SSA::RenameMayUses");
+    iRead.SetSSAVar(vstStackTops[vSym->GetOrigIdx().idx]);
     return;
   }
   MapleMap<OStIdx, MayUseNode> &mayUseList = ssaTab->GetStmtsSSAPart().GetMayUseNodesOf(static_cast<StmtNode&>(node));
@@ -122,8 +122,8 @@ void SSA::RenameMayUses(BaseNode &node) {
   for (; it != mayUseList.end(); it++) {
     MayUseNode &mayUse = it->second;
     VersionSt *vSym = mayUse.GetOpnd();
-    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStacks.size(), "index out of range in SSA::RenameMayUses");
-    mayUse.SetOpnd(vstStacks.at(vSym->GetOrigIdx().idx)->top());
+    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStackTops.size(), "index out of range in SSA::RenameMayUses");
+    mayUse.SetOpnd(vstStackTops[vSym->GetOrigIdx().idx]);
   }
 }
 
@@ -131,14 +131,14 @@ void SSA::RenameExpr(BaseNode &expr) {
   if (expr.GetOpCode() == OP_addrof || expr.GetOpCode() == OP_dread) {
     AddrofSSANode &addrofNode = static_cast<AddrofSSANode&>(expr);
     VersionSt *vSym = addrofNode.GetSSAVar();
-    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStacks.size(), "index out of range in SSA::RenameExpr");
-    addrofNode.SetSSAVar(vstStacks[vSym->GetOrigIdx().idx]->top());
+    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStackTops.size(), "index out of range in SSA::RenameExpr");
+    addrofNode.SetSSAVar(vstStackTops[vSym->GetOrigIdx().idx]);
     return;
   } else if (expr.GetOpCode() == OP_regread) {
     RegreadSSANode &regNode = static_cast<RegreadSSANode&>(expr);
     VersionSt *vSym = regNode.GetSSAVar();
-    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStacks.size(), "index out of range in SSA::RenameExpr");
-    regNode.SetSSAVar(vstStacks[vSym->GetOrigIdx().idx]->top());
+    CHECK_FATAL(vSym->GetOrigIdx().idx < vstStackTops.size(), "index out of range in SSA::RenameExpr");
+    regNode.SetSSAVar(vstStackTops[vSym->GetOrigIdx().idx]);
     return;
   } else if (expr.GetOpCode() == OP_iread) {
     RenameMayUses(expr);
@@ -171,9 +171,9 @@ void SSA::RenamePhiUseInSucc(BB &bb) {
     // rename the phiOpnds[index] in all the phis in succ_bb
     for (auto phiIt = succBB->GetPhiList().begin(); phiIt != succBB->GetPhiList().end(); phiIt++) {
       PhiNode &phiNode = phiIt->second;
-      CHECK_FATAL(phiNode.GetPhiOpnd(index)->GetOrigIdx().idx < vstStacks.size(),
+      CHECK_FATAL(phiNode.GetPhiOpnd(index)->GetOrigIdx().idx < vstStackTops.size(),
                   "out of range SSA::RenamePhiUseInSucc");
-      phiNode.SetPhiOpnd(index, *vstStacks.at(phiNode.GetPhiOpnd(index)->GetOrigIdx().idx)->top());
+      phiNode.SetPhiOpnd(index, *vstStackTops[phiNode.GetPhiOpnd(index)->GetOrigIdx().idx]);
     }
   }
 }
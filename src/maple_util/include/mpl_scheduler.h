@@ -73,7 +73,7 @@ class MplSchedulerParam {
 class MplScheduler {
  public:
   explicit MplScheduler(const std::string &name);
-  virtual ~MplScheduler() {}
+  virtual ~MplScheduler();
 
   virtual void AddTask(MplTask *task);
   virtual int RunTask(uint32 nthreads, bool seq = false);
@@ -125,6 +125,7 @@ class MplScheduler {
   virtual MplTask *GetTaskFinishFirst();
   virtual void RemoveTaskFinish(uint32 id);
   virtual void TaskIdFinish(uint32 id);
+  bool IsTaskIdFinished(uint32 id);
   void ThreadMain(uint32 threadID, MplSchedulerParam *env);
   void ThreadFinishNoSequence(MplSchedulerParam *env);
   void ThreadFinishSequence(MplSchedulerParam *env);
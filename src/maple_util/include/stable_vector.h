@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_UTIL_INCLUDE_STABLE_VECTOR_H
+#define MAPLE_UTIL_INCLUDE_STABLE_VECTOR_H
+#include <atomic>
+#include <memory>
+#include "mpl_logging.h"
+
+namespace maple {
+// An append-only vector whose elements never move once pushed.
+// Storage is a fixed directory of lazily allocated chunks, so an index can be read
+// without locking while another thread appends (appends themselves must be serialized).
+template <typename T>
+class StableVector {
+ public:
+  StableVector() : chunks(new std::atomic<T*>[kMaxChunkNum]()) {}
+  StableVector(const StableVector&) = delete;
+  StableVector &operator=(const StableVector&) = delete;
+
+  ~StableVector() {
+    for (size_t i = 0; i < kMaxChunkNum; ++i) {
+      delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const {
+    return count.load(std::memory_order_acquire);
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  void push_back(const T &value) {
+    size_t idx = count.load(std::memory_order_relaxed);
+    size_t chunkIdx = idx >> kChunkBits;
+    CHECK_FATAL(chunkIdx < kMaxChunkNum, "StableVector capacity exceeded");
+    T *chunk = chunks[chunkIdx].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = new T[kChunkSize]();
+      chunks[chunkIdx].store(chunk, std::memory_order_release);
+    }
+    chunk[idx & kChunkMask] = value;
+    // publish the element only after it is written
+    count.store(idx + 1, std::memory_order_release);
+  }
+
+  T &operator[](size_t idx) {
+    return chunks[idx >> kChunkBits].load(std::memory_order_acquire)[idx & kChunkMask];
+  }
+
+  const T &operator[](size_t idx) const {
+    return chunks[idx >> kChunkBits].load(std::memory_order_acquire)[idx & kChunkMask];
+  }
+
+  T &at(size_t idx) {
+    CHECK_FATAL(idx < size(), "array index out of range");
+    return (*this)[idx];
+  }
+
+  const T &at(size_t idx) const {
+    CHECK_FATAL(idx < size(), "array index out of range");
+    return (*this)[idx];
+  }
+
+  // forward iteration over the elements published when begin()/end() were taken
+  template <typename Vec, typename Ref>
+  class Iterator {
+   public:
+    Iterator(Vec &vec, size_t idx) : vec(&vec), idx(idx) {}
+
+    Ref operator*() const {
+      return (*vec)[idx];
+    }
+
+    Iterator &operator++() {
+      ++idx;
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return idx == other.idx;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return idx != other.idx;
+    }
+
+   private:
+    Vec *vec;
+    size_t idx;
+  };
+  using iterator = Iterator<StableVector, T&>;
+  using const_iterator = Iterator<const StableVector, const T&>;
+
+  iterator begin() {
+    return iterator(*this, 0);
+  }
+
+  iterator end() {
+    return iterator(*this, size());
+  }
+
+  const_iterator begin() const {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(*this, size());
+  }
+
+ private:
+  static constexpr size_t kChunkBits = 12;
+  static constexpr size_t kChunkSize = 1u << kChunkBits;
+  static constexpr size_t kChunkMask = kChunkSize - 1;
+  static constexpr size_t kMaxChunkNum = 1u << 14;
+
+  std::unique_ptr<std::atomic<T*>[]> chunks;
+  std::atomic<size_t> count{ 0 };
+};
+}  // namespace maple
+#endif  // MAPLE_UTIL_INCLUDE_STABLE_VECTOR_H
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "mpl_scheduler.h"
+#include <cstdlib>
+#include "mpl_logging.h"
+#include "mpl_timer.h"
+
+namespace maple {
+MplScheduler::MplScheduler(const std::string &name)
+    : schedulerName(name),
+      taskIdForAdd(0),
+      taskIdToRun(0),
+      taskIdExpected(0),
+      numberTasks(0),
+      numberTasksFinish(0),
+      isSchedulerSeq(false),
+      dumpTime(false),
+      statusFinish(kThreadStop) {
+  pthread_mutex_init(&mutexTaskIdsToRun, nullptr);
+  pthread_mutex_init(&mutexTaskIdsToFinish, nullptr);
+  pthread_mutex_init(&mutexTaskFinishProcess, nullptr);
+  pthread_mutex_init(&mutexGlobal, nullptr);
+  pthread_cond_init(&conditionFinishProcess, nullptr);
+  const char *envStr = getenv("MP_DUMPTIME");
+  dumpTime = (envStr != nullptr && atoi(envStr) == 1);
+}
+
+MplScheduler::~MplScheduler() {
+  pthread_mutex_destroy(&mutexTaskIdsToRun);
+  pthread_mutex_destroy(&mutexTaskIdsToFinish);
+  pthread_mutex_destroy(&mutexTaskFinishProcess);
+  pthread_mutex_destroy(&mutexGlobal);
+  pthread_cond_destroy(&conditionFinishProcess);
+}
+
+void MplScheduler::AddTask(MplTask *task) {
+  CHECK_FATAL(task != nullptr, "null ptr check in MplScheduler::AddTask");
+  task->SetTaskId(taskIdForAdd);
+  tbTasks.push_back(task);
+  ++taskIdForAdd;
+  ++numberTasks;
+}
+
+void MplScheduler::Reset() {
+  tbTasks.clear();
+  tbTaskIdsToFinish.clear();
+  taskIdForAdd = 0;
+  taskIdToRun = 0;
+  taskIdExpected = 0;
+  numberTasks = 0;
+  numberTasksFinish = 0;
+  statusFinish = kThreadStop;
+}
+
+MplTask *MplScheduler::GetTaskToRun() {
+  MplTask *task = nullptr;
+  pthread_mutex_lock(&mutexTaskIdsToRun);
+  if (taskIdToRun < numberTasks) {
+    task = tbTasks[taskIdToRun++];
+  }
+  pthread_mutex_unlock(&mutexTaskIdsToRun);
+  return task;
+}
+
+uint32 MplScheduler::GetTaskIdsFinishSize() {
+  pthread_mutex_lock(&mutexTaskIdsToFinish);
+  uint32 size = static_cast<uint32>(tbTaskIdsToFinish.size());
+  pthread_mutex_unlock(&mutexTaskIdsToFinish);
+  return size;
+}
+
+MplTask *MplScheduler::GetTaskFinishFirst() {
+  MplTask *task = nullptr;
+  pthread_mutex_lock(&mutexTaskIdsToFinish);
+  if (!tbTaskIdsToFinish.empty()) {
+    task = tbTasks[*(tbTaskIdsToFinish.begin())];
+  }
+  pthread_mutex_unlock(&mutexTaskIdsToFinish);
+  return task;
+}
+
+bool MplScheduler::IsTaskIdFinished(uint32 id) {
+  pthread_mutex_lock(&mutexTaskIdsToFinish);
+  bool finished = (tbTaskIdsToFinish.find(id) != tbTaskIdsToFinish.end());
+  pthread_mutex_unlock(&mutexTaskIdsToFinish);
+  return finished;
+}
+
+void MplScheduler::RemoveTaskFinish(uint32 id) {
+  pthread_mutex_lock(&mutexTaskIdsToFinish);
+  tbTaskIdsToFinish.erase(id);
+  pthread_mutex_unlock(&mutexTaskIdsToFinish);
+}
+
+void MplScheduler::TaskIdFinish(uint32 id) {
+  pthread_mutex_lock(&mutexTaskIdsToFinish);
+  tbTaskIdsToFinish.insert(id);
+  pthread_mutex_unlock(&mutexTaskIdsToFinish);
+  // wake up the finish thread; signal under the lock so that the wake up can not be lost
+  pthread_mutex_lock(&mutexTaskFinishProcess);
+  pthread_cond_signal(&conditionFinishProcess);
+  pthread_mutex_unlock(&mutexTaskFinishProcess);
+}
+
+int MplScheduler::FinishTask(MplTask *task) {
+  CHECK_FATAL(task != nullptr, "null ptr check in MplScheduler::FinishTask");
+  return task->Finish(CallbackGetTaskFinishParam());
+}
+
+void MplScheduler::ThreadMain(uint32 threadID, MplSchedulerParam *env) {
+  DecodeThreadMainEnvironment(env);
+  CallbackThreadMainStart();
+  MPLTimer timer;
+  timer.Start();
+  uint32 taskCount = 0;
+  MplTask *task = GetTaskToRun();
+  while (task != nullptr) {
+    (void)task->Run(CallbackGetTaskRunParam());
+    TaskIdFinish(task->GetTaskId());
+    ++taskCount;
+    task = GetTaskToRun();
+  }
+  CallbackThreadMainEnd();
+  timer.Stop();
+  if (dumpTime) {
+    GlobalLock();
+    LogInfo::MapleLogger() << schedulerName << " thread " << threadID << ": " << taskCount << " tasks in "
+                           << timer.ElapsedMilliseconds() << "ms\n";
+    GlobalUnlock();
+  }
+}
+
+// Finish tasks strictly in the order they were added, so that whatever Finish does to
+// shared state happens exactly as in a serial run.
+void MplScheduler::ThreadFinishSequence(MplSchedulerParam *env) {
+  DecodeThreadFinishEnvironment(env);
+  CallbackThreadFinishStart();
+  while (numberTasksFinish < numberTasks) {
+    pthread_mutex_lock(&mutexTaskFinishProcess);
+    while (!IsTaskIdFinished(taskIdExpected)) {
+      pthread_cond_wait(&conditionFinishProcess, &mutexTaskFinishProcess);
+    }
+    pthread_mutex_unlock(&mutexTaskFinishProcess);
+    MplTask *task = tbTasks[taskIdExpected];
+    (void)FinishTask(task);
+    RemoveTaskFinish(task->GetTaskId());
+    ++taskIdExpected;
+    ++numberTasksFinish;
+  }
+  CallbackThreadFinishEnd();
+}
+
+void MplScheduler::ThreadFinishNoSequence(MplSchedulerParam *env) {
+  DecodeThreadFinishEnvironment(env);
+  CallbackThreadFinishStart();
+  while (numberTasksFinish < numberTasks) {
+    pthread_mutex_lock(&mutexTaskFinishProcess);
+    MplTask *task = GetTaskFinishFirst();
+    while (task == nullptr) {
+      pthread_cond_wait(&conditionFinishProcess, &mutexTaskFinishProcess);
+      task = GetTaskFinishFirst();
+    }
+    pthread_mutex_unlock(&mutexTaskFinishProcess);
+    (void)FinishTask(task);
+    RemoveTaskFinish(task->GetTaskId());
+    ++numberTasksFinish;
+  }
+  CallbackThreadFinishEnd();
+}
+
+void MplScheduler::ThreadFinish(MplSchedulerParam *env) {
+  statusFinish = kThreadRun;
+  if (isSchedulerSeq) {
+    ThreadFinishSequence(env);
+  } else {
+    ThreadFinishNoSequence(env);
+  }
+  statusFinish = kThreadStop;
+}
+
+int MplScheduler::RunTask(uint32 nthreads, bool seq) {
+  isSchedulerSeq = seq;
+  if (numberTasks == 0) {
+    return 0;
+  }
+  if (nthreads == 0) {
+    nthreads = 1;
+  }
+  MPLTimer timer;
+  timer.Start();
+  // environments are encoded on the calling thread so that subclasses can set up
+  // per-thread state without synchronization
+  std::vector<MplSchedulerParam*> mainEnvs;
+  for (uint32 i = 0; i < nthreads; ++i) {
+    mainEnvs.push_back(EncodeThreadMainEnvironment(i));
+  }
+  std::thread finishThread(&MplScheduler::ThreadFinish, this, EncodeThreadFinishEnvironment());
+  std::vector<std::thread> mainThreads;
+  for (uint32 i = 0; i < nthreads; ++i) {
+    mainThreads.emplace_back(&MplScheduler::ThreadMain, this, i, mainEnvs[i]);
+  }
+  for (auto &thread : mainThreads) {
+    thread.join();
+  }
+  finishThread.join();
+  timer.Stop();
+  if (dumpTime) {
+    LogInfo::MapleLogger() << schedulerName << ": " << numberTasks << " tasks on " << nthreads << " threads in "
+                           << timer.ElapsedMilliseconds() << "ms\n";
+  }
+  return 0;
+}
+}  // namespace maple
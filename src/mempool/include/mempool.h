@@ -134,5 +134,17 @@ class MemPool {
 };
 
 extern MemPoolCtrler memPoolCtrler;
+
+// Threads that optimize functions concurrently install a controller of their own, so that the
+// mempools they create never share free lists with the ones of another thread.
+inline MemPoolCtrler *&ThreadMemPoolCtrler() {
+  static thread_local MemPoolCtrler *threadCtrler = nullptr;
+  return threadCtrler;
+}
+
+inline MemPoolCtrler &CurMemPoolCtrler() {
+  MemPoolCtrler *threadCtrler = ThreadMemPoolCtrler();
+  return threadCtrler == nullptr ? memPoolCtrler : *threadCtrler;
+}
 }  // namespace maple
 #endif  // MEMPOOL_INCLUDE_MEMPOOL_H
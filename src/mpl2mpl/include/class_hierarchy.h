@@ -210,6 +210,34 @@ class Klass {
     return implInterfaces;
   }
 
+  // All the interfaces extended by the current interface, directly or not
+  const MapleSet<const Klass*> &GetSuperInterfaces() const {
+    return superInterfaces;
+  }
+
+  void AddSuperInterface(const Klass *interfaceKlass) {
+    superInterfaces.insert(interfaceKlass);
+  }
+
+  // Classes are numbered in preorder over the class tree: a class gets intervalLow and its
+  // subclasses the numbers up to intervalHigh. Interfaces are not numbered.
+  bool HasInterval() const {
+    return intervalLow != 0;
+  }
+
+  uint32 GetIntervalLow() const {
+    return intervalLow;
+  }
+
+  uint32 GetIntervalHigh() const {
+    return intervalHigh;
+  }
+
+  void SetInterval(uint32 low, uint32 high) {
+    intervalLow = low;
+    intervalHigh = high;
+  }
+
   // Return a vector of possible functions
   MapleVector<MIRFunction*> *GetCandidates(GStrIdx mnameNoklassStrIdx) const;
   // Return the unique method if there is only one target virtual function.
@@ -256,6 +284,8 @@ class Klass {
   MapleSet<Klass*, KlassComparator> implKlasses;
   // a collection of interfaces which is implemented by the current klass
   MapleSet<Klass*, KlassComparator> implInterfaces;
+  // a collection of interfaces which are extended by the current interface, directly or not
+  MapleSet<const Klass*> superInterfaces;
   // A collection of class member methods
   MapleList<MIRFunction*> methods;
   // A mapping to track every method to its baseFuncNameWithType
@@ -270,6 +300,9 @@ class Klass {
   bool isPrivateInnerAndNoSubClassFlag;
   bool hasNativeMethods;
   bool needDecoupling;
+  // interval of the preorder numbers of the class and its subclasses, 0 if not numbered
+  uint32 intervalLow;
+  uint32 intervalHigh;
   void DumpKlassImplInterfaces() const;
   void DumpKlassImplKlasses() const;
   void DumpKlassSuperKlasses() const;
@@ -383,6 +416,8 @@ class KlassHierarchy : public AnalysisResult {
   Klass *AddClassFlag(const std::string &name, uint32 flag);
   int GetFieldIDOffsetBetweenClasses(const Klass &super, const Klass &base) const;
   void TopologicalSortKlasses();
+  // Number the classes and collect the super interfaces of interfaces for the subtype queries
+  void NumberKlasses();
   void MarkClassFlags();
 };
 }  // namespace maple
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPL2MPL_INCLUDE_FUNC_OPTIMIZE_SCHEDULER_H
+#define MPL2MPL_INCLUDE_FUNC_OPTIMIZE_SCHEDULER_H
+#include <memory>
+#include <vector>
+#include "phase_impl.h"
+#include "option.h"
+
+namespace maple {
+class FuncOptimizeTask : public MplTask {
+ public:
+  explicit FuncOptimizeTask(MIRFunction &func) : func(func) {}
+
+  ~FuncOptimizeTask() = default;
+
+  // param is the clone of the phase owned by the running thread
+  int Run(MplTaskParam *param = nullptr) override;
+
+ private:
+  MIRFunction &func;
+};
+
+class FuncOptimizeScheduler : public MplScheduler {
+ public:
+  explicit FuncOptimizeScheduler(FuncOptimizeImpl &phaseImpl)
+      : MplScheduler("func optimize scheduler"), phaseImpl(phaseImpl) {}
+
+  ~FuncOptimizeScheduler() = default;
+
+  void AddFunction(MIRFunction &func);
+  void Run(uint32 nthreads);
+
+ protected:
+  MplSchedulerParam *EncodeThreadMainEnvironment(uint32 threadId) override;
+  void DecodeThreadMainEnvironment(MplSchedulerParam *env) override;
+  MplTaskParam *CallbackGetTaskRunParam() override;
+
+ private:
+  class ThreadEnv : public MplSchedulerParam {
+   public:
+    explicit ThreadEnv(FuncOptimizeImpl *impl) : impl(impl) {}
+
+    ~ThreadEnv() = default;
+
+    std::unique_ptr<FuncOptimizeImpl> impl;
+  };
+
+  FuncOptimizeImpl &phaseImpl;
+  std::vector<std::unique_ptr<FuncOptimizeTask>> tasks;
+  std::vector<std::unique_ptr<ThreadEnv>> threadEnvs;
+};
+
+// Runs ProcessFunc over the functions of the module on several threads, each thread working on a
+// clone of the phase. Only phases whose ProcessFunc changes nothing but the function itself (apart
+// from interning into the global tables) and which keep no state across functions may use it;
+// Finish is called on the original phase once every function is done.
+class ParallelFuncOptimizeIterator : public FuncOptimizeIterator {
+ public:
+  ParallelFuncOptimizeIterator(const std::string &phaseName, FuncOptimizeImpl *phaseImpl, uint32 nthreads)
+      : FuncOptimizeIterator(phaseName, phaseImpl), nthreads(nthreads) {}
+
+  ~ParallelFuncOptimizeIterator() = default;
+
+  void Run() override;
+
+ private:
+  uint32 nthreads;
+};
+
+// traces of functions processed at the same time would interleave, so tracing runs serially
+#define PARALLEL_OPT_TEMPLATE(OPT_NAME)                                                        \
+  KlassHierarchy *kh = static_cast<KlassHierarchy*>(mrm->GetAnalysisResult(MoPhase_CHA, mod)); \
+  ASSERT(kh, "null ptr check");                                                                \
+  ParallelFuncOptimizeIterator opt(PhaseName(), new OPT_NAME(mod, kh, TRACE_PHASE),            \
+                                   TRACE_PHASE ? 1 : Options::jobs);                           \
+  opt.Run();
+}  // namespace maple
+#endif  // MPL2MPL_INCLUDE_FUNC_OPTIMIZE_SCHEDULER_H
@@ -14,6 +14,7 @@
  */
 #ifndef MPL2MPL_INCLUDE_GEN_CHECK_CAST_H
 #define MPL2MPL_INCLUDE_GEN_CHECK_CAST_H
+#include <map>
 #include "class_hierarchy.h"
 #include "module_phase.h"
 #include "phase_impl.h"
@@ -42,11 +43,25 @@ class CheckCastGenerator : public FuncOptimizeImpl {
   MIRFunction *throwCastException = nullptr;
   MIRFunction *checkCastingNoArray = nullptr;
   MIRFunction *checkCastingArray = nullptr;
+  // Types inferred for local variables and pregs since the last join point, kept only when
+  // narrower than the declared type. The value is the TyIdx of the class the reference points to.
+  std::map<StIdx, TyIdx> localTypes;
+  std::map<PregIdx, TyIdx> pregTypes;
+  uint32 numCastsEliminated = 0;
+  uint32 numCastsChecked = 0;
 
   void InitTypes();
   void InitFuncs();
   void GenAllCheckCast();
   void GenCheckCast(BaseNode &stmt);
+  bool IsSubtype(Klass &super, Klass &base) const;
+  TyIdx GetNarrowerType(TyIdx tyIdx1, TyIdx tyIdx2) const;
+  TyIdx InferClassType(const BaseNode &expr) const;
+  void SetInferredType(StIdx stIdx, TyIdx tyIdx);
+  void SetInferredType(PregIdx pregIdx, TyIdx tyIdx);
+  void SetInferredType(const BaseNode &expr, TyIdx tyIdx);
+  void UpdateInferredTypes(StmtNode &stmt);
+  bool IsCastProvedSafe(const IntrinsiccallNode &callNode, Klass &checkKlass) const;
   BaseNode *GetObjectShadow(BaseNode *opnd);
   MIRSymbol *GetOrCreateClassInfoSymbol(const std::string &className);
 };
@@ -18,6 +18,7 @@
 #include <unordered_set>
 #include "phase_impl.h"
 #include "module_phase.h"
+#include "func_optimize_scheduler.h"
 
 namespace maple {
 class JavaIntrnLowering : public FuncOptimizeImpl {
@@ -47,7 +48,7 @@ class DoJavaIntrnLowering : public ModulePhase {
   }
 
   AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override {
-    OPT_TEMPLATE(JavaIntrnLowering);
+    PARALLEL_OPT_TEMPLATE(JavaIntrnLowering);
     return nullptr;
   }
 };
@@ -53,6 +53,9 @@ class VtableAnalysis : public FuncOptimizeImpl {
   void GenItableDefinition(const Klass &klass);
 
   BaseNode *GenVtabItabBaseAddr(BaseNode *obj, bool isVirtual);
+  MIRFunction *GetUniqueImplForInterface(const Klass &interface, GStrIdx strIdx) const;
+  MIRFunction *GetDevirtualizedTarget(const MIRFunction &callee) const;
+  bool DevirtualizeInvoke(CallNode &stmt);
   void ReplaceVirtualInvoke(CallNode &stmt);
   void ReplaceInterfaceInvoke(CallNode &stmt);
   void ReplaceSuperclassInvoke(CallNode &stmt);
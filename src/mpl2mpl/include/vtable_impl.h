@@ -15,7 +15,7 @@
 #ifndef MPL2MPL_INCLUDE_VTABLE_IMPL_H
 #define MPL2MPL_INCLUDE_VTABLE_IMPL_H
 #include "module_phase.h"
-#include "phase_impl.h"
+#include "func_optimize_scheduler.h"
 
 namespace maple {
 static constexpr int kNumOfMCCParas = 5;
@@ -59,7 +59,7 @@ class DoVtableImpl : public ModulePhase {
   ~DoVtableImpl() = default;
 
   AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override {
-    OPT_TEMPLATE(VtableImpl);
+    PARALLEL_OPT_TEMPLATE(VtableImpl);
     return nullptr;
   }
 };
@@ -48,6 +48,7 @@ Klass::Klass(MIRStructType *type, MapleAllocator *alc)
       subKlasses(alloc->Adapter()),
       implKlasses(alloc->Adapter()),
       implInterfaces(alloc->Adapter()),
+      superInterfaces(alloc->Adapter()),
       methods(alloc->Adapter()),
       strIdx2Method(std::less<GStrIdx>(), alloc->Adapter()),
       clinitMethod(nullptr),
@@ -56,7 +57,9 @@ Klass::Klass(MIRStructType *type, MapleAllocator *alc)
       flags(0),
       isPrivateInnerAndNoSubClassFlag(false),
       hasNativeMethods(false),
-      needDecoupling(true) {
+      needDecoupling(true),
+      intervalLow(0),
+      intervalHigh(0) {
   ASSERT(type != nullptr, "type is nullptr in Klass::Klass!");
   ASSERT(type->GetKind() == kTypeClass || type->GetKind() == kTypeInterface, "runtime check error");
 }
@@ -337,6 +340,9 @@ bool KlassHierarchy::IsSuperKlass(const Klass *super, const Klass *base) const {
   if (super == nullptr || base == nullptr) {
     return false;
   }
+  if (super->HasInterval() && base->HasInterval()) {
+    return super->GetIntervalLow() <= base->GetIntervalLow() && base->GetIntervalLow() <= super->GetIntervalHigh();
+  }
   while (base != nullptr) {
     if (base == super) {
       return true;
@@ -354,17 +360,7 @@ bool KlassHierarchy::IsSuperKlassForInterface(const Klass *super, Klass *base) c
   if (!super->IsInterface() || !base->IsInterface()) {
     return false;
   }
-  std::vector<Klass*> tmpVector;
-  tmpVector.push_back(base);
-  for (size_t idx = 0; idx < tmpVector.size(); idx++) {
-    if (tmpVector[idx] == super) {
-      return true;
-    }
-    for (Klass *superKlass : tmpVector[idx]->GetSuperKlasses()) {
-      tmpVector.push_back(superKlass);
-    }
-  }
-  return false;
+  return super == base || base->GetSuperInterfaces().find(super) != base->GetSuperInterfaces().end();
 }
 
 bool KlassHierarchy::IsInterfaceImplemented(Klass *interface, const Klass *base) const {
@@ -678,6 +674,53 @@ void KlassHierarchy::TopologicalSortKlasses() {
   }
 }
 
+// A class is a subclass of another iff its preorder number over the class tree lies in the
+// interval of the other, which makes IsSuperKlass a range compare. Interfaces may extend several
+// interfaces, so each one keeps the set of all its super interfaces instead.
+void KlassHierarchy::NumberKlasses() {
+  uint32 number = 0;
+  // a klass is pushed twice: to number it, and to close its interval once its subclasses are done
+  std::vector<std::pair<Klass*, bool>> workStack;
+  for (auto const &pair : strIdx2KlassMap) {
+    Klass *root = pair.second;
+    if (root->IsInterface() || root->HasSuperKlass()) {
+      continue;
+    }
+    workStack.push_back(std::make_pair(root, false));
+    while (!workStack.empty()) {
+      Klass *klass = workStack.back().first;
+      bool subKlassesDone = workStack.back().second;
+      workStack.pop_back();
+      if (subKlassesDone) {
+        klass->SetInterval(klass->GetIntervalLow(), number);
+        continue;
+      }
+      klass->SetInterval(++number, 0);
+      workStack.push_back(std::make_pair(klass, true));
+      for (Klass *subKlass : klass->GetSubKlasses()) {
+        workStack.push_back(std::make_pair(subKlass, false));
+      }
+    }
+  }
+  std::vector<Klass*> workList;
+  for (auto const &pair : strIdx2KlassMap) {
+    Klass *interface = pair.second;
+    if (!interface->IsInterface()) {
+      continue;
+    }
+    workList.assign(interface->GetSuperKlasses().begin(), interface->GetSuperKlasses().end());
+    while (!workList.empty()) {
+      Klass *superKlass = workList.back();
+      workList.pop_back();
+      if (interface->GetSuperInterfaces().find(superKlass) != interface->GetSuperInterfaces().end()) {
+        continue;
+      }
+      interface->AddSuperInterface(superKlass);
+      workList.insert(workList.end(), superKlass->GetSuperKlasses().begin(), superKlass->GetSuperKlasses().end());
+    }
+  }
+}
+
 void KlassHierarchy::CountVirtualMethods() {
   // Top-down iterates all klass nodes
   for (size_t i = 0; i < topoWorkList.size(); i++) {
@@ -762,6 +805,7 @@ void KlassHierarchy::BuildHierarchy() {
   // we need to add a link between C and A.
   UpdateImplementedInterfaces();
   TopologicalSortKlasses();
+  NumberKlasses();
   MarkClassFlags();
   if (!strIdx2KlassMap.empty()) {
     WKTypes::Init();
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "func_optimize_scheduler.h"
+#include "global_tables.h"
+
+namespace maple {
+namespace {
+thread_local FuncOptimizeImpl *threadPhaseImpl = nullptr;
+}
+
+int FuncOptimizeTask::Run(MplTaskParam *param) {
+  CHECK_FATAL(param != nullptr, "null ptr check in FuncOptimizeTask::Run");
+  static_cast<FuncOptimizeImpl*>(param)->ProcessFunc(&func);
+  return 0;
+}
+
+void FuncOptimizeScheduler::AddFunction(MIRFunction &func) {
+  std::unique_ptr<FuncOptimizeTask> task(new FuncOptimizeTask(func));
+  AddTask(task.get());
+  tasks.push_back(std::move(task));
+}
+
+// called on the thread that starts the scheduler, so the phase is never cloned while it is in use
+MplSchedulerParam *FuncOptimizeScheduler::EncodeThreadMainEnvironment(uint32) {
+  std::unique_ptr<ThreadEnv> env(new ThreadEnv(phaseImpl.Clone()));
+  threadEnvs.push_back(std::move(env));
+  return threadEnvs.back().get();
+}
+
+void FuncOptimizeScheduler::DecodeThreadMainEnvironment(MplSchedulerParam *env) {
+  threadPhaseImpl = static_cast<ThreadEnv*>(env)->impl.get();
+}
+
+MplTaskParam *FuncOptimizeScheduler::CallbackGetTaskRunParam() {
+  return threadPhaseImpl;
+}
+
+void FuncOptimizeScheduler::Run(uint32 nthreads) {
+  MIRModule &mirModule = phaseImpl.GetMIRModule();
+  mirModule.SetMultiThreaded(true);
+  TableConcurrency::SetEnabled(true);
+  (void)RunTask(nthreads, false);
+  TableConcurrency::SetEnabled(false);
+  mirModule.SetMultiThreaded(false);
+  threadEnvs.clear();
+  tasks.clear();
+  Reset();
+}
+
+void ParallelFuncOptimizeIterator::Run() {
+  if (nthreads <= 1) {
+    FuncOptimizeIterator::Run();
+    return;
+  }
+  FuncOptimizeScheduler scheduler(*phaseImpl);
+  for (MIRFunction *func : phaseImpl->GetMIRModule().GetFunctionList()) {
+    scheduler.AddFunction(*func);
+  }
+  scheduler.Run(nthreads);
+  phaseImpl->Finish();
+}
+}  // namespace maple
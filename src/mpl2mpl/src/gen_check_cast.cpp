@@ -27,8 +27,22 @@
 //    in our case check if object can be cast or insert MCC_Reflect_ThrowCastException
 //    before the stmt.
 // #2 optimise instance-of && cast
+// A cast is not checked at runtime if the operand is known to be an instance of the target
+// class or null. What is known comes from the declared types of the variables, gcmalloc and
+// earlier casts; a forward pass over the flat body narrows the types of local variables and
+// pregs, and forgets the narrowed types at labels, where the paths join.
 
 namespace maple {
+namespace {
+// the TyIdx of the type a reference of the given type points to, or 0 if it is not a pointer
+TyIdx GetPointedTyIdx(const MIRType *type) {
+  if (type == nullptr || type->GetKind() != kTypePointer) {
+    return TyIdx(0);
+  }
+  return static_cast<const MIRPtrType*>(type)->GetPointedTyIdx();
+}
+}  // namespace
+
 CheckCastGenerator::CheckCastGenerator(MIRModule *mod, KlassHierarchy *kh, bool dump)
     : FuncOptimizeImpl(mod, kh, dump) {
   InitTypes();
@@ -68,6 +82,161 @@ MIRSymbol *CheckCastGenerator::GetOrCreateClassInfoSymbol(const std::string &cla
   return classInfoSymbol;
 }
 
+// true if every instance of base is an instance of super
+bool CheckCastGenerator::IsSubtype(Klass &super, Klass &base) const {
+  if (&super == &base) {
+    return true;
+  }
+  if (super.IsInterface()) {
+    return base.IsInterface() ? klassHierarchy->IsSuperKlassForInterface(&super, &base)
+                              : klassHierarchy->IsInterfaceImplemented(&super, &base);
+  }
+  return !base.IsInterface() && klassHierarchy->IsSuperKlass(&super, &base);
+}
+
+// Both types are known for the same reference, return the more derived one, or tyIdx2 if they
+// are unrelated.
+TyIdx CheckCastGenerator::GetNarrowerType(TyIdx tyIdx1, TyIdx tyIdx2) const {
+  Klass *klass1 = klassHierarchy->GetKlassFromTyIdx(tyIdx1);
+  Klass *klass2 = klassHierarchy->GetKlassFromTyIdx(tyIdx2);
+  if (klass1 == nullptr || klass2 == nullptr) {
+    return klass1 == nullptr ? tyIdx2 : tyIdx1;
+  }
+  return IsSubtype(*klass2, *klass1) ? tyIdx1 : tyIdx2;
+}
+
+// The class the reference value of expr is an instance of, if not null; 0 if unknown.
+TyIdx CheckCastGenerator::InferClassType(const BaseNode &expr) const {
+  switch (expr.GetOpCode()) {
+    case OP_dread: {
+      auto &dread = static_cast<const AddrofNode&>(expr);
+      if (dread.GetFieldID() != 0) {
+        return TyIdx(0);
+      }
+      auto it = localTypes.find(dread.GetStIdx());
+      if (it != localTypes.end()) {
+        return it->second;
+      }
+      return GetPointedTyIdx(currFunc->GetLocalOrGlobalSymbol(dread.GetStIdx())->GetType());
+    }
+    case OP_regread: {
+      auto &regRead = static_cast<const RegreadNode&>(expr);
+      // special registers like %%thrownval have negative indexes
+      if (regRead.GetPrimType() != PTY_ref || regRead.GetRegIdx() < 0) {
+        return TyIdx(0);
+      }
+      auto it = pregTypes.find(regRead.GetRegIdx());
+      if (it != pregTypes.end()) {
+        return it->second;
+      }
+      return GetPointedTyIdx(currFunc->GetPregTab()->PregFromPregIdx(regRead.GetRegIdx())->GetMIRType());
+    }
+    case OP_iread: {
+      auto &iread = static_cast<const IreadNode&>(expr);
+      MIRType *pointedType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(
+          GetPointedTyIdx(GlobalTables::GetTypeTable().GetTypeFromTyIdx(iread.GetTyIdx())));
+      if (iread.GetFieldID() == 0 || pointedType == nullptr || pointedType->GetKind() != kTypeClass) {
+        return TyIdx(0);
+      }
+      return GetPointedTyIdx(static_cast<MIRStructType*>(pointedType)->GetFieldType(iread.GetFieldID()));
+    }
+    case OP_gcmalloc:
+      return static_cast<const GCMallocNode&>(expr).GetTyIdx();
+    default:
+      return TyIdx(0);
+  }
+}
+
+void CheckCastGenerator::SetInferredType(StIdx stIdx, TyIdx tyIdx) {
+  if (!stIdx.Islocal()) {
+    return;
+  }
+  TyIdx declaredTyIdx = GetPointedTyIdx(currFunc->GetLocalOrGlobalSymbol(stIdx)->GetType());
+  if (tyIdx != declaredTyIdx && GetNarrowerType(declaredTyIdx, tyIdx) == tyIdx) {
+    localTypes[stIdx] = tyIdx;
+  } else {
+    localTypes.erase(stIdx);
+  }
+}
+
+void CheckCastGenerator::SetInferredType(PregIdx pregIdx, TyIdx tyIdx) {
+  if (pregIdx < 0) {
+    return;
+  }
+  TyIdx declaredTyIdx = GetPointedTyIdx(currFunc->GetPregTab()->PregFromPregIdx(pregIdx)->GetMIRType());
+  if (tyIdx != declaredTyIdx && GetNarrowerType(declaredTyIdx, tyIdx) == tyIdx) {
+    pregTypes[pregIdx] = tyIdx;
+  } else {
+    pregTypes.erase(pregIdx);
+  }
+}
+
+// Set the type of the variable read by expr, if it is a variable.
+void CheckCastGenerator::SetInferredType(const BaseNode &expr, TyIdx tyIdx) {
+  if (expr.GetOpCode() == OP_dread && static_cast<const AddrofNode&>(expr).GetFieldID() == 0) {
+    SetInferredType(static_cast<const AddrofNode&>(expr).GetStIdx(), tyIdx);
+  } else if (expr.GetOpCode() == OP_regread && expr.GetPrimType() == PTY_ref) {
+    SetInferredType(static_cast<const RegreadNode&>(expr).GetRegIdx(), tyIdx);
+  }
+}
+
+// The transfer function of the type inference for a stmt of the flat function body.
+void CheckCastGenerator::UpdateInferredTypes(StmtNode &stmt) {
+  switch (stmt.GetOpCode()) {
+    case OP_label:
+    case OP_catch:
+    case OP_block:
+    case OP_if:
+    case OP_while:
+    case OP_dowhile:
+    case OP_doloop:
+    case OP_foreachelem:
+      // a join point, or a stmt with nested blocks that are not walked
+      localTypes.clear();
+      pregTypes.clear();
+      return;
+    case OP_dassign: {
+      auto &dassign = static_cast<DassignNode&>(stmt);
+      TyIdx rhsTyIdx = dassign.GetFieldID() == 0 ? InferClassType(*dassign.GetRHS()) : TyIdx(0);
+      SetInferredType(dassign.GetStIdx(), rhsTyIdx);
+      return;
+    }
+    case OP_regassign: {
+      auto &regAssign = static_cast<RegassignNode&>(stmt);
+      TyIdx rhsTyIdx = regAssign.GetPrimType() == PTY_ref ? InferClassType(*regAssign.Opnd(0)) : TyIdx(0);
+      SetInferredType(regAssign.GetRegIdx(), rhsTyIdx);
+      return;
+    }
+    default:
+      break;
+  }
+  CallReturnVector *returnValues = stmt.GetCallReturnVector();
+  TyIdx retTyIdx(0);
+  if ((stmt.GetOpCode() == OP_intrinsiccallwithtype || stmt.GetOpCode() == OP_intrinsiccallwithtypeassigned) &&
+      static_cast<IntrinsiccallNode&>(stmt).GetIntrinsic() == INTRN_JAVA_CHECK_CAST) {
+    // past the cast, the operand and the result are instances of the target class or null
+    auto &callNode = static_cast<IntrinsiccallNode&>(stmt);
+    TyIdx castTyIdx = GetPointedTyIdx(GlobalTables::GetTypeTable().GetTypeFromTyIdx(callNode.GetTyIdx()));
+    retTyIdx = GetNarrowerType(InferClassType(*callNode.Opnd(0)), castTyIdx);
+    SetInferredType(*callNode.Opnd(0), retTyIdx);
+  }
+  if (returnValues == nullptr) {
+    return;
+  }
+  for (CallReturnPair &retPair : *returnValues) {
+    if (retPair.second.IsReg()) {
+      SetInferredType(retPair.second.GetPregIdx(), retTyIdx);
+    } else {
+      SetInferredType(retPair.first, retPair.second.GetFieldID() == 0 ? retTyIdx : TyIdx(0));
+    }
+  }
+}
+
+bool CheckCastGenerator::IsCastProvedSafe(const IntrinsiccallNode &callNode, Klass &checkKlass) const {
+  Klass *fromKlass = klassHierarchy->GetKlassFromTyIdx(InferClassType(*callNode.Opnd(0)));
+  return fromKlass != nullptr && IsSubtype(checkKlass, *fromKlass);
+}
+
 void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
   // Handle the special case like (Type)null, we don't need a checkcast.
   if (stmt.GetOpCode() == OP_intrinsiccallwithtypeassigned) {
@@ -88,6 +257,7 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
         assignReturnTypeNode = builder->CreateStmtRegassign(mirPreg->GetPrimType(), pregIdx, opnd);
       }
       currFunc->GetBody()->ReplaceStmt1WithStmt2(static_cast<StmtNode*>(&stmt), assignReturnTypeNode);
+      ++numCastsEliminated;
       return;
     }
   }
@@ -98,7 +268,15 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
   MIRType *checkType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(checkTyidx);
   Klass *checkKlass = klassHierarchy->GetKlassFromTyIdx(static_cast<MIRPtrType*>(checkType)->GetPointedTyIdx());
 
-  {
+  if (checkKlass != nullptr && IsCastProvedSafe(*callNode, *checkKlass)) {
+    // The operand is an instance of the class or null, nothing to check.
+    ++numCastsEliminated;
+    if (trace) {
+      LogInfo::MapleLogger() << "removed checkcast to " << checkKlass->GetKlassName() << " in "
+                             << currFunc->GetName() << '\n';
+    }
+  } else {
+    ++numCastsChecked;
     if (checkKlass != nullptr && strcmp("", checkKlass->GetKlassName().c_str())) {
       if (!strcmp(checkKlass->GetKlassName().c_str(), NameMangler::kJavaLangObjectStr)) {
         const size_t callNodeNopndSize1 = callNode->GetNopndSize();
@@ -252,6 +430,8 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
 
 void CheckCastGenerator::GenAllCheckCast() {
   auto &stmtNodes = currFunc->GetBody()->GetStmtNodes();
+  localTypes.clear();
+  pregTypes.clear();
   for (auto &stmt : stmtNodes) {
     if (stmt.GetOpCode() == OP_intrinsiccallwithtypeassigned || stmt.GetOpCode() == OP_intrinsiccallwithtype) {
       auto &callNode = static_cast<IntrinsiccallNode&>(stmt);
@@ -262,6 +442,8 @@ void CheckCastGenerator::GenAllCheckCast() {
         }
       }
     }
+    // the stmt is no longer in the body if it was a cast, but still describes what it did
+    UpdateInferredTypes(stmt);
   }
 }
 
@@ -279,7 +461,13 @@ void CheckCastGenerator::ProcessFunc(MIRFunction *func) {
     return;
   }
   SetCurrentFunction(*func);
+  numCastsEliminated = 0;
+  numCastsChecked = 0;
   GenAllCheckCast();
+  if (trace && (numCastsEliminated != 0 || numCastsChecked != 0)) {
+    LogInfo::MapleLogger() << "gencheckcast of " << func->GetName() << ": " << numCastsEliminated
+                           << " casts eliminated, " << numCastsChecked << " casts checked\n";
+  }
   MIRLower mirlowerer(GetMIRModule(), func);
   mirlowerer.LowerFunc(*func);
 }
@@ -15,6 +15,7 @@
 #include "vtable_analysis.h"
 #include "reflection_analysis.h"
 #include "itab_util.h"
+#include "option.h"
 
 // Vtableanalysis
 // This phase is mainly to generate the virtual table && iterface table.
@@ -23,6 +24,11 @@
 // and function address.And we also move the hot function to the front iterface
 // table.If the hash number is conflicted,we stored the whole completed methodname at the
 // end of interface table.
+// A virtual or interface call that can only reach one method is made a direct call to it,
+// after an explicit null check of the receiver, instead of going through the tables. That
+// is the case when the method is final, or the class of the receiver is final or a private
+// inner class without subclasses; with --closed-world, also when the class hierarchy of the
+// module holds a single implementation.
 
 namespace maple {
 VtableAnalysis::VtableAnalysis(MIRModule *mod, KlassHierarchy *kh, bool dump) : FuncOptimizeImpl(mod, kh, dump) {
@@ -356,11 +362,15 @@ void VtableAnalysis::ProcessFunc(MIRFunction *func) {
     next = stmt->GetNext();
     switch (stmt->GetOpCode()) {
       case OP_virtualcallassigned: {
-        ReplaceVirtualInvoke(*(static_cast<CallNode*>(stmt)));
+        if (!DevirtualizeInvoke(*(static_cast<CallNode*>(stmt)))) {
+          ReplaceVirtualInvoke(*(static_cast<CallNode*>(stmt)));
+        }
         break;
       }
       case OP_interfacecallassigned: {
-        ReplaceInterfaceInvoke(*(static_cast<CallNode*>(stmt)));
+        if (!DevirtualizeInvoke(*(static_cast<CallNode*>(stmt)))) {
+          ReplaceInterfaceInvoke(*(static_cast<CallNode*>(stmt)));
+        }
         break;
       }
       case OP_superclasscallassigned: {
@@ -378,6 +388,86 @@ void VtableAnalysis::ProcessFunc(MIRFunction *func) {
   }
 }
 
+// Return the method all the classes implementing interface resolve strIdx to, or nullptr
+// if they do not agree
+MIRFunction *VtableAnalysis::GetUniqueImplForInterface(const Klass &interface, GStrIdx strIdx) const {
+  MIRFunction *uniqueImpl = nullptr;
+  for (Klass *implKlass : interface.GetImplKlasses()) {
+    if (implKlass->GetMIRStructType()->IsIncomplete()) {
+      return nullptr;
+    }
+    MIRFunction *impl = implKlass->GetClosestMethod(strIdx);
+    if (impl == nullptr) {
+      return nullptr;
+    }
+    // an abstract class has no instances of its own; its subclasses are implementations too
+    if (impl->IsAbstract()) {
+      continue;
+    }
+    if (uniqueImpl != nullptr && uniqueImpl != impl) {
+      return nullptr;
+    }
+    uniqueImpl = impl;
+  }
+  return uniqueImpl;
+}
+
+// Return the only method a virtual or interface call to callee can invoke, or nullptr if
+// receivers of different classes may invoke different methods
+MIRFunction *VtableAnalysis::GetDevirtualizedTarget(const MIRFunction &callee) const {
+  Klass *klass = klassHierarchy->GetKlassFromFunc(&callee);
+  if (klass == nullptr) {
+    return nullptr;
+  }
+  GStrIdx strIdx = callee.GetBaseFuncNameWithTypeStrIdx();
+  if (klass->IsInterface()) {
+    return Options::closedWorld ? GetUniqueImplForInterface(*klass, strIdx) : nullptr;
+  }
+  MIRFunction *target = klass->GetClosestMethod(strIdx);
+  if (target == nullptr && klass->GetMethod(strIdx) == &callee) {
+    target = const_cast<MIRFunction*>(&callee);
+  }
+  if (target != nullptr && !target->IsAbstract() &&
+      (target->IsFinal() || klass->GetMIRClassType()->IsFinal() || klass->IsPrivateInnerAndNoSubClass())) {
+    return target;
+  }
+  if (!Options::closedWorld) {
+    return nullptr;
+  }
+  target = klass->GetUniqueMethod(strIdx);
+  return (target != nullptr && !target->IsAbstract()) ? target : nullptr;
+}
+
+// Turn the virtual or interface call stmt into a direct call if it has a single target.
+// Return false if it is left alone.
+bool VtableAnalysis::DevirtualizeInvoke(CallNode &stmt) {
+  MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(stmt.GetPUIdx());
+  ASSERT(callee != nullptr, "null ptr check!");
+  if (stmt.GetNopnd().empty()) {
+    return false;
+  }
+  // the table load no longer throws the NullPointerException for a null receiver, so it is
+  // checked explicitly; the receiver is read twice, so it has to be a plain variable
+  BaseNode *receiver = stmt.GetNopndAt(0);
+  if (receiver->GetOpCode() != OP_dread && receiver->GetOpCode() != OP_regread) {
+    return false;
+  }
+  MIRFunction *target = GetDevirtualizedTarget(*callee);
+  if (target == nullptr) {
+    return false;
+  }
+  UnaryStmtNode *nullCheck =
+      builder->CreateStmtUnary(OP_assertnonnull, receiver->CloneTree(*builder->GetCurrentFuncCodeMpAllocator()));
+  currFunc->GetBody()->InsertBefore(&stmt, nullCheck);
+  if (trace) {
+    LogInfo::MapleLogger() << "devirtualized " << callee->GetName() << " to " << target->GetName() << " in "
+                           << currFunc->GetName() << '\n';
+  }
+  stmt.SetOpCode(OP_callassigned);
+  stmt.SetPUIdx(target->GetPuidx());
+  return true;
+}
+
 void VtableAnalysis::ReplaceSuperclassInvoke(CallNode &stmt) {
   // Because the virtual method may be inherited from its parent, we need to find
   // the actual method target.